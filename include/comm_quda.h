@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <quda_constants.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -8,15 +9,72 @@ extern "C" {
   typedef struct MsgHandle_s MsgHandle;
   typedef struct Topology_s Topology;
 
+  /**
+     Instrumentation carried by every persistent message handle.  The
+     counters are only updated when QUDA_ENABLE_COMM_STATS=1.
+   */
+  typedef struct CommMsgStats_s {
+    int dim;               // dimension of the message (-1 if declared by displacement)
+    int dir;               // direction of the message (0 - backwards, 1 - forwards)
+    int send;              // whether this is a send (1) or receive (0) handle
+    size_t bytes;          // size of each message in bytes
+    uint64_t messages;     // number of messages started
+    uint64_t polls;        // number of comm_query calls
+    double start_time;     // time the last message was started
+    double complete_time;  // time the last message was seen to complete
+    double flight_time;    // total time from start until completion was seen
+    double wait_time;      // total time spent blocked in comm_wait
+    int in_flight;         // whether a started message has not yet been seen to complete
+  } CommMsgStats;
+
   /* defined in quda.h; redefining here to avoid circular references */ 
   typedef int (*QudaCommsMap)(const int *coords, void *fdata);
 
+  /**
+     Data for comm_node_rank_from_coords().  The caller sets ndim,
+     dims and X and initializes ranks to NULL; the mapping itself is
+     built on first use and must be released with comm_node_map_free().
+   */
+  typedef struct CommNodeMap_s {
+    int ndim;                // number of grid dimensions
+    int dims[QUDA_MAX_DIM];  // process grid dimensions
+    int X[QUDA_MAX_DIM];     // global lattice dimensions (0 if unknown)
+    int block[QUDA_MAX_DIM]; // shape of the per-node sub-block of the grid
+    int *ranks;              // rank at each grid coordinate (lexicographic, last index fastest)
+  } CommNodeMap;
+
   /* implemented in comm_common.cpp */
 
   char *comm_hostname(void);
   double comm_drand(void);
   Topology *comm_create_topology(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data);
   void comm_destroy_topology(Topology *topo);
+
+  /**
+     Node-aware mapping from grid coordinates to ranks.  The ranks
+     that share a host are placed in a compact sub-block of the
+     process grid, with the block shape chosen to minimize the halo
+     surface between nodes for the local lattice extents X/dims
+     (equal extents are assumed if X is unknown).  Nodes are ordered
+     lexicographically on the grid of blocks, and ranks within a
+     block lexicographically by rank number.  If the nodes hold
+     different numbers of ranks, or no block shape tiles the grid,
+     the lexicographic mapping is used instead.
+
+     The first call gathers the hostnames of all ranks, so it is
+     collective and must be made by every rank, which is the case
+     when it is passed to comm_init().
+     @param coords Grid coordinates
+     @param fdata Pointer to a CommNodeMap
+     @return Rank at the given coordinates
+   */
+  int comm_node_rank_from_coords(const int *coords, void *fdata);
+
+  /**
+     Release the mapping built by comm_node_rank_from_coords()
+     @param map The node map
+   */
+  void comm_node_map_free(CommNodeMap *map);
   int comm_ndim(const Topology *topo);
   const int *comm_dims(const Topology *topo);
   const int *comm_coords(const Topology *topo);
@@ -110,6 +168,77 @@ extern "C" {
 #define comm_declare_strided_receive_relative(buffer, dim, dir, blksize, nblocks, stride) \
   comm_declare_strided_receive_relative_(__func__, __FILE__, __LINE__, buffer, dim, dir, blksize, nblocks, stride)
 
+  /**
+     @return Whether per-message instrumentation is enabled
+     (QUDA_ENABLE_COMM_STATS=1)
+   */
+  bool comm_stats_enabled(void);
+
+  /**
+     @return Wall-clock time in seconds, used for all comms timestamps
+   */
+  double comm_wtime(void);
+
+  /**
+     @return comm_wtime() if instrumentation is enabled, else zero.
+     Backends call this before blocking in comm_wait.
+   */
+  double comm_stats_clock(void);
+
+  /**
+     Zero the counters of a newly allocated handle and mark it as
+     unlabelled (dim = -1).  Called by the backends from every
+     displaced declaration, so that handles declared directly by
+     displacement start from a clean state.
+     @param stats Counters of the handle (may be NULL)
+   */
+  void comm_stats_clear(CommMsgStats *stats);
+
+  /**
+     Label the counters of a newly declared handle and add them to the
+     set reported by comm_stats_report.  Called by the relative
+     declaration routines.
+     @param mh Handle returned by the backend
+     @param dim Dimension of the message
+     @param dir Direction of the message
+     @param send Whether this is a send handle
+     @param bytes Size of each message in bytes
+     @return mh
+   */
+  MsgHandle *comm_stats_declare(MsgHandle *mh, int dim, int dir, int send, size_t bytes);
+
+  /**
+     Counter updates, called by the backends from comm_start,
+     comm_wait, comm_query and comm_free respectively.  All accept a
+     NULL stats pointer.
+   */
+  void comm_stats_start(CommMsgStats *stats);
+  void comm_stats_wait(CommMsgStats *stats, double wait_start);
+  void comm_stats_query(CommMsgStats *stats, int complete);
+  void comm_stats_free(CommMsgStats *stats);
+
+  /**
+     Reset the window tracked by comm_stats_window
+   */
+  void comm_stats_window_reset(void);
+
+  /**
+     Return the interval spanned by the messages started since the
+     last call to comm_stats_window_reset, from the first start to the
+     last observed completion.
+     @param[out] first_start Time the first message was started
+     @param[out] last_complete Time the last message was seen to complete
+     @return Whether any message has completed in the window
+   */
+  bool comm_stats_window(double *first_start, double *last_complete);
+
+  /**
+     Print the per-dimension and per-direction message summary,
+     aggregated over all handles (live and freed) and all ranks.  This
+     is collective.
+   */
+  void comm_stats_report(void);
+
   void comm_finalize(void);
   void comm_dim_partitioned_set(int dim);
   int comm_dim_partitioned(int dim);
@@ -139,6 +268,12 @@ extern "C" {
   int comm_size(void);
   int comm_gpuid(void);
 
+  /**
+     @return The instrumentation counters of a message handle (NULL
+     for the single-GPU backend)
+   */
+  CommMsgStats *comm_msg_stats(MsgHandle *mh);
+
   /**
      @brief Gather all hostnames
      @param[out] hostname_recv_buf char array of length
@@ -255,6 +390,24 @@ extern "C" {
   void comm_allreduce(double* data);
   void comm_allreduce_max(double* data);
   void comm_allreduce_array(double* data, size_t size);
+
+  /**
+     Start a non-blocking in-place sum reduction of an array of
+     doubles.  The contents of data are undefined until the returned
+     handle has been passed to comm_wait_reduction, and data must stay
+     alive until then.
+     @param data Array to be reduced in place
+     @param size Number of elements
+     @return Handle to be passed to comm_wait_reduction
+  */
+  MsgHandle *comm_iallreduce_array(double* data, size_t size);
+
+  /**
+     Complete a reduction started with comm_iallreduce_array and free
+     its handle.
+     @param mh Handle returned by comm_iallreduce_array
+  */
+  void comm_wait_reduction(MsgHandle *mh);
   void comm_allreduce_int(int* data);
   void comm_allreduce_xor(uint64_t *data);
   void comm_broadcast(void *data, size_t nbytes);
@@ -264,6 +417,14 @@ extern "C" {
   void reduceMaxDouble(double &);
   void reduceDouble(double &);
   void reduceDoubleArray(double *, const int len);
+
+  /**
+     Non-blocking counterpart of reduceDoubleArray: starts the global
+     reduction (if global reductions are enabled) and returns the
+     handle to wait on with reduceDoubleArrayWait.
+   */
+  MsgHandle *reduceDoubleArrayAsync(double *, const int len);
+  void reduceDoubleArrayWait(MsgHandle *);
   int commDim(int);
   int commCoords(int);
   int commDimPartitioned(int dir);
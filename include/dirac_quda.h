@@ -9,6 +9,7 @@
 #include <blas_quda.h>
 
 #include <typeinfo>
+#include <vector>
 
 namespace quda {
 
@@ -755,7 +756,9 @@ namespace quda {
     cudaGaugeField *Xinv_d; /** GPU copy of inverse coarse clover term */
     cudaGaugeField *Yhat_d; /** GPU copy of the preconditioned coarse link field */
 
-    void initializeCoarse();  /** Initialize the coarse gauge field */
+    void initializeCoarse(bool compute);  /** Initialize the coarse gauge field */
+
+    void computeCoarse();  /** Compute the coarse gauge field from the parent operator and transfer operator */
 
     bool enable_gpu; /** Whether to enable this operator for the GPU */
     bool init; /** Whether this instance did the allocation or not */
@@ -767,8 +770,11 @@ namespace quda {
     /**
        @param[in] param Parameters defining this operator
        @param[in] enable_gpu Whether to enable this operator for the GPU
+       @param[in] compute Whether to compute the coarse fields, else
+       they are allocated but must be filled through HostFields() and
+       uploadCoarse() (e.g., when restoring from a checkpoint)
      */
-    DiracCoarse(const DiracParam &param, bool enable_gpu=true);
+    DiracCoarse(const DiracParam &param, bool enable_gpu=true, bool compute=true);
 
     /**
        @param[in] param Parameters defining this operator
@@ -792,6 +798,27 @@ namespace quda {
     DiracCoarse(const DiracCoarse &dirac, const DiracParam &param);
     virtual ~DiracCoarse();
 
+    /**
+       @brief Recompute the coarse link and clover fields in place,
+       e.g., after the parent operator's gauge field or the transfer
+       operator has changed.  Operators cloned from this one share
+       the fields and so pick up the update.
+       @param[in] dirac The parent Dirac operator to coarsen
+     */
+    void updateCoarse(const Dirac &dirac);
+
+    /**
+       @brief Host copies of the coarse fields, in the order Y, X,
+       Xinv, Yhat.  These are kept in sync with the GPU copies.
+     */
+    std::vector<cpuGaugeField*> HostFields() const { return {Y_h, X_h, Xinv_h, Yhat_h}; }
+
+    /**
+       @brief Copy the host coarse fields to the GPU, after they have
+       been filled directly through HostFields()
+     */
+    void uploadCoarse();
+
     /**
        @brief Apply the coarse clover operator
        @param[out] out Output field
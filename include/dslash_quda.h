@@ -29,6 +29,23 @@ namespace quda {
   void createDslashEvents();
   void destroyDslashEvents();
 
+  /**
+     @brief Accumulate the halo-exchange overlap of one dslash policy
+     application (only used when QUDA_ENABLE_COMM_STATS=1)
+     @param[in] policy Name of the dslash policy
+     @param[in] window Time from the first halo message start to the
+     last halo message completion
+     @param[in] exposed Part of the window after the interior kernel
+     had completed
+   */
+  void recordDslashOverlap(const char *policy, double window, double exposed);
+
+  /**
+     @brief Print the achieved overlap per dslash policy, averaged
+     over all ranks.  This is collective.
+   */
+  void printDslashOverlap();
+
 
   // plain Wilson Dslash  
   void wilsonDslashCuda(cudaColorSpinorField *out, const cudaGaugeField &gauge, const cudaColorSpinorField *in,
@@ -117,6 +117,9 @@ extern "C" {
     QUDA_BICGSTABL_INVERTER,
     QUDA_CGNE_INVERTER,
     QUDA_CGNR_INVERTER,
+    QUDA_PIPELINED_CG_INVERTER,
+    QUDA_CA_CG_INVERTER,
+    QUDA_CA_BICGSTAB_INVERTER,
     QUDA_INVALID_INVERTER = QUDA_INVALID_ENUM
   } QudaInverterType;
 
@@ -156,6 +159,13 @@ extern "C" {
     QUDA_MG_CYCLE_INVALID = QUDA_INVALID_ENUM
   } QudaMultigridCycleType;
 
+  typedef enum QudaCABasis_s {
+    QUDA_POWER_BASIS,
+    QUDA_NEWTON_BASIS,
+    QUDA_CHEBYSHEV_BASIS,
+    QUDA_INVALID_BASIS = QUDA_INVALID_ENUM
+  } QudaCABasis;
+
   typedef enum QudaSchwarzType_s {
     QUDA_ADDITIVE_SCHWARZ,
     QUDA_MULTIPLICATIVE_SCHWARZ,
@@ -115,6 +115,9 @@
 #define QUDA_BICGSTABL_INVERTER 16
 #define QUDA_CGNE_INVERTER 17 
 #define QUDA_CGNR_INVERTER 18
+#define QUDA_PIPELINED_CG_INVERTER 19
+#define QUDA_CA_CG_INVERTER 20
+#define QUDA_CA_BICGSTAB_INVERTER 21
 #define QUDA_INVALID_INVERTER QUDA_INVALID_ENUM
 
 #define QudaEigType integer(4)
@@ -149,6 +152,12 @@
 #define QUDA_MG_CYCLE_RECURSIVE 3
 #define QUDA_MG_CYCLE_INVALID QUDA_INVALID_ENUM
 
+#define QudaCABasis integer(4)
+#define QUDA_POWER_BASIS 0
+#define QUDA_NEWTON_BASIS 1
+#define QUDA_CHEBYSHEV_BASIS 2
+#define QUDA_INVALID_BASIS QUDA_INVALID_ENUM
+
 #define QudaSchwarzType integer(4)
 #define QUDA_ADDITIVE_SCHWARZ 0 
 #define QUDA_MULTIPLICATIVE_SCHWARZ 1
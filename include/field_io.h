@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <color_spinor_field.h>
+#include <gauge_field.h>
+
+/**
+   Native parallel binary I/O for host gauge and color-spinor fields.
+
+   A file consists of a FieldFileHeader, a table holding a checksum for
+   each rank's data, and then the data itself, one contiguous block per
+   rank ordered by the rank's (lexicographic) position in the process
+   grid.  Each rank reads and writes only its own block with
+   pread/pwrite on the shared file, so no data is gathered to a single
+   node and no QIO or QMP layer is required (this works with any comms
+   backend, including comm_single).
+
+   Within a block the data are stored vector by vector (for
+   color-spinor fields) or direction by direction (for gauge fields),
+   each in the site order of the host field with the internal degrees
+   of freedom (spin, color, real/imaginary) running fastest.  The file
+   precision may differ from the field precision, in which case the
+   conversion is done in bulk when the block is staged.  Data are
+   stored in native byte order.
+
+   A file must be read with the same process grid and local volume
+   that it was written with.
+ */
+
+namespace quda {
+
+  /**
+     @brief Whether the given file is a native QUDA field file.  May be
+     called on any subset of the ranks.
+     @param[in] filename Name of the file to test
+     @return True if the file exists and starts with the native magic
+   */
+  bool isFieldFile(const char *filename);
+
+  /**
+     @brief Write a set of host color-spinor fields (e.g., the
+     null-space vectors) to a single file.  This is a collective
+     operation.
+     @param[in] filename Name of the file to write
+     @param[in] V The fields to write: these must all share the same
+     geometry, precision and field order (QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+     @param[in] file_prec Precision to store the fields with
+     (QUDA_INVALID_PRECISION means that of the fields)
+     @param[in] async If true the fields are staged and the actual write
+     is done by a background thread, so the fields may be modified or
+     freed as soon as this returns; completion is guaranteed after
+     fieldIOSync()
+   */
+  void saveColorSpinorFields(const char *filename, const std::vector<ColorSpinorField*> &V,
+			     QudaPrecision file_prec=QUDA_INVALID_PRECISION, bool async=false);
+
+  /**
+     @brief Read a set of host color-spinor fields written with
+     saveColorSpinorFields, converting to the precision of the fields
+     if needed.  This is a collective operation.
+     @param[in] filename Name of the file to read
+     @param[out] V The fields to fill in: their number and geometry must
+     match the file
+   */
+  void loadColorSpinorFields(const char *filename, std::vector<ColorSpinorField*> &V);
+
+  /**
+     @brief Write a host gauge field to file.  Only fields stored
+     without reconstruction and without an extended halo in QDP or
+     MILC order are supported.  This is a collective operation.
+     @param[in] filename Name of the file to write
+     @param[in] u The gauge field to write
+     @param[in] file_prec Precision to store the field with
+     (QUDA_INVALID_PRECISION means that of the field)
+     @param[in] async If true the write is done by a background thread
+     (see saveColorSpinorFields)
+   */
+  void saveGaugeField(const char *filename, const GaugeField &u,
+		      QudaPrecision file_prec=QUDA_INVALID_PRECISION, bool async=false);
+
+  /**
+     @brief Read a host gauge field written with saveGaugeField,
+     converting to the precision of the field if needed.  This is a
+     collective operation.
+     @param[in] filename Name of the file to read
+     @param[out] u The gauge field to fill in
+   */
+  void loadGaugeField(const char *filename, GaugeField &u);
+
+  /**
+     @brief Wait for all outstanding asynchronous writes issued by this
+     rank and then synchronize with the other ranks, so that all files
+     written are complete.  This is a collective operation.
+   */
+  void fieldIOSync();
+
+} // namespace quda
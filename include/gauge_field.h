@@ -120,6 +120,17 @@ namespace quda {
 
   std::ostream& operator<<(std::ostream& output, const GaugeFieldParam& param);
 
+  /**
+     Sink for a checksum that is computed on the fly while a gauge
+     field is being copied (see GaugeField::streamChecksum).
+  */
+  struct GaugeChecksumStream {
+    uint64_t partial[2*QUDA_MAX_GEOMETRY]; // local XOR checksum of each (parity, dimension), dimension fastest
+    bool complete; // whether a copy has streamed the checksum over the whole local field
+
+    GaugeChecksumStream() : complete(false) { for (int i=0; i<2*QUDA_MAX_GEOMETRY; i++) partial[i] = 0; }
+  };
+
   class GaugeField : public LatticeField {
 
   protected:
@@ -183,6 +194,11 @@ namespace quda {
     */
     size_t site_size;
 
+    /**
+       Where host-side copies from this field stream the checksum to (if set)
+    */
+    GaugeChecksumStream *checksum_stream;
+
     /**
        Compute the required extended ghost zone sizes and offsets
        @param[in] R Radius of the ghost zone
@@ -293,6 +309,39 @@ namespace quda {
        @return checksum value
      */
     uint64_t checksum(bool mini=false) const;
+
+    /**
+       Compute checksum of this gauge field together with the
+       checksum of each parity and dimension, so that a mismatch can
+       be localized to a subset of the field.
+       @param[out] partial Array of length 2*Geometry() of checksums,
+       indexed as parity*Geometry() + dimension
+       @param[in] mini Whether to compute a mini checksum or global checksum.
+       @return checksum value
+     */
+    uint64_t checksum(uint64_t *partial, bool mini=false) const;
+
+    /**
+       Request that subsequent host-side copies from this field
+       (copyGenericGauge with QUDA_CPU_FIELD_LOCATION) fold the
+       checksum of the links they read into stream, avoiding a separate
+       pass over the field.  The checksum is only streamed by body
+       copies from non-native fields without reconstruction, so
+       stream.complete must be checked before use, falling back to
+       checksum() otherwise.  The result is local to this process; use
+       reduceChecksum to obtain the global checksum.
+       @param[in,out] stream Checksum sink (reset here), or nullptr to
+       stop streaming
+    */
+    void streamChecksum(GaugeChecksumStream *stream) {
+      if (stream) *stream = GaugeChecksumStream();
+      checksum_stream = stream;
+    }
+
+    /**
+       @return The checksum sink set with streamChecksum (nullptr if none)
+    */
+    GaugeChecksumStream* ChecksumStream() const { return checksum_stream; }
   };
 
   class cudaGaugeField : public GaugeField {
@@ -643,6 +692,28 @@ namespace quda {
   */
   uint64_t Checksum(const GaugeField &u, bool mini=false);
 
+  /**
+     Compute XOR-based checksum of this gauge field as above, together
+     with the checksum of each parity and dimension.
+     @param[in] u The gauge field we are computing the checksum of
+     @param[out] partial Array of length 2*u.Geometry() of checksums,
+     indexed as parity*u.Geometry() + dimension
+     @param[in] mini Whether to compute a mini checksum or global checksum.
+     @return checksum value
+  */
+  uint64_t Checksum(const GaugeField &u, uint64_t *partial, bool mini=false);
+
+  /**
+     Reduce a checksum streamed during a copy (see
+     GaugeField::streamChecksum) over all processes.
+     @param[in] stream The streamed checksum (must be complete)
+     @param[out] partial Array of length 2*geometry of checksums,
+     indexed as parity*geometry + dimension (optional)
+     @param[in] geometry The geometry of the field that was copied
+     @return checksum value
+  */
+  uint64_t reduceChecksum(const GaugeChecksumStream &stream, uint64_t *partial, int geometry);
+
 } // namespace quda
 
 #endif // _GAUGE_QUDA_H
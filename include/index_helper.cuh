@@ -274,4 +274,35 @@ namespace quda {
     return index;
   }
 
+  /**
+     Compute the index of the nearest neighbor of a site in dimension
+     d for a 4-d stencil with unit hop.  When table is true the index
+     is read from the precomputed neighbor table arg.nbr (see
+     StencilIndex), which is what the host kernels use, else it is
+     computed from the site coordinates x[].
+
+     @return Checkerboard index of the neighbor in the local field,
+     or the ghost-face index if the neighbor is in the ghost zone
+     @param ghost Whether the neighbor is in the ghost zone
+     @param x Site coordinates (unused when table is true)
+     @param arg Kernel argument (dim, commDim, nFace, volumeCB and nbr)
+     @param d Dimension
+     @param x_cb Checkerboard site index
+     @param parity Site parity
+   */
+  template <int dir, bool table, typename Arg>
+  __device__ __host__ inline int stencilNeighbor(bool &ghost, const int x[], const Arg &arg, int d, int x_cb, int parity) {
+    if (table) {
+      const int nbr = arg.nbr[(parity*8 + 2*d + (1-dir))*arg.volumeCB + x_cb];
+      ghost = nbr < 0;
+      return ghost ? -nbr - 1 : nbr;
+    } else if (dir == 1) {
+      ghost = arg.commDim[d] && (x[d] + arg.nFace >= arg.dim[d]);
+      return ghost ? ghostFaceIndex<1>(x, arg.dim, d, arg.nFace) : linkIndexP1(x, arg.dim, d);
+    } else {
+      ghost = arg.commDim[d] && (x[d] - arg.nFace < 0);
+      return ghost ? ghostFaceIndex<0>(x, arg.dim, d, arg.nFace) : linkIndexM1(x, arg.dim, d);
+    }
+  }
+
 } // namespace quda
@@ -154,6 +154,13 @@ namespace quda {
     /** Number of steps in s-step algorithms */
     int Nsteps;
 
+    /** Polynomial basis used by the communication-avoiding s-step solvers */
+    QudaCABasis ca_basis;
+
+    /** Spectral interval used to build the Newton and Chebyshev bases */
+    double ca_lambda_min;
+    double ca_lambda_max;
+
     /** Maximum size of Krylov space used by solver */
     int Nkrylov;
 
@@ -228,7 +235,8 @@ namespace quda {
       precision(param.cuda_prec), precision_sloppy(param.cuda_prec_sloppy),
       precision_precondition(param.cuda_prec_precondition),
       preserve_source(param.preserve_source), num_src(param.num_src), num_offset(param.num_offset),
-      Nsteps(param.Nsteps), Nkrylov(param.gcrNkrylov), precondition_cycle(param.precondition_cycle),
+      Nsteps(param.Nsteps), ca_basis(param.ca_basis), ca_lambda_min(param.ca_lambda_min),
+      ca_lambda_max(param.ca_lambda_max), Nkrylov(param.gcrNkrylov), precondition_cycle(param.precondition_cycle),
       tol_precondition(param.tol_precondition), maxiter_precondition(param.maxiter_precondition),
       omega(param.omega), schwarz_type(param.schwarz_type), secs(param.secs), gflops(param.gflops),
       precision_ritz(param.cuda_prec_ritz), nev(param.nev), m(param.max_search_dim),
@@ -262,7 +270,8 @@ namespace quda {
       precision(param.precision), precision_sloppy(param.precision_sloppy),
       precision_precondition(param.precision_precondition),
       preserve_source(param.preserve_source), num_offset(param.num_offset),
-      Nsteps(param.Nsteps), Nkrylov(param.Nkrylov), precondition_cycle(param.precondition_cycle),
+      Nsteps(param.Nsteps), ca_basis(param.ca_basis), ca_lambda_min(param.ca_lambda_min),
+      ca_lambda_max(param.ca_lambda_max), Nkrylov(param.Nkrylov), precondition_cycle(param.precondition_cycle),
       tol_precondition(param.tol_precondition), maxiter_precondition(param.maxiter_precondition),
       omega(param.omega), schwarz_type(param.schwarz_type), secs(param.secs), gflops(param.gflops),
       precision_ritz(param.precision_ritz), nev(param.nev), m(param.m),
@@ -449,6 +458,81 @@ namespace quda {
 
 
 
+  /**
+     @brief Pipelined conjugate gradient (Ghysels and Vanroose,
+     Parallel Computing 40, 224 (2014)).  The two inner products of
+     each iteration are fused into a single global reduction that is
+     started before, and completed after, the matrix-vector product,
+     hiding the reduction latency at the cost of three extra vector
+     recurrences.  Reliable updates replace the recursively updated
+     residual (and the auxiliary vectors derived from it) with the
+     true residual computed in high precision.
+   */
+  class PipelinedCG : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+    // pointers to fields to avoid multiple creation overhead
+    ColorSpinorField *yp, *rp, *pp, *sp, *wp, *zp, *qp, *tmpp;
+    bool init;
+
+  public:
+    PipelinedCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~PipelinedCG();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+  };
+
+  /**
+     @brief Communication-avoiding (s-step) CG.  Each outer iteration
+     builds an s-step Krylov basis from the current search direction
+     and residual, computes its Gram matrix with a single batched
+     reduction and then performs s CG iterations on the basis
+     coordinates with no further global communication.  The basis is
+     set by param.ca_basis (monomial, Newton or Chebyshev) and
+     residual replacement is done with the usual reliable-update
+     criteria between outer iterations.
+   */
+  class CACG : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+    // pointers to fields to avoid multiple creation overhead
+    ColorSpinorField *yp, *rp, *pp, *tmpp;
+    std::vector<ColorSpinorField*> V; // the s-step basis
+    bool init;
+
+  public:
+    CACG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~CACG();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+  };
+
+  /**
+     @brief Communication-avoiding (s-step) BiCGstab.  The structure
+     follows CACG, with a basis of dimension 4s+1 and the shadow
+     residual included in the batched Gram-matrix reduction.
+   */
+  class CABiCGstab : public Solver {
+
+  private:
+    const DiracMatrix &mat;
+    const DiracMatrix &matSloppy;
+    // pointers to fields to avoid multiple creation overhead
+    ColorSpinorField *yp, *rp, *pp, *r0p, *tmpp;
+    std::vector<ColorSpinorField*> V; // the s-step basis
+    bool init;
+
+  public:
+    CABiCGstab(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+    virtual ~CABiCGstab();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+  };
+
   class MPCG : public Solver {
     private:
       const DiracMatrix &mat;
@@ -803,6 +887,22 @@ namespace quda {
     void operator()(ColorSpinorField &x, ColorSpinorField &b,
 		    std::vector<ColorSpinorField*> p,
 		    std::vector<ColorSpinorField*> q);
+
+    /**
+       Variant for a basis that may be stored in a lower precision
+       than x, where only the basis itself is kept resident.  The
+       projected system (p_i, A p_j), (p_i, b) is accumulated one
+       basis vector at a time using a single pair of work vectors, and
+       solved on the host.  The basis is not orthogonalized, so the
+       orthogonal and apply_mat flags are ignored.
+       @param x The optimum for the solution vector.
+       @param b The source vector in the equation to be solved. This is preserved.
+       @param basis The basis vectors in which we are building the guess
+       @param p Work vector with the precision of x
+       @param q Work vector with the precision of x
+    */
+    void operator()(ColorSpinorField &x, ColorSpinorField &b, const std::vector<ColorSpinorField*> &basis,
+		    ColorSpinorField &p, ColorSpinorField &q);
   };
 
   using ColorSpinorFieldSet = ColorSpinorField;
@@ -70,16 +70,51 @@ namespace quda {
                     cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m);
   };
     
-#if 0
   /**
-     Not implemented yet!!!, Implicitely restarted Lanczos algoritm can rapidly approach the solution than normal Lanczos, Chebychev acceleration and implicite restart processes are needed. At this moment external program call can do this.
+     Restarted Lanczos, implemented as thick-restart Lanczos (K. Wu
+     and H. Simon, SIAM J. Matrix Anal. Appl. 22, 602 (2000)), which
+     is equivalent to implicit restarting with exact shifts.  Ritz
+     pairs that have converged are locked.  New Lanczos vectors are
+     orthogonalized against the locked and kept Ritz vectors at every
+     step, and against the rest of the basis only when the estimated
+     loss of orthogonality (Simon's omega recurrence) requires it.  When
+     the RitzMat has a Chebyshev polynomial (NPoly > 1) the largest
+     eigenvalues of the polynomial are sought, otherwise the smallest
+     eigenvalues of the operator.
+
+     The search space is of size m; eigParam.nk eigenpairs are
+     computed to a relative residual of eigParam.Stp_residual, with
+     at most eigParam.max_restarts restarts.  On return the first nk
+     Eig_Vec hold the eigenvectors in order of increasing eigenvalue
+     of the underlying operator, with alpha the eigenvalues and beta
+     the residual norms |A v - alpha v|.  r is used as the starting
+     vector, Apsi as a temporary and k0 is ignored.
   */
-
   class ImpRstLanczos : public Eig_Solver {
 
   private:
     const RitzMat &ritz_mat;
 
+    /** Work space for the basis rotations, reused across restarts and calls */
+    std::vector<ColorSpinorField*> rotation_work;
+
+    /**
+       @brief Rotate the basis: V[offset+t] = sum_i V[offset+i] Y(i,t)
+       for t < n_out, using the block caxpy
+       @param V The basis
+       @param offset First basis vector taking part in the rotation
+       @param n_in Number of basis vectors to rotate
+       @param Y Column-major n_in x n_out rotation matrix
+       @param n_out Number of rotated vectors
+    */
+    void rotate(cudaColorSpinorField **V, int offset, int n_in, const double *Y, int n_out);
+
+    /**
+       @brief Orthogonalize r against V[begin..end) with a single block
+       inner product and block caxpy
+    */
+    void orthogonalize(cudaColorSpinorField &r, cudaColorSpinorField **V, int begin, int end);
+
   public:
     ImpRstLanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile);
     virtual ~ImpRstLanczos();
@@ -87,7 +122,6 @@ namespace quda {
     void operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec, 
                     cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m);
   };
-#endif
 
 } // namespace quda
 
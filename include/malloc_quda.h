@@ -96,6 +96,22 @@ namespace quda {
     */
     void pinned_free_(const char *func, const char *file, int line, void *ptr);
 
+    /**
+       @brief Allocate host-memory (safe_malloc) through the pool.  If
+       a free pre-existing allocation exists reuse this.  This is
+       intended for host scratch space that is allocated and freed
+       repeatedly, e.g., by threaded host kernels.
+       @param size Size of allocation
+       @return Pointer to allocated memory
+    */
+    void *host_malloc_(const char *func, const char *file, int line, size_t size);
+
+    /**
+       @brief Virtual free of host-memory allocation.
+       @param ptr Pointer to be (virtually) freed
+    */
+    void host_free_(const char *func, const char *file, int line, void *ptr);
+
     /**
        @brief Free all outstanding device-memory allocations.
     */
@@ -106,6 +122,11 @@ namespace quda {
     */
     void flush_pinned();
 
+    /**
+       @brief Free all outstanding host-memory allocations.
+    */
+    void flush_host();
+
   } // namespace pool
 
 }
@@ -114,6 +135,8 @@ namespace quda {
 #define pool_device_free(ptr) quda::pool::device_free_(__func__, __FILE__, __LINE__, ptr)
 #define pool_pinned_malloc(size) quda::pool::pinned_malloc_(__func__, __FILE__, __LINE__, size)
 #define pool_pinned_free(ptr) quda::pool::pinned_free_(__func__, __FILE__, __LINE__, ptr)
+#define pool_host_malloc(size) quda::pool::host_malloc_(__func__, __FILE__, __LINE__, size)
+#define pool_host_free(ptr) quda::pool::host_free_(__func__, __FILE__, __LINE__, ptr)
 
 
 #endif // _MALLOC_QUDA_H
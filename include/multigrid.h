@@ -286,6 +286,18 @@ namespace quda {
      */
     void reset();
 
+    /**
+       @brief Refresh this and all coarser levels after the fine-grid
+       operator has changed by a small amount (e.g., a gauge update
+       in HMC).  The existing null-space vectors are optionally
+       relaxed against the new operator (setup_refresh_iter) and
+       re-orthonormalized, after which the prolongators and the coarse
+       operators are rebuilt from them.  This is much cheaper than
+       tearing down and regenerating the whole hierarchy.  The
+       smoothers on the fine level are not recreated here.
+     */
+    void refresh();
+
     /**
        This method verifies the correctness of the MG method.  It checks:
        1. Null-space vectors are exactly preserved: v_k = P R v_k
@@ -313,11 +325,29 @@ namespace quda {
     */
     void saveVectors(std::vector<ColorSpinorField*> &B);
 
+    /**
+       @brief Write this level of the hierarchy (null-space vectors,
+       prolongator, site map and coarse operator) to this rank's
+       checkpoint file for the level
+    */
+    void saveCheckpoint();
+
+    /**
+       @brief Restore this level of the hierarchy from this rank's
+       checkpoint file for the level, validating the stored
+       parameters and checksums.  The transfer and coarse operators
+       must have been created without computing their contents.
+    */
+    void loadCheckpoint();
+
     /**
        @brief Generate the null-space vectors
        @param B Generated null-space vectors
+       @param refresh Whether to relax the existing contents of B
+       (for setup_refresh_iter iterations) instead of starting from
+       random vectors
      */
-    void generateNullVectors(std::vector<ColorSpinorField*> B);
+    void generateNullVectors(std::vector<ColorSpinorField*> B, bool refresh=false);
 
     /**
        @brief Return the total flops done on this and all coarser levels.
@@ -395,6 +425,9 @@ namespace quda {
     MG *mg;
     TimeProfile &profile;
 
+    /** Time taken to build the hierarchy, for comparison with later refreshes */
+    double setup_secs;
+
     multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &profile);
 
     virtual ~multigrid_solver()
@@ -233,6 +233,17 @@ extern "C" {
     /** Number of steps in s-step algorithms */
     int Nsteps;
 
+    /** Polynomial basis used by the communication-avoiding s-step solvers */
+    QudaCABasis ca_basis;
+
+    /** Lower bound of the spectral interval used to build the Newton and Chebyshev bases */
+    double ca_lambda_min;
+
+    /** Upper bound of the spectral interval used to build the Newton
+        and Chebyshev bases; if non-positive it is estimated with power
+        iterations at the start of the solve */
+    double ca_lambda_max;
+
     /** Maximum size of Krylov space used by solver */
     int gcrNkrylov;
 
@@ -327,6 +338,13 @@ extern "C" {
     /** The index to indeicate which chrono history we are augmenting */
     int chrono_index;
 
+    /** Precision to store the chronological basis in (defaults to
+        cuda_prec).  The total device memory used by the bases of all
+        chrono indices, plus the two cuda_prec work vectors used when
+        forecasting, can be capped with QUDA_CHRONO_MEMORY (in MiB),
+        with the least recently used vectors evicted first. */
+    QudaPrecision chrono_precision;
+
     /** Which external library to use in the linear solvers (MAGMA or Eigen) */
     QudaExtLibType extlib_type;
 
@@ -352,6 +370,8 @@ extern "C" {
     double *MatPoly_param;
     int NPoly;
     double Stp_residual;
+    /** Maximum number of restarts of the restarted Lanczos solver */
+    int max_restarts;
     int nk;
     int np;
     int f_size;
@@ -415,6 +435,16 @@ extern "C" {
     /** Tolerance to use in the setup phase */
     double setup_tol[QUDA_MAX_MG_LEVEL];
 
+    /** Number of rounds of simultaneous relaxation of all null-space
+        vectors in the setup phase, with the whole set orthonormalized
+        together after each round (0 = generate the vectors one at a time) */
+    int setup_block_rounds[QUDA_MAX_MG_LEVEL];
+
+    /** Iterations of the setup solver applied to each existing
+        null-space vector when the hierarchy is refreshed (0 = reuse
+        the vectors as they are) */
+    int setup_refresh_iter[QUDA_MAX_MG_LEVEL];
+
     /** Smoother to use on each level */
     QudaInverterType smoother[QUDA_MAX_MG_LEVEL];
 
@@ -455,12 +485,33 @@ extern "C" {
     /** Whether to run the verification checks once set up is complete */
     QudaBoolean run_verify;
 
+    /** Whether updateMultigridQuda also refreshes the coarse grids,
+        rebuilding the coarse operators from the existing (optionally
+        relaxed) null-space vectors, rather than only recreating the
+        fine-grid operators and smoothers */
+    QudaBoolean setup_refresh;
+
     /** Filename prefix where to load the null-space vectors */
     char vec_infile[256];
 
     /** Filename prefix for where to save the null-space vectors */
     char vec_outfile[256];
 
+    /** Whether to save the null-space vectors in QUDA's native
+        parallel binary format rather than with QIO (this is always
+        the case if QUDA is built without QIO); loading detects the
+        format of the file */
+    QudaBoolean vec_native_io;
+
+    /** Filename prefix from which to restore the complete hierarchy
+        (null-space vectors, prolongators and coarse operators),
+        bypassing the setup; there is one file per level and rank */
+    char checkpoint_infile[256];
+
+    /** Filename prefix for where to checkpoint the complete hierarchy
+        once it has been set up */
+    char checkpoint_outfile[256];
+
     /** The Gflops rate of the multigrid solver setup */
     double gflops;
 
@@ -538,7 +589,10 @@ extern "C" {
    *               QMP, the existing logical topology is used if it's been
    *               declared.  With MPI or as a fallback with QMP, the default
    *               ordering is lexicographical with the fourth ("t") index
-   *               varying fastest.
+   *               varying fastest, unless QUDA_COMMS_MAP=node is set, in
+   *               which case the node-aware mapping of
+   *               initCommsGridNodeQuda() is used (assuming equal local
+   *               lattice extents).
    *
    * @param fdata  Pointer to any data required by "func" (may be NULL)
    *
@@ -546,6 +600,28 @@ extern "C" {
    */
   void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata);
 
+  /**
+   * Declare the grid mapping as initCommsGridQuda() does, but with a
+   * built-in node-aware mapping: the ranks that share a node are
+   * placed in a compact sub-block of the grid, so that most of the
+   * halo exchange stays within a node.  The block shape is chosen to
+   * minimize the lattice surface between nodes.  All nodes must hold
+   * the same number of ranks, otherwise the lexicographical mapping
+   * is used.
+   *
+   * @param nDim   Number of grid dimensions.  "4" is the only supported
+   *               value currently.
+   *
+   * @param dims   Array of grid dimensions, as for initCommsGridQuda()
+   *
+   * @param X      Global lattice dimensions, used to weigh the faces
+   *               of the sub-blocks.  If NULL, the local lattice is
+   *               assumed to have equal extents.
+   *
+   * @see initCommsGridQuda
+   */
+  void initCommsGridNodeQuda(int nDim, const int *dims, const int *X);
+
   /**
    * Initialize the library.  This is a low-level interface that is
    * called by initQuda.  Calling initQudaDevice requires that the
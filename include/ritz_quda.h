@@ -45,6 +45,16 @@ namespace quda {
 
     void operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const;
 
+    /**
+       @brief Apply the underlying operator without the polynomial
+     */
+    void Mat(cudaColorSpinorField &out, const cudaColorSpinorField &in) const { dirac_mat(out, in); }
+
+    /**
+       @return Order of the Chebychev polynomial, with NPoly < 2 meaning no acceleration
+     */
+    int NPoly() const { return N_Poly; }
+
     //    unsigned long long flops() const { return (dirac_mat->dirac)->Flops(); }
 
     //    std::string Type() const { return typeid(*(dirac_mat->dirac)).name(); }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include <enum_quda.h>
+
+namespace quda {
+
+  /**
+     @brief Precomputed nearest-neighbor indices for a checkerboarded
+     4-d or 5-d lattice.  Host stencils (the CPU kernels and the
+     reference operators in the tests) use this to avoid recomputing
+     the site coordinates and wrapping them for every site and
+     direction.
+
+     The table is laid out as [parity][dir][x_cb], where dir = 2*d
+     for the forward neighbor in dimension d and dir = 2*d+1 for the
+     backward neighbor (the same convention as the dslash kernels, so
+     dir 8 and 9 are the fifth dimension).  Each entry is the
+     checkerboard index of the neighbor in the opposite-parity field.
+     Where the neighbor lies in the ghost zone of a partitioned
+     dimension the entry is instead encoded as -(ghost_idx+1), with
+     ghost_idx the checkerboard index into the ghost face as given by
+     ghostFaceIndex().
+   */
+  class StencilIndex {
+
+  protected:
+    int X[5];           // full lattice dimensions, X[4] = 1 for 4-d lattices
+    int nDim;           // number of dimensions (4 or 5)
+    QudaDWFPCType pc_type; // whether the fifth dimension is included in the parity
+    int hop;            // distance to the neighbor
+    int nFace;          // depth of the ghost zone
+    int commDim[4];     // whether a given dimension is partitioned or not
+    int volumeCB;       // checkerboarded volume
+    std::vector<int> index;
+
+  public:
+    /**
+       @brief Build the neighbor table
+       @param[in] X Full (local) lattice dimensions (nDim entries)
+       @param[in] nDim Number of dimensions (4 or 5)
+       @param[in] pc_type Whether the parity is defined on the 4-d or 5-d lattice
+       @param[in] hop Distance to the neighbor (e.g., 3 for the staggered long links)
+       @param[in] nFace Depth of the ghost zone
+       @param[in] commDim Whether each of the first four dimensions is partitioned
+     */
+    StencilIndex(const int *X, int nDim, QudaDWFPCType pc_type, int hop, int nFace, const int *commDim);
+
+    /**
+       @brief Whether this table was built for the given geometry
+     */
+    bool Match(const int *X, int nDim, QudaDWFPCType pc_type, int hop, int nFace, const int *commDim) const;
+
+    /**
+       @return Raw table, laid out as [parity][dir][x_cb]
+     */
+    const int* Index() const { return index.data(); }
+
+    /**
+       @return Neighbor (or encoded ghost) index of site x_cb at the given parity in direction dir
+     */
+    int Neighbor(int parity, int dir, int x_cb) const { return index[(parity*2*nDim + dir)*volumeCB + x_cb]; }
+
+    /**
+       @return Whether a table entry refers to the ghost zone
+     */
+    static bool IsGhost(int nbr) { return nbr < 0; }
+
+    /**
+       @return The ghost-face index encoded in a ghost table entry
+     */
+    static int GhostIndex(int nbr) { return -nbr - 1; }
+
+    int VolumeCB() const { return volumeCB; }
+    int Ndim() const { return nDim; }
+    size_t Bytes() const { return index.size() * sizeof(int); }
+  };
+
+  /**
+     @brief Return the neighbor table for the given geometry, building
+     it on first use.  Tables are cached for the lifetime of QUDA (or
+     until flushStencilIndex() is called).  The cache is guarded by a
+     mutex, but the lookup is a linear search, so callers should look
+     up the table once per operator application, outside of any
+     parallel region, and pass the raw table down.  See the
+     StencilIndex constructor for the parameters.
+   */
+  const StencilIndex& getStencilIndex(const int *X, int nDim, QudaDWFPCType pc_type, int hop, int nFace,
+				      const int *commDim);
+
+  /**
+     @brief Free all cached neighbor tables
+   */
+  void flushStencilIndex();
+
+} // namespace quda
@@ -104,6 +104,12 @@ namespace quda {
      */
     void fillV(ColorSpinorField &V);
 
+    /**
+     * Copies the host prolongator to the GPU (if enabled), taking
+     * account of the current site subset
+     */
+    void uploadV();
+
     /** 
      * Creates the map between fine and coarse grids 
      * @param geo_bs An array storing the block size in each geometric dimension
@@ -166,9 +172,12 @@ namespace quda {
      * @param spin_bs The spin block sizes to use
      * @param parity For single-parity fields are these QUDA_EVEN_PARITY or QUDA_ODD_PARITY
      * @param enable_gpu Whether to enable this to run on GPU (as well as CPU)
+     * @param build_V Whether to build the prolongator from B, else it
+     * must be supplied with setVectors() (e.g., when restoring from a
+     * checkpoint)
      */
     Transfer(const std::vector<ColorSpinorField*> &B, int Nvec, int *geo_bs, int spin_bs,
-	     bool enable_gpu, TimeProfile &profile);
+	     bool enable_gpu, TimeProfile &profile, bool build_V=true);
 
     /** The destructor for Transfer */
     virtual ~Transfer();
@@ -237,6 +246,27 @@ namespace quda {
      */
     void setSiteSubset(QudaSiteSubset site_subset, QudaParity parity);
 
+    /**
+     * @brief Rebuild the prolongator from the current contents of the
+     * null-space vectors, e.g., after they have been updated to track
+     * a change in the fine-grid operator.  The blocking and site maps
+     * are unchanged.
+     */
+    void reset();
+
+    /**
+     * @brief Install a block-orthogonal prolongator computed
+     * elsewhere, e.g., restored from a checkpoint
+     * @param V Host field laid out as Vectors()
+     */
+    void setVectors(const ColorSpinorField &V);
+
+    /**
+     * Returns the host fine-to-coarse site map
+     * @return fine_to_coarse_h
+     */
+    const int *FineToCoarse() const { return fine_to_coarse_h; }
+
     /**
      * Return flops
      * @return flops expended by this operator
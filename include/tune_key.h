@@ -2,6 +2,7 @@
 #define _TUNE_KEY_H
 
 #include <cstring>
+#include <stdint.h>
 
 namespace quda {
 
@@ -13,17 +14,20 @@ namespace quda {
     char volume[volume_n];
     char name[name_n];
     char aux[aux_n];
+    uint64_t hash; // 64-bit digest of volume, name and aux used for tunecache lookup
 
-    TuneKey() { }
+    TuneKey() : hash(0) { }
     TuneKey(const char v[], const char n[], const char a[]="type=default") {
       strcpy(volume, v);
       strcpy(name, n);
       strcpy(aux, a);
+      rehash();
     } 
     TuneKey(const TuneKey &key) {
       strcpy(volume,key.volume);
       strcpy(name,key.name);
       strcpy(aux,key.aux);
+      hash = key.hash;
     }
 
     TuneKey& operator=(const TuneKey &key) {
@@ -31,10 +35,40 @@ namespace quda {
 	strcpy(volume,key.volume);
 	strcpy(name,key.name);
 	strcpy(aux,key.aux);
+	hash = key.hash;
       }
       return *this;
     }
 
+    /**
+       @brief Compute the 64-bit FNV-1a digest of the volume, name and
+       aux strings.  This is evaluated once when the key is built, so
+       any code that modifies the strings of an existing key (e.g.,
+       appending to aux) must call rehash() afterwards.
+       @return The digest (never zero, since zero marks an empty slot
+       in the tunecache index)
+     */
+    uint64_t digest() const {
+      const uint64_t prime = 1099511628211ull;
+      uint64_t h = 14695981039346656037ull;
+      const char *str[] = { volume, name, aux };
+      for (int i=0; i<3; i++) {
+	for (const char *c = str[i]; *c; c++) { h ^= static_cast<unsigned char>(*c); h *= prime; }
+	h *= prime; // mix in the string terminator so that field boundaries are significant
+      }
+      return h ? h : 1;
+    }
+
+    /**
+       @brief Recompute the cached digest after modifying the key strings
+     */
+    void rehash() { hash = digest(); }
+
+    bool operator==(const TuneKey &other) const {
+      return std::strcmp(volume, other.volume) == 0 && std::strcmp(name, other.name) == 0 &&
+	std::strcmp(aux, other.aux) == 0;
+    }
+
     bool operator<(const TuneKey &other) const {
       int vc = std::strcmp(volume, other.volume);
       if (vc < 0) {
@@ -457,6 +457,15 @@ namespace quda {
   void loadTuneCache();
   void saveTuneCache();
 
+  /**
+     @brief Query whether a given key is present in the tunecache.
+     This uses the hashed tunecache index so is cheap enough to call
+     on every launch.
+     @param[in] key The key to look up
+     @return Whether the key has been tuned
+  */
+  bool tuneCacheHit(const TuneKey &key);
+
   /**
    * @brief Save profile to disk.
    */
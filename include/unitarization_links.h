@@ -33,7 +33,17 @@ namespace quda {
 				  bool allow_svd, bool svd_only,
 				  double svd_rel_error, double svd_abs_error);
 
-  void unitarizeLinksCPU(cpuGaugeField& outfield, const cpuGaugeField &infield);
+  /**
+   * @brief Unitarize a host gauge field (MILC order) with the Newton
+   * iteration.  Links are processed in vectorized batches, threaded
+   * over the volume.
+   *
+   * @param outfield Unitarized gauge field
+   * @param infield Input gauge field
+   * @return Number of links whose unitarization is not consistent
+   * with the input link
+   */
+  int unitarizeLinksCPU(cpuGaugeField& outfield, const cpuGaugeField &infield);
 
   void unitarizeLinks(cudaGaugeField& outfield, const cudaGaugeField &infield, int *fails);
   void unitarizeLinks(cudaGaugeField& outfield, int *fails);
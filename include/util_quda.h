@@ -13,6 +13,23 @@
  */
 QudaTune getTuning();
 
+/**
+   @brief Query the number of host threads used by the threaded CPU
+   kernels.  Default is the OpenMP runtime default (e.g., as set by
+   OMP_NUM_THREADS) but can be overridden by setting
+   QUDA_OMP_NUM_THREADS or by calling setOmpThreads.  If QUDA has not
+   been built with OpenMP support (QUDA_OPENMP) this always returns 1.
+   @return Number of host threads
+ */
+int getOmpThreads();
+
+/**
+   @brief Set the number of host threads used by the threaded CPU
+   kernels.  This takes precedence over QUDA_OMP_NUM_THREADS.
+   @param[in] nthreads Number of host threads (must be positive)
+ */
+void setOmpThreads(int nthreads);
+
 QudaVerbosity getVerbosity();
 char *getOutputPrefix();
 FILE *getOutputFile();
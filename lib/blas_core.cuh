@@ -191,8 +191,15 @@ template <typename Float2, int writeX, int writeY, int writeZ, int writeW,
   typename Functor>
 void genericBlas(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, Functor f) {
 
-  for (int parity=0; parity<X.Nparity(); parity++) {
-    for (int x=0; x<X.VolumeCB(); x++) {
+  const int nParity = X.Nparity();
+  const int volumeCB = X.VolumeCB();
+
+  // each site is independent so we can simply thread over them; the
+  // nSpin x nColor inner loops have compile-time trip counts and
+  // unit stride for the SPACE_SPIN_COLOR order so vectorize well
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
+  for (int parity=0; parity<nParity; parity++) {
+    for (int x=0; x<volumeCB; x++) {
       for (int s=0; s<X.Nspin(); s++) {
 	for (int c=0; c<X.Ncolor(); c++) {
 	  Float2 X2 = make_Float2<Float2>( X(parity, x, s, c) );
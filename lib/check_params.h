@@ -152,6 +152,7 @@ void printQudaEigParam(QudaEigParam *param) {
   P(eig_type, QUDA_INVALID_TYPE);
   P(NPoly, 0);
   P(Stp_residual, 0.0);
+  P(max_restarts, 100);
   P(nk, 0);
   P(np, 0);
   P(f_size, 0);
@@ -161,6 +162,7 @@ void printQudaEigParam(QudaEigParam *param) {
 #else
   P(NPoly, INVALID_INT);
   P(Stp_residual, INVALID_DOUBLE);
+  P(max_restarts, INVALID_INT);
   P(nk, INVALID_INT);
   P(np, INVALID_INT);
   P(f_size, INVALID_INT);
@@ -326,10 +328,19 @@ void printQudaInvertParam(QudaInvertParam *param) {
 
 #if defined INIT_PARAM
   P(Nsteps, INVALID_INT);
+  P(ca_basis, QUDA_CHEBYSHEV_BASIS);
+  P(ca_lambda_min, 0.0);
+  P(ca_lambda_max, -1.0);
 #else
-  if(param->inv_type == QUDA_MPCG_INVERTER || param->inv_type == QUDA_MPBICGSTAB_INVERTER){
+  if(param->inv_type == QUDA_MPCG_INVERTER || param->inv_type == QUDA_MPBICGSTAB_INVERTER ||
+     param->inv_type == QUDA_CA_CG_INVERTER || param->inv_type == QUDA_CA_BICGSTAB_INVERTER){
     P(Nsteps, INVALID_INT);
   }
+  if (param->inv_type == QUDA_CA_CG_INVERTER || param->inv_type == QUDA_CA_BICGSTAB_INVERTER) {
+    P(ca_basis, QUDA_INVALID_BASIS);
+    P(ca_lambda_min, INVALID_DOUBLE);
+    P(ca_lambda_max, INVALID_DOUBLE);
+  }
 #endif
 
 #if defined INIT_PARAM
@@ -483,6 +494,13 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(chrono_index, INVALID_INT);
 #endif
 
+#if defined INIT_PARAM
+  P(chrono_precision, QUDA_INVALID_PRECISION);
+#else
+  if (param->chrono_precision == QUDA_INVALID_PRECISION)
+    param->chrono_precision = param->cuda_prec;
+#endif
+
 #if defined INIT_PARAM
   P(extlib_type, QUDA_EIGEN_EXTLIB);
 #else
@@ -536,6 +554,16 @@ void printQudaMultigridParam(QudaMultigridParam *param) {
     P(setup_tol[i], 5e-6);
 #else
     P(setup_tol[i], INVALID_DOUBLE);
+#endif
+#ifdef INIT_PARAM
+    P(setup_block_rounds[i], 0);
+#else
+    P(setup_block_rounds[i], INVALID_INT);
+#endif
+#ifdef INIT_PARAM
+    P(setup_refresh_iter[i], 0);
+#else
+    P(setup_refresh_iter[i], INVALID_INT);
 #endif
     P(smoother[i], QUDA_INVALID_INVERTER);
     P(smoother_solve_type[i], QUDA_INVALID_SOLVE);
@@ -583,6 +611,24 @@ void printQudaMultigridParam(QudaMultigridParam *param) {
 
   P(run_verify, QUDA_BOOLEAN_INVALID);
 
+#ifdef INIT_PARAM
+  P(setup_refresh, QUDA_BOOLEAN_NO);
+#else
+  P(setup_refresh, QUDA_BOOLEAN_INVALID);
+#endif
+
+#ifdef INIT_PARAM
+  P(vec_native_io, QUDA_BOOLEAN_NO);
+#else
+  P(vec_native_io, QUDA_BOOLEAN_INVALID);
+#endif
+
+#ifdef INIT_PARAM
+  // no checkpointing unless requested
+  ret.checkpoint_infile[0] = '\0';
+  ret.checkpoint_outfile[0] = '\0';
+#endif
+
 #ifdef INIT_PARAM
   P(gflops, 0.0);
   P(secs, 0.0);
@@ -19,39 +19,65 @@ namespace quda {
     return u.checksum(); 
   }
 
+  /**
+     Threaded XOR checksum of the field: each thread reduces the
+     checksum of each (parity, dimension) over its share of the sites,
+     and these are then combined.  Since XOR is commutative the
+     result is independent of the number of threads.
+  */
   template <typename Arg>
-  uint64_t ChecksumCPU(const Arg &arg)
+  uint64_t ChecksumCPU(const Arg &arg, uint64_t *partial)
   {
-    uint64_t checksum_ = 0;
-    for (int parity=0; parity<2; parity++)
-      for (int x_cb=0; x_cb<arg.volumeCB; x_cb++)
-	for (int d=0; d<arg.U.geometry; d++)
-	  checksum_ ^= siteChecksum(arg, d, parity, x_cb);
-    return checksum_;
+    uint64_t checksum_[2][QUDA_MAX_GEOMETRY] = { };
+
+#pragma omp parallel num_threads(getOmpThreads())
+    {
+      uint64_t local[2][QUDA_MAX_GEOMETRY] = { };
+
+      for (int parity=0; parity<2; parity++) {
+#pragma omp for schedule(static) nowait
+	for (int x_cb=0; x_cb<arg.volumeCB; x_cb++)
+	  for (int d=0; d<arg.U.geometry; d++)
+	    local[parity][d] ^= siteChecksum(arg, d, parity, x_cb);
+      }
+
+#pragma omp critical
+      for (int parity=0; parity<2; parity++)
+	for (int d=0; d<arg.U.geometry; d++) checksum_[parity][d] ^= local[parity][d];
+    }
+
+    uint64_t checksum = 0;
+    for (int parity=0; parity<2; parity++) {
+      for (int d=0; d<arg.U.geometry; d++) {
+	if (partial) partial[parity*arg.U.geometry + d] = checksum_[parity][d];
+	checksum ^= checksum_[parity][d];
+      }
+    }
+    return checksum;
   }
 
   template <typename T, int Nc>
-  uint64_t Checksum(const GaugeField &u, bool mini)
+  uint64_t Checksum(const GaugeField &u, uint64_t *partial, bool mini)
   {
     uint64_t checksum = 0;
     if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
       ChecksumArg<T,QUDA_QDP_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      checksum = ChecksumCPU(arg, partial);
     } else if (u.Order() == QUDA_QDPJIT_GAUGE_ORDER) {
       ChecksumArg<T,QUDA_QDPJIT_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      checksum = ChecksumCPU(arg, partial);
     } else if (u.Order() == QUDA_MILC_GAUGE_ORDER) {
       ChecksumArg<T,QUDA_MILC_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      checksum = ChecksumCPU(arg, partial);
     } else if (u.Order() == QUDA_BQCD_GAUGE_ORDER) {
       ChecksumArg<T,QUDA_BQCD_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      checksum = ChecksumCPU(arg, partial);
     } else if (u.Order() == QUDA_TIFR_GAUGE_ORDER) {
       ChecksumArg<T,QUDA_TIFR_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      checksum = ChecksumCPU(arg, partial);
     } else if (u.Order() == QUDA_TIFR_PADDED_GAUGE_ORDER) {
       ChecksumArg<T,QUDA_TIFR_PADDED_GAUGE_ORDER,Nc> arg(u,mini);
-      checksum = ChecksumCPU(arg);
+      checksum = ChecksumCPU(arg, partial);
     } else {
       errorQuda("Checksum not implemented");
     }    
@@ -60,26 +86,47 @@ namespace quda {
   }
 
   template <typename T>
-  uint64_t Checksum(const GaugeField &u, bool mini)
+  uint64_t Checksum(const GaugeField &u, uint64_t *partial, bool mini)
   {
     uint64_t checksum = 0;
     switch (u.Ncolor()) {
-    case 3: checksum = Checksum<T,3>(u,mini); break;
+    case 3: checksum = Checksum<T,3>(u,partial,mini); break;
     default: errorQuda("Unsupported nColor = %d", u.Ncolor());
     }
     return checksum;
   }
 
-  uint64_t Checksum(const GaugeField &u, bool mini)
+  uint64_t Checksum(const GaugeField &u, uint64_t *partial, bool mini)
   {
     uint64_t checksum = 0;
     switch (u.Precision()) {
-    case QUDA_DOUBLE_PRECISION: checksum = Checksum<double>(u,mini); break;
-    case QUDA_SINGLE_PRECISION: checksum = Checksum<float>(u,mini); break;
+    case QUDA_DOUBLE_PRECISION: checksum = Checksum<double>(u,partial,mini); break;
+    case QUDA_SINGLE_PRECISION: checksum = Checksum<float>(u,partial,mini); break;
     default: errorQuda("Unsupported precision = %d", u.Precision());
     }
 
     comm_allreduce_xor(&checksum);
+    if (partial) for (int i=0; i<2*u.Geometry(); i++) comm_allreduce_xor(partial+i);
+
+    return checksum;
+  }
+
+  uint64_t Checksum(const GaugeField &u, bool mini)
+  {
+    return Checksum(u, nullptr, mini);
+  }
+
+  uint64_t reduceChecksum(const GaugeChecksumStream &stream, uint64_t *partial, int geometry)
+  {
+    if (!stream.complete) errorQuda("Checksum has not been streamed");
+
+    uint64_t checksum = 0;
+    for (int i=0; i<2*geometry; i++) {
+      uint64_t partial_ = stream.partial[i];
+      comm_allreduce_xor(&partial_);
+      if (partial) partial[i] = partial_;
+      checksum ^= partial_;
+    }
 
     return checksum;
   }
@@ -37,10 +37,14 @@ namespace quda {
     const int fineVolumeCB;     /** Fine grid volume */
     const int coarseVolumeCB;   /** Coarse grid volume */
 
+    int *coarse_offset;         /** Offset into coarse_to_fine for each coarse site parity*coarseVolumeCB+x_cb (CPU only) */
+    int *coarse_to_fine;        /** Fine sites parity*fineVolumeCB+x_cb of each coarse site (CPU only) */
+
     CalculateYArg(coarseGauge &Y, coarseGauge &X, coarseGauge &Xinv, fineSpinorTmp &UV, fineSpinor &AV, const fineGauge &U, const fineSpinor &V,
 		  const fineClover &C, const fineClover &Cinv, double kappa, double mu, double mu_factor, const int *x_size_, const int *xc_size_, int *geo_bs_, int spin_bs_)
       : Y(Y), X(X), Xinv(Xinv), UV(UV), AV(AV), U(U), V(V), C(C), Cinv(Cinv), spin_bs(spin_bs_), kappa(static_cast<Float>(kappa)), mu(static_cast<Float>(mu)),
-	mu_factor(static_cast<Float>(mu_factor)), fineVolumeCB(V.VolumeCB()), coarseVolumeCB(X.VolumeCB())
+	mu_factor(static_cast<Float>(mu_factor)), fineVolumeCB(V.VolumeCB()), coarseVolumeCB(X.VolumeCB()),
+	coarse_offset(nullptr), coarse_to_fine(nullptr)
     {
       if (V.GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS)
 	errorQuda("Gamma basis %d not supported", V.GammaBasis());
@@ -54,6 +58,70 @@ namespace quda {
     }
   };
 
+  /**
+     @brief Compute the coarse site (parity*coarseVolumeCB + x_cb)
+     that a given fine site belongs to
+  */
+  template <typename Arg>
+  inline int coarseSiteIndex(const Arg &arg, int parity, int x_cb) {
+    constexpr int nDim = 4;
+    int coord[QUDA_MAX_DIM];
+    int coord_coarse[QUDA_MAX_DIM];
+
+    getCoords(coord, x_cb, arg.x_size, parity);
+    for (int d=0; d<nDim; d++) coord_coarse[d] = coord[d]/arg.geo_bs[d];
+
+    int coarse_parity = 0;
+    for (int d=0; d<nDim; d++) coarse_parity += coord_coarse[d];
+    coarse_parity &= 1;
+    coord_coarse[0] /= 2;
+    int coarse_x_cb = ((coord_coarse[3]*arg.xc_size[2]+coord_coarse[2])*arg.xc_size[1]+coord_coarse[1])*(arg.xc_size[0]/2) + coord_coarse[0];
+
+    return coarse_parity*arg.coarseVolumeCB + coarse_x_cb;
+  }
+
+  /**
+     @brief Build the map from each coarse site to the fine sites in
+     its block.  This allows the CPU accumulation into the coarse
+     fields to be threaded over coarse sites: each coarse site is then
+     only updated by one thread, which visits the fine sites in the
+     same (parity, x_cb) order as a serial loop would, so the result is
+     bitwise independent of the number of threads.
+  */
+  template <typename Arg>
+  void createCoarseBlockMap(Arg &arg) {
+    const int nCoarse = 2*arg.coarseVolumeCB;
+    const int nFine = 2*arg.fineVolumeCB;
+
+    arg.coarse_offset = static_cast<int*>(pool_host_malloc((nCoarse+1)*sizeof(int)));
+    arg.coarse_to_fine = static_cast<int*>(pool_host_malloc(nFine*sizeof(int)));
+    int *coarse_index = static_cast<int*>(pool_host_malloc(nFine*sizeof(int)));
+    int *cursor = static_cast<int*>(pool_host_malloc(nCoarse*sizeof(int)));
+
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
+    for (int parity=0; parity<2; parity++)
+      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++)
+	coarse_index[parity*arg.fineVolumeCB + x_cb] = coarseSiteIndex(arg, parity, x_cb);
+
+    // counting sort of the fine sites by coarse site, preserving the fine-site order
+    for (int i=0; i<=nCoarse; i++) arg.coarse_offset[i] = 0;
+    for (int i=0; i<nFine; i++) arg.coarse_offset[coarse_index[i]+1]++;
+    for (int i=0; i<nCoarse; i++) arg.coarse_offset[i+1] += arg.coarse_offset[i];
+    for (int i=0; i<nCoarse; i++) cursor[i] = arg.coarse_offset[i];
+    for (int i=0; i<nFine; i++) arg.coarse_to_fine[cursor[coarse_index[i]]++] = i;
+
+    pool_host_free(cursor);
+    pool_host_free(coarse_index);
+  }
+
+  template <typename Arg>
+  void destroyCoarseBlockMap(Arg &arg) {
+    if (arg.coarse_to_fine) pool_host_free(arg.coarse_to_fine);
+    if (arg.coarse_offset) pool_host_free(arg.coarse_offset);
+    arg.coarse_to_fine = nullptr;
+    arg.coarse_offset = nullptr;
+  }
+
   /**
      Calculates the matrix UV^{s,c'}_mu(x) = \sum_c U^{c}_mu(x) * V^{s,c}_mu(x+mu)
      Where: mu = dir, s = fine spin, c' = coarse color, c = fine color
@@ -130,6 +198,7 @@ namespace quda {
 
   template<bool from_coarse, typename Float, int dim, QudaDirection dir, int fineSpin, int fineColor, int coarseSpin, int coarseColor, typename Arg>
   void ComputeUVCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
 	for (int ic_c=0; ic_c < coarseColor; ic_c++) // coarse color
@@ -182,6 +251,7 @@ namespace quda {
 
   template<typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
   void ComputeAVCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
 	for (int ic_c=0; ic_c < coarseColor; ic_c++) // coarse color
@@ -227,6 +297,7 @@ namespace quda {
 
   template<typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
   void ComputeTMAVCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
 	for (int v=0; v<coarseColor; v++) // coarse color
@@ -463,6 +534,7 @@ namespace quda {
 
   template<typename Float, int fineSpin, int fineColor, int coarseColor, typename Arg>
   void ComputeTMCAVCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
 	computeTMCAV<Float,fineSpin,fineColor,coarseColor,Arg>(arg, parity, x_cb);
@@ -612,12 +684,16 @@ namespace quda {
 
   template<bool from_coarse, typename Float, int dim, QudaDirection dir, int fineSpin, int fineColor, int coarseSpin, int coarseColor, typename Arg>
   void ComputeVUVCPU(Arg arg) {
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) { // Loop over fine volume
+    // thread over coarse sites, see createCoarseBlockMap
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
+    for (int coarse_site=0; coarse_site<2*arg.coarseVolumeCB; coarse_site++) {
+      for (int i=arg.coarse_offset[coarse_site]; i<arg.coarse_offset[coarse_site+1]; i++) { // Loop over fine sites in block
+	const int parity = arg.coarse_to_fine[i] / arg.fineVolumeCB;
+	const int x_cb = arg.coarse_to_fine[i] - parity*arg.fineVolumeCB;
 	for (int c_row=0; c_row<coarseColor; c_row++)
 	  computeVUV<from_coarse,Float,dim,dir,fineSpin,fineColor,coarseSpin,coarseColor,Arg>(arg, parity, x_cb, c_row);
-      } // c/b volume
-    } // parity
+      } // fine sites
+    } // coarse sites
   }
 
   template<bool from_coarse, typename Float, int dim, QudaDirection dir, int fineSpin, int fineColor, int coarseSpin, int coarseColor, typename Arg>
@@ -659,6 +735,7 @@ namespace quda {
 
   template<typename Float, int nSpin, int nColor, typename Arg>
   void ComputeYReverseCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
 	computeYreverse<Float,nSpin,nColor,Arg>(arg, parity, x_cb);
@@ -727,6 +804,7 @@ namespace quda {
 
   template<bool bidirectional, typename Float, int nSpin, int nColor, typename Arg>
   void ComputeCoarseLocalCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
 	computeCoarseLocal<bidirectional,Float,nSpin,nColor,Arg>(arg, parity, x_cb);
@@ -820,13 +898,17 @@ namespace quda {
 
   template <bool from_coarse, typename Float, int fineSpin, int coarseSpin, int fineColor, int coarseColor, typename Arg>
   void ComputeCoarseCloverCPU(Arg &arg) {
-    for (int parity=0; parity<2; parity++) {
-      for (int x_cb=0; x_cb<arg.fineVolumeCB; x_cb++) {
+    // thread over coarse sites, see createCoarseBlockMap
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
+    for (int coarse_site=0; coarse_site<2*arg.coarseVolumeCB; coarse_site++) {
+      for (int i=arg.coarse_offset[coarse_site]; i<arg.coarse_offset[coarse_site+1]; i++) { // Loop over fine sites in block
+	const int parity = arg.coarse_to_fine[i] / arg.fineVolumeCB;
+	const int x_cb = arg.coarse_to_fine[i] - parity*arg.fineVolumeCB;
 	for (int ic_c=0; ic_c<coarseColor; ic_c++) {
 	  computeCoarseClover<from_coarse,Float,fineSpin,coarseSpin,fineColor,coarseColor>(arg, parity, x_cb, ic_c);
 	}
-      } // c/b volume
-    } // parity
+      } // fine sites
+    } // coarse sites
   }
 
   template <bool from_coarse, typename Float, int fineSpin, int coarseSpin, int fineColor, int coarseColor, typename Arg>
@@ -844,6 +926,7 @@ namespace quda {
   //Adds the identity matrix to the coarse local term.
   template<typename Float, int nSpin, int nColor, typename Arg>
   void AddCoarseDiagonalCPU(Arg &arg) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
         for(int s = 0; s < nSpin; s++) { //Spin
@@ -876,6 +959,7 @@ namespace quda {
 
     const complex<Float> mu(0., arg.mu*arg.mu_factor);
 
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
       for (int x_cb=0; x_cb<arg.coarseVolumeCB; x_cb++) {
 	for(int s = 0; s < nSpin/2; s++) { //Spin
@@ -1389,6 +1473,7 @@ namespace quda {
   template<typename Float, int n, typename Arg>
   void CalculateYhatCPU(Arg &arg) {
 
+#pragma omp parallel for collapse(3) schedule(static) num_threads(getOmpThreads())
     for (int d=0; d<4; d++) {
       for (int parity=0; parity<2; parity++) {
 	for (int x_cb=0; x_cb<arg.Y.VolumeCB(); x_cb++) {
@@ -1523,6 +1608,7 @@ namespace quda {
 
     QudaFieldLocation location = checkLocation(Y_, X_, Xinv_, Yhat_, av, v);
     printfQuda("Running link coarsening on the %s\n", location == QUDA_CUDA_FIELD_LOCATION ? "GPU" : "CPU");
+    if (location == QUDA_CPU_FIELD_LOCATION) createCoarseBlockMap(arg);
 
     // If doing a preconditioned operator with a clover term then we
     // have bi-directional links, though we can do the bidirectional setup for all operators for debugging
@@ -1661,6 +1747,8 @@ namespace quda {
 
     printfQuda("X2 = %e\n", X.norm2(0));
 
+    if (location == QUDA_CPU_FIELD_LOCATION) destroyCoarseBlockMap(arg);
+
     // invert the clover matrix field
     const int n = X_.Ncolor();
     if (X_.Location() == QUDA_CUDA_FIELD_LOCATION && X_.Order() == QUDA_FLOAT2_GAUGE_ORDER) {
@@ -4,6 +4,7 @@
 #include <gauge_field.h>
 #include <gauge_field_order.h>
 #include <index_helper.cuh>
+#include <stencil_index.h>
 #include <color_spinor.h>
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
@@ -27,13 +28,15 @@ namespace quda {
     const int dim[5];     // full lattice dimensions
     const int commDim[4]; // whether a given dimension is partitioned or not
     const int volumeCB;   // checkerboarded volume
+    const int *nbr;       // precomputed neighbor table (host fields only)
 
     WuppertalSmearingArg(ColorSpinorField &out, const ColorSpinorField &in, int parity, const GaugeField &U,
                        Float A, Float B)
       : out(out), in(in), U(U), A(A), B(B), parity(parity), nParity(in.SiteSubset()), nFace(1),
         dim{ (3-nParity) * in.X(0), in.X(1), in.X(2), in.X(3), 1 },
       commDim{comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3)},
-      volumeCB(in.VolumeCB())
+      volumeCB(in.VolumeCB()),
+      nbr(in.Location() == QUDA_CPU_FIELD_LOCATION ? getStencilIndex(dim, 4, QUDA_4D_PC, 1, nFace, commDim).Index() : nullptr)
     {
       if (in.FieldOrder() != QUDA_FLOAT2_FIELD_ORDER || !U.isNative())
         errorQuda("Unsupported field order colorspinor=%d gauge=%d combination\n", in.FieldOrder(), U.FieldOrder());
@@ -48,27 +51,25 @@ namespace quda {
      @param[in] x_cb The checkerboarded site index
      @param[in] parity The site parity
   */
-  template <typename Float, int Nc, typename Vector, typename Arg>
+  template <typename Float, int Nc, bool table, typename Vector, typename Arg>
   __device__ __host__ inline void computeNeighborSum(Vector &out, Arg &arg, int x_cb, int parity) {
 
     typedef Matrix<complex<Float>,Nc> Link;
     const int their_spinor_parity = (arg.nParity == 2) ? 1-parity : 0;
 
-    int coord[5];
-    getCoords(coord, x_cb, arg.dim, parity);
-    coord[4] = 0;
+    int coord[5] = { };
+    if (!table) getCoords(coord, x_cb, arg.dim, parity);
 
 #pragma unroll
     for (int dir=0; dir<3; dir++) { // loop over spatial directions
+      bool ghost;
 
       //Forward gather - compute fwd offset for vector fetch
-      const int fwd_idx = linkIndexP1(coord, arg.dim, dir);
-
-      if ( arg.commDim[dir] && (coord[dir] + arg.nFace >= arg.dim[dir]) ) {
-        const int ghost_idx = ghostFaceIndex<1>(coord, arg.dim, dir, arg.nFace);
+      const int fwd_idx = stencilNeighbor<1,table>(ghost, coord, arg, dir, x_cb, parity);
 
+      if (ghost) {
         const Link U = arg.U(dir, x_cb, parity);
-	const Vector in = arg.in.Ghost(dir, 1, ghost_idx, their_spinor_parity);
+	const Vector in = arg.in.Ghost(dir, 1, fwd_idx, their_spinor_parity);
 
         out += U * in;
       } else {
@@ -79,18 +80,15 @@ namespace quda {
       }
 
       //Backward gather - compute back offset for spinor and gauge fetch
-      const int back_idx = linkIndexM1(coord, arg.dim, dir);
-      const int gauge_idx = back_idx;
-
-      if ( arg.commDim[dir] && (coord[dir] - arg.nFace < 0) ) {
-        const int ghost_idx = ghostFaceIndex<0>(coord, arg.dim, dir, arg.nFace);
+      const int back_idx = stencilNeighbor<0,table>(ghost, coord, arg, dir, x_cb, parity);
 
-        const Link U = arg.U.Ghost(dir, ghost_idx, 1-parity);
-	const Vector in = arg.in.Ghost(dir, 0, ghost_idx, their_spinor_parity);
+      if (ghost) {
+        const Link U = arg.U.Ghost(dir, back_idx, 1-parity);
+	const Vector in = arg.in.Ghost(dir, 0, back_idx, their_spinor_parity);
 
         out += conj(U) * in;
       } else {
-        const Link U = arg.U(dir, gauge_idx, 1-parity);
+        const Link U = arg.U(dir, back_idx, 1-parity);
 	const Vector in = arg.in(back_idx, their_spinor_parity);
 
         out += conj(U) * in;
@@ -99,13 +97,13 @@ namespace quda {
   }
 
   //out(x) = A in(x) + B computeNeighborSum(out, x)
-  template <typename Float, int Ns, int Nc, typename Arg>
+  template <typename Float, int Ns, int Nc, bool table, typename Arg>
   __device__ __host__ inline void computeWupperalStep(Arg &arg, int x_cb, int parity)
   {
     typedef ColorSpinor<Float,Nc,Ns> Vector;
     Vector out;
 
-    computeNeighborSum<Float,Nc>(out, arg, x_cb, parity);
+    computeNeighborSum<Float,Nc,table>(out, arg, x_cb, parity);
 
     Vector in;
     arg.in.load((Float*)in.data, x_cb, parity);
@@ -123,8 +121,9 @@ namespace quda {
       // for full fields then set parity from loop else use arg setting
       parity = (arg.nParity == 2) ? parity : arg.parity;
 
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
       for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-        computeWupperalStep<Float,Ns,Nc>(arg, x_cb, parity);
+        computeWupperalStep<Float,Ns,Nc,true>(arg, x_cb, parity);
       } // 4-d volumeCB
     } // parity
 
@@ -143,7 +142,7 @@ namespace quda {
     if (parity >= arg.nParity) return;
     parity = (arg.nParity == 2) ? parity : arg.parity;
 
-    computeWupperalStep<Float,Ns,Nc>(arg, x_cb, parity);
+    computeWupperalStep<Float,Ns,Nc,false>(arg, x_cb, parity);
   }
 
   template <typename Float, int Ns, int Nc, typename Arg>
@@ -1,5 +1,9 @@
 #include <unistd.h> // for gethostname()
 #include <assert.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <limits>
 
 #include <quda_internal.h>
 #include <comm_quda.h>
@@ -142,6 +146,142 @@ void comm_destroy_topology(Topology *topo)
 }
 
 
+/**
+ * Number of sites on the faces of a block of ranks that border other
+ * nodes, for local lattice extents l.  Dimensions in which the block
+ * spans the whole grid have no inter-node faces.
+ */
+static double node_surface(int ndim, const int *dims, const int *block, const int *l)
+{
+  double surface = 0.0;
+  for (int d = 0; d < ndim; d++) {
+    if (block[d] == dims[d]) continue;
+    double face = 2.0;
+    for (int e = 0; e < ndim; e++) if (e != d) face *= block[e] * l[e];
+    surface += face;
+  }
+  return surface;
+}
+
+
+/**
+ * Search all block shapes with n ranks that tile the grid for the
+ * one with the smallest inter-node surface
+ */
+static void node_block_search(int d, int ndim, const int *dims, const int *l, int n,
+                              int *block, int *best, double &best_surface)
+{
+  if (d == ndim) {
+    if (n != 1) return;
+    double surface = node_surface(ndim, dims, block, l);
+    if (surface < best_surface) {
+      best_surface = surface;
+      for (int i = 0; i < ndim; i++) best[i] = block[i];
+    }
+    return;
+  }
+
+  for (int b = 1; b <= dims[d]; b++) {
+    if (dims[d] % b || n % b) continue;
+    block[d] = b;
+    node_block_search(d+1, ndim, dims, l, n / b, block, best, best_surface);
+  }
+}
+
+
+static void comm_node_map_build(CommNodeMap *map)
+{
+  const int ndim = map->ndim;
+  if (ndim > QUDA_MAX_DIM) errorQuda("ndim exceeds QUDA_MAX_DIM");
+
+  int size = 1;
+  for (int d = 0; d < ndim; d++) size *= map->dims[d];
+
+  // start from the lexicographic mapping, which is also the fallback
+  map->ranks = (int *) safe_malloc(size*sizeof(int));
+  for (int r = 0; r < size; r++) map->ranks[r] = r;
+  for (int d = 0; d < ndim; d++) map->block[d] = 1;
+
+  int l[QUDA_MAX_DIM];
+  for (int d = 0; d < ndim; d++) {
+    if (map->X[d] > 0 && map->X[d] % map->dims[d])
+      errorQuda("Lattice dimension X[%d] = %d is not divisible by grid dimension %d", d, map->X[d], map->dims[d]);
+    l[d] = map->X[d] > 0 ? map->X[d] / map->dims[d] : 1;
+  }
+
+  // group the ranks by host, in order of first appearance
+  char *hostname_recv_buf = (char *)safe_malloc(128*size);
+  comm_gather_hostname(hostname_recv_buf);
+
+  std::vector<std::vector<int> > node_ranks;
+  for (int r = 0; r < size; r++) {
+    size_t node = 0;
+    while (node < node_ranks.size() &&
+           strncmp(&hostname_recv_buf[128*r], &hostname_recv_buf[128*node_ranks[node][0]], 128)) node++;
+    if (node == node_ranks.size()) node_ranks.push_back(std::vector<int>());
+    node_ranks[node].push_back(r);
+  }
+
+  host_free(hostname_recv_buf);
+
+  const int n = node_ranks[0].size();
+  for (auto &node : node_ranks) {
+    if ((int)node.size() != n) {
+      warningQuda("Nodes hold different numbers of ranks, using lexicographic rank mapping");
+      return;
+    }
+  }
+
+  int block[QUDA_MAX_DIM], best[QUDA_MAX_DIM];
+  double best_surface = std::numeric_limits<double>::max();
+  node_block_search(0, ndim, map->dims, l, n, block, best, best_surface);
+  if (best_surface == std::numeric_limits<double>::max()) {
+    warningQuda("No block of %d ranks tiles the process grid, using lexicographic rank mapping", n);
+    return;
+  }
+
+  int node_dims[QUDA_MAX_DIM];
+  for (int d = 0; d < ndim; d++) {
+    map->block[d] = best[d];
+    node_dims[d] = map->dims[d] / best[d];
+  }
+
+  int x[QUDA_MAX_DIM];
+  for (int d = 0; d < QUDA_MAX_DIM; d++) x[d] = 0;
+
+  do {
+    int node_x[QUDA_MAX_DIM], local_x[QUDA_MAX_DIM];
+    for (int d = 0; d < ndim; d++) {
+      node_x[d] = x[d] / best[d];
+      local_x[d] = x[d] % best[d];
+    }
+    map->ranks[index(ndim, map->dims, x)] = node_ranks[index(ndim, node_dims, node_x)][index(ndim, best, local_x)];
+  } while (advance_coords(ndim, map->dims, x));
+
+  if (getVerbosity() >= QUDA_VERBOSE) {
+    char shape[64] = "";
+    for (int d = 0; d < ndim; d++)
+      snprintf(shape + strlen(shape), sizeof(shape) - strlen(shape), d ? "x%d" : "%d", best[d]);
+    printfQuda("Node-aware rank mapping: %lu nodes with %d ranks each in %s blocks\n", node_ranks.size(), n, shape);
+  }
+}
+
+
+int comm_node_rank_from_coords(const int *coords, void *fdata)
+{
+  CommNodeMap *map = static_cast<CommNodeMap *>(fdata);
+  if (!map->ranks) comm_node_map_build(map);
+  return map->ranks[index(map->ndim, map->dims, coords)];
+}
+
+
+void comm_node_map_free(CommNodeMap *map)
+{
+  if (map->ranks) host_free(map->ranks);
+  map->ranks = NULL;
+}
+
+
 static bool peer2peer_enabled[2][4] = { {false,false,false,false},
                                         {false,false,false,false} };
 static bool peer2peer_init = false;
@@ -451,7 +591,7 @@ MsgHandle *comm_declare_send_relative_(const char *func, const char *file, int l
   int disp[QUDA_MAX_DIM] = {0};
   disp[dim] = dir;
 
-  return comm_declare_send_displaced(buffer, disp, nbytes);
+  return comm_stats_declare(comm_declare_send_displaced(buffer, disp, nbytes), dim, dir, 1, nbytes);
 }
 
 /**
@@ -486,7 +626,7 @@ MsgHandle *comm_declare_receive_relative_(const char *func, const char *file, in
   int disp[QUDA_MAX_DIM] = {0};
   disp[dim] = dir;
 
-  return comm_declare_receive_displaced(buffer, disp, nbytes);
+  return comm_stats_declare(comm_declare_receive_displaced(buffer, disp, nbytes), dim, dir, 0, nbytes);
 }
 
 /**
@@ -528,7 +668,8 @@ MsgHandle *comm_declare_strided_send_relative_(const char *func, const char *fil
   int disp[QUDA_MAX_DIM] = {0};
   disp[dim] = dir;
 
-  return comm_declare_strided_send_displaced(buffer, disp, blksize, nblocks, stride);
+  return comm_stats_declare(comm_declare_strided_send_displaced(buffer, disp, blksize, nblocks, stride),
+			    dim, dir, 1, blksize*nblocks);
 }
 
 
@@ -567,7 +708,177 @@ MsgHandle *comm_declare_strided_receive_relative_(const char *func, const char *
   int disp[QUDA_MAX_DIM] = {0};
   disp[dim] = dir;
 
-  return comm_declare_strided_receive_displaced(buffer, disp, blksize, nblocks, stride);
+  return comm_stats_declare(comm_declare_strided_receive_displaced(buffer, disp, blksize, nblocks, stride),
+			    dim, dir, 0, blksize*nblocks);
+}
+
+static bool comm_stats_init = false;
+static bool comm_stats_on = false;
+
+bool comm_stats_enabled(void)
+{
+  if (!comm_stats_init) {
+    char *enable_stats_env = getenv("QUDA_ENABLE_COMM_STATS");
+    comm_stats_on = (enable_stats_env && strcmp(enable_stats_env, "1") == 0);
+    comm_stats_init = true;
+  }
+  return comm_stats_on;
+}
+
+double comm_wtime(void)
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double> >(steady_clock::now().time_since_epoch()).count();
+}
+
+double comm_stats_clock(void) { return comm_stats_enabled() ? comm_wtime() : 0.0; }
+
+// counters of the handles that are currently declared
+static std::vector<CommMsgStats*> *live_stats = NULL;
+
+// accumulated counters of freed handles, indexed by [dim][dir][send]
+static CommMsgStats retired_stats[QUDA_MAX_DIM][2][2];
+
+// span of the messages started since the last window reset
+static double window_start = 0.0;
+static double window_end = 0.0;
+static bool window_started = false;
+static bool window_completed = false;
+
+void comm_stats_clear(CommMsgStats *stats)
+{
+  if (!stats) return;
+  memset(stats, 0, sizeof(CommMsgStats));
+  stats->dim = -1;
+}
+
+MsgHandle *comm_stats_declare(MsgHandle *mh, int dim, int dir, int send, size_t bytes)
+{
+  CommMsgStats *stats = mh ? comm_msg_stats(mh) : NULL;
+  if (!stats) return mh;
+
+  comm_stats_clear(stats);
+  stats->dim = dim;
+  stats->dir = dir > 0 ? 1 : 0;
+  stats->send = send;
+  stats->bytes = bytes;
+
+  if (comm_stats_enabled()) {
+    if (!live_stats) live_stats = new std::vector<CommMsgStats*>;
+    live_stats->push_back(stats);
+  }
+  return mh;
+}
+
+static inline void comm_stats_complete(CommMsgStats *stats, double now)
+{
+  if (!stats->in_flight) return;
+  stats->complete_time = now;
+  stats->flight_time += now - stats->start_time;
+  stats->in_flight = 0;
+  if (window_started) {
+    window_end = std::max(window_end, now);
+    window_completed = true;
+  }
+}
+
+void comm_stats_start(CommMsgStats *stats)
+{
+  if (!stats || !comm_stats_enabled()) return;
+  double now = comm_wtime();
+  stats->messages++;
+  stats->start_time = now;
+  stats->in_flight = 1;
+  if (!window_started) {
+    window_start = now;
+    window_started = true;
+  }
+}
+
+void comm_stats_wait(CommMsgStats *stats, double wait_start)
+{
+  if (!stats || !comm_stats_enabled()) return;
+  double now = comm_wtime();
+  stats->wait_time += now - wait_start;
+  comm_stats_complete(stats, now);
+}
+
+void comm_stats_query(CommMsgStats *stats, int complete)
+{
+  if (!stats || !comm_stats_enabled()) return;
+  stats->polls++;
+  if (complete) comm_stats_complete(stats, comm_wtime());
+}
+
+static void comm_stats_accumulate(CommMsgStats &sum, const CommMsgStats &stats)
+{
+  sum.messages += stats.messages;
+  sum.polls += stats.polls;
+  sum.bytes += stats.messages * stats.bytes; // total bytes moved
+  sum.flight_time += stats.flight_time;
+  sum.wait_time += stats.wait_time;
+}
+
+void comm_stats_free(CommMsgStats *stats)
+{
+  if (!stats || !live_stats) return;
+  auto it = std::find(live_stats->begin(), live_stats->end(), stats);
+  if (it == live_stats->end()) return;
+  live_stats->erase(it);
+  if (stats->dim >= 0) comm_stats_accumulate(retired_stats[stats->dim][stats->dir][stats->send], *stats);
+}
+
+void comm_stats_window_reset(void)
+{
+  window_started = false;
+  window_completed = false;
+  window_start = 0.0;
+  window_end = 0.0;
+}
+
+bool comm_stats_window(double *first_start, double *last_complete)
+{
+  *first_start = window_start;
+  *last_complete = window_end;
+  return window_completed;
+}
+
+void comm_stats_report(void)
+{
+  if (!comm_stats_enabled()) return;
+
+  CommMsgStats total[QUDA_MAX_DIM][2][2];
+  memcpy(total, retired_stats, sizeof(total));
+  if (live_stats) {
+    for (auto stats : *live_stats)
+      if (stats->dim >= 0) comm_stats_accumulate(total[stats->dim][stats->dir][stats->send], *stats);
+  }
+
+  // sum over ranks: messages, polls, bytes, flight time and wait time
+  const int n = QUDA_MAX_DIM*2*2;
+  double sum[5*n];
+  for (int i=0; i<n; i++) {
+    const CommMsgStats &t = (&total[0][0][0])[i];
+    sum[5*i+0] = t.messages;
+    sum[5*i+1] = t.polls;
+    sum[5*i+2] = t.bytes;
+    sum[5*i+3] = t.flight_time;
+    sum[5*i+4] = t.wait_time;
+  }
+  comm_allreduce_array(sum, 5*n);
+
+  printfQuda("Communication summary over %d ranks (per dim/dir, send and receive handles)\n", comm_size());
+  printfQuda("  dim dir    type     messages        MiB   avg KiB  avg flight (us)  avg wait (us)  polls/msg\n");
+  for (int d=0; d<QUDA_MAX_DIM; d++) {
+    for (int dir=0; dir<2; dir++) {
+      for (int send=1; send>=0; send--) {
+	const double *t = sum + 5*((d*2 + dir)*2 + send);
+	if (t[0] == 0) continue;
+	printfQuda("  %3d %3s %7s %12.0f %10.2f %9.2f %16.2f %14.2f %10.2f\n", d, dir ? "+" : "-", send ? "send" : "recv",
+		   t[0], t[2]/(1024*1024), t[2]/(1024*t[0]), 1e6*t[3]/t[0], 1e6*t[4]/t[0], t[1]/t[0]);
+      }
+    }
+  }
 }
 
 void comm_finalize(void)
@@ -667,6 +978,11 @@ void reduceDouble(double &sum) { if (globalReduce) comm_allreduce(&sum); }
 void reduceDoubleArray(double *sum, const int len)
 { if (globalReduce) comm_allreduce_array(sum, len); }
 
+MsgHandle *reduceDoubleArrayAsync(double *sum, const int len)
+{ return globalReduce ? comm_iallreduce_array(sum, len) : NULL; }
+
+void reduceDoubleArrayWait(MsgHandle *mh) { if (mh) comm_wait_reduction(mh); }
+
 int commDim(int dir) { return comm_dim(dir); }
 
 int commCoords(int dir) { return comm_coord(dir); }
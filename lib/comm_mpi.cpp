@@ -37,6 +37,11 @@ struct MsgHandle_s {
      determine whether we need to free the datatype or not.
    */
   bool custom;
+
+  /**
+     Per-message instrumentation (see comm_stats_enabled)
+   */
+  CommMsgStats stats;
 };
 
 static int rank = -1;
@@ -134,6 +139,11 @@ int comm_gpuid(void)
   return gpuid;
 }
 
+CommMsgStats *comm_msg_stats(MsgHandle *mh)
+{
+  return &(mh->stats);
+}
+
 
 static const int max_displacement = 4;
 
@@ -161,6 +171,7 @@ MsgHandle *comm_declare_send_displaced(void *buffer, const int displacement[], s
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
   MPI_CHECK( MPI_Send_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_WORLD, &(mh->request)) );
   mh->custom = false;
 
@@ -184,6 +195,7 @@ MsgHandle *comm_declare_receive_displaced(void *buffer, const int displacement[]
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
   MPI_CHECK( MPI_Recv_init(buffer, nbytes, MPI_BYTE, rank, tag, MPI_COMM_WORLD, &(mh->request)) );
   mh->custom = false;
 
@@ -208,6 +220,7 @@ MsgHandle *comm_declare_strided_send_displaced(void *buffer, const int displacem
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
 
   // create a new strided MPI type
   MPI_CHECK( MPI_Type_vector(nblocks, blksize, stride, MPI_BYTE, &(mh->datatype)) );
@@ -237,6 +250,7 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
   tag = tag >= 0 ? tag : 2*pow(4*max_displacement,ndim) + tag;
 
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
 
   // create a new strided MPI type
   MPI_CHECK( MPI_Type_vector(nblocks, blksize, stride, MPI_BYTE, &(mh->datatype)) );
@@ -251,6 +265,7 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
 
 void comm_free(MsgHandle *mh)
 {
+  comm_stats_free(&(mh->stats));
   MPI_CHECK(MPI_Request_free(&(mh->request)));
   if (mh->custom) MPI_CHECK(MPI_Type_free(&(mh->datatype)));
   host_free(mh);
@@ -260,12 +275,15 @@ void comm_free(MsgHandle *mh)
 void comm_start(MsgHandle *mh)
 {
   MPI_CHECK( MPI_Start(&(mh->request)) );
+  comm_stats_start(&(mh->stats));
 }
 
 
 void comm_wait(MsgHandle *mh)
 {
+  double wait_start = comm_stats_clock();
   MPI_CHECK( MPI_Wait(&(mh->request), MPI_STATUS_IGNORE) );
+  comm_stats_wait(&(mh->stats), wait_start);
 }
 
 
@@ -273,6 +291,7 @@ int comm_query(MsgHandle *mh)
 {
   int query;
   MPI_CHECK( MPI_Test(&(mh->request), &query, MPI_STATUS_IGNORE) );
+  comm_stats_query(&(mh->stats), query);
 
   return query;
 }
@@ -301,6 +320,24 @@ void comm_allreduce_array(double* data, size_t size)
   delete []recvbuf;
 }
 
+MsgHandle *comm_iallreduce_array(double* data, size_t size)
+{
+  MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
+  MPI_CHECK( MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &(mh->request)) );
+  mh->custom = false;
+
+  return mh;
+}
+
+
+void comm_wait_reduction(MsgHandle *mh)
+{
+  // the request is not persistent, so MPI_Wait releases it
+  MPI_CHECK( MPI_Wait(&(mh->request), MPI_STATUS_IGNORE) );
+  host_free(mh);
+}
+
 
 void comm_allreduce_int(int* data)
 {
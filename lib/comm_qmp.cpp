@@ -12,6 +12,7 @@
 struct MsgHandle_s {
   QMP_msgmem_t mem;
   QMP_msghandle_t handle;
+  CommMsgStats stats; // per-message instrumentation
 };
 
 static int gpuid = -1;
@@ -142,6 +143,11 @@ int comm_gpuid(void)
   return gpuid;
 }
 
+CommMsgStats *comm_msg_stats(MsgHandle *mh)
+{
+  return &(mh->stats);
+}
+
 
 /**
  * Declare a message handle for sending to a node displaced in (x,y,z,t) according to "displacement"
@@ -152,6 +158,7 @@ MsgHandle *comm_declare_send_displaced(void *buffer, const int displacement[], s
 
   int rank = comm_rank_displaced(topo, displacement);
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
 
   mh->mem = QMP_declare_msgmem(buffer, nbytes);
   if (mh->mem == NULL) errorQuda("Unable to allocate QMP message memory");
@@ -171,6 +178,7 @@ MsgHandle *comm_declare_receive_displaced(void *buffer, const int displacement[]
 
   int rank = comm_rank_displaced(topo, displacement);
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
 
   mh->mem = QMP_declare_msgmem(buffer, nbytes);
   if (mh->mem == NULL) errorQuda("Unable to allocate QMP message memory");
@@ -193,6 +201,7 @@ MsgHandle *comm_declare_strided_send_displaced(void *buffer, const int displacem
 
   int rank = comm_rank_displaced(topo, displacement);
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
 
   mh->mem = QMP_declare_strided_msgmem(buffer, blksize, nblocks, stride);
   if (mh->mem == NULL) errorQuda("Unable to allocate QMP message memory");
@@ -214,6 +223,7 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
 
   int rank = comm_rank_displaced(topo, displacement);
   MsgHandle *mh = (MsgHandle *)safe_malloc(sizeof(MsgHandle));
+  comm_stats_clear(&(mh->stats));
 
   mh->mem = QMP_declare_strided_msgmem(buffer, blksize, nblocks, stride);
   if (mh->mem == NULL) errorQuda("Unable to allocate QMP message memory");
@@ -227,6 +237,7 @@ MsgHandle *comm_declare_strided_receive_displaced(void *buffer, const int displa
 
 void comm_free(MsgHandle *mh)
 {
+  comm_stats_free(&(mh->stats));
   QMP_free_msghandle(mh->handle);
   QMP_free_msgmem(mh->mem);
   host_free(mh);
@@ -236,18 +247,23 @@ void comm_free(MsgHandle *mh)
 void comm_start(MsgHandle *mh)
 {
   QMP_CHECK( QMP_start(mh->handle) );
+  comm_stats_start(&(mh->stats));
 }
 
 
 void comm_wait(MsgHandle *mh)
 {
+  double wait_start = comm_stats_clock();
   QMP_CHECK( QMP_wait(mh->handle) );
+  comm_stats_wait(&(mh->stats), wait_start);
 }
 
 
 int comm_query(MsgHandle *mh)
 {
-  return (QMP_is_complete(mh->handle) == QMP_TRUE);
+  int query = (QMP_is_complete(mh->handle) == QMP_TRUE);
+  comm_stats_query(&(mh->stats), query);
+  return query;
 }
 
 
@@ -268,6 +284,19 @@ void comm_allreduce_array(double* data, size_t size)
   QMP_CHECK( QMP_sum_double_array(data, size) );
 }
 
+/**
+   QMP has no non-blocking reductions, so we reduce eagerly and the
+   wait is a no-op.
+ */
+MsgHandle *comm_iallreduce_array(double* data, size_t size)
+{
+  QMP_CHECK( QMP_sum_double_array(data, size) );
+  return NULL;
+}
+
+
+void comm_wait_reduction(MsgHandle *mh) {}
+
 
 void comm_allreduce_int(int* data)
 {
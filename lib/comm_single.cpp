@@ -22,6 +22,8 @@ int comm_size(void) { return 1; }
 
 int comm_gpuid(void) { return 0; }
 
+CommMsgStats *comm_msg_stats(MsgHandle *mh) { return NULL; }
+
 void comm_gather_hostname(char *hostname_recv_buf) {
   strncpy(hostname_recv_buf, comm_hostname(), 128);
 }
@@ -58,6 +60,10 @@ void comm_allreduce_max(double* data) {}
 
 void comm_allreduce_array(double* data, size_t size) {}
 
+MsgHandle *comm_iallreduce_array(double* data, size_t size) { return NULL; }
+
+void comm_wait_reduction(MsgHandle *mh) {}
+
 void comm_allreduce_int(int* data) {}
 
 void comm_allreduce_xor(uint64_t *data) {}
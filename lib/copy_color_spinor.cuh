@@ -118,13 +118,17 @@ namespace quda {
     }
   };
 
-  /** CPU function to reorder spinor fields.  */
+  /** CPU function to reorder spinor fields.  The site loop is statically
+      partitioned over the host threads, using the same partition of
+      volumeCB for each parity. */
   template <typename FloatOut, typename FloatIn, int Ns, int Nc, typename Arg, typename Basis>
   void copyColorSpinor(Arg &arg, const Basis &basis) {
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
+#pragma omp parallel num_threads(getOmpThreads())
     for (int parity = 0; parity<arg.nParity; parity++) {
+#pragma omp for schedule(static) nowait
       for (int x=0; x<arg.volumeCB; x++) {
 	ColorSpinor<RegTypeIn, Nc, Ns> in = arg.in(x, (parity+arg.inParity)&1);
 	ColorSpinor<RegTypeOut, Nc, Ns> out;
@@ -17,42 +17,78 @@ namespace quda {
     int geometry;
     int out_offset;
     int in_offset;
+    GaugeChecksumStream *checksum; // if set, stream the checksum of the input links (CPU only)
     CopyGaugeArg(const OutOrder &out, const InOrder &in, int volume, 
 		 const int *faceVolumeCB, int nDim, int geometry) 
       : out(out), in(in), volume(volume), nDim(nDim), geometry(geometry),
-	out_offset(0), in_offset(0) {
+	out_offset(0), in_offset(0), checksum(nullptr) {
       for (int d=0; d<nDim; d++) this->faceVolumeCB[d] = faceVolumeCB[d];
     }
   };
 
   /**
-     Generic CPU gauge reordering and packing 
+     XOR checksum of the 64-bit words of a link, matching Matrix::checksum
+  */
+  template <int length, typename Float>
+  inline uint64_t linkChecksum(const Float v[length]) {
+    constexpr int n = (length*sizeof(Float) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    const uint64_t *base = reinterpret_cast<const uint64_t*>(static_cast<const void*>(v));
+    uint64_t checksum = base[0];
+    for (int i=1; i<n; i++) checksum ^= base[i];
+    return checksum;
+  }
+
+  /**
+     Generic CPU gauge reordering and packing.  The site loop is
+     statically partitioned over the host threads, with every (parity,
+     dimension) pass using the same partition of volumeCB, so each
+     thread always touches the same portion of the fields, which keeps
+     the accesses local to the NUMA domain that first touched them.
+     If arg.checksum is set, the checksum of the input links is folded
+     in as they are read.
   */
   template <typename FloatOut, typename FloatIn, int length, typename OutOrder, typename InOrder>
   void copyGauge(CopyGaugeArg<OutOrder,InOrder> arg) {  
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
-    for (int parity=0; parity<2; parity++) {
+#pragma omp parallel num_threads(getOmpThreads())
+    {
+      uint64_t checksum[2][QUDA_MAX_GEOMETRY] = { };
 
-      for (int d=0; d<arg.geometry; d++) {
-	for (int x=0; x<arg.volume/2; x++) {
+      for (int parity=0; parity<2; parity++) {
+
+	for (int d=0; d<arg.geometry; d++) {
+#pragma omp for schedule(static) nowait
+	  for (int x=0; x<arg.volume/2; x++) {
 #ifdef FINE_GRAINED_ACCESS
-	  for (int i=0; i<Ncolor(length); i++)
-	    for (int j=0; j<Ncolor(length); j++) {
-	      arg.out(d, parity, x, i, j) = arg.in(d, parity, x, i, j);
-	    }
+	    for (int i=0; i<Ncolor(length); i++)
+	      for (int j=0; j<Ncolor(length); j++) {
+		arg.out(d, parity, x, i, j) = arg.in(d, parity, x, i, j);
+	      }
 #else
-	  RegTypeIn in[length];
-	  RegTypeOut out[length];
-	  arg.in.load(in, x, d, parity);
-	  for (int i=0; i<length; i++) out[i] = in[i];
-	  arg.out.save(out, x, d, parity);
+	    RegTypeIn in[length];
+	    RegTypeOut out[length];
+	    arg.in.load(in, x, d, parity);
+	    if (arg.checksum) checksum[parity][d] ^= linkChecksum<length>(in);
+	    for (int i=0; i<length; i++) out[i] = in[i];
+	    arg.out.save(out, x, d, parity);
 #endif
+	  }
 	}
+
       }
 
+      if (arg.checksum) {
+#pragma omp critical
+	for (int parity=0; parity<2; parity++)
+	  for (int d=0; d<arg.geometry; d++) arg.checksum->partial[parity*arg.geometry + d] ^= checksum[parity][d];
+      }
     }
+
+#ifndef FINE_GRAINED_ACCESS
+    if (arg.checksum) arg.checksum->complete = true;
+#endif
   }
 
   /**
@@ -125,9 +161,11 @@ namespace quda {
     typedef typename mapper<FloatIn>::type RegTypeIn;
     typedef typename mapper<FloatOut>::type RegTypeOut;
 
+#pragma omp parallel num_threads(getOmpThreads())
     for (int parity=0; parity<2; parity++) {
 
       for (int d=0; d<arg.nDim; d++) {
+#pragma omp for schedule(static) nowait
 	for (int x=0; x<arg.faceVolumeCB[d]; x++) {
 #ifdef FINE_GRAINED_ACCESS
 	  for (int i=0; i<Ncolor(length); i++)
@@ -262,6 +300,12 @@ namespace quda {
 #endif
 
       if (type == 0 || type == 2) {
+	// stream the checksum if requested and the input links are stored as is
+	if (in.ChecksumStream() && !in.isNative() && in.Reconstruct() == QUDA_RECONSTRUCT_NO &&
+	    length == 2*in.Ncolor()*in.Ncolor()) {
+	  arg.checksum = in.ChecksumStream();
+	  *arg.checksum = GaugeChecksumStream();
+	}
 	copyGauge<FloatOut, FloatIn, length>(arg);
       }
 #ifdef MULTI_GPU // only copy the ghost zone if doing multi-gpu
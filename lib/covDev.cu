@@ -3,6 +3,7 @@
 #include <color_spinor_field_order.h>
 #include <index_helper.cuh>
 #include <stencil.h>
+#include <stencil_index.h>
 #include <color_spinor.h>
 
 /**
@@ -31,12 +32,14 @@ namespace quda {
     const int commDim[4]; // whether a given dimension is partitioned or not
     const int volumeCB;   // checkerboarded volume
     const int mu;         // direction of the covariant derivative
+    const int *nbr;       // precomputed neighbor table (host fields only)
 
     CovDevArg(ColorSpinorField &out, const ColorSpinorField &in, const GaugeField &U, const int parity, const int mu)
       : out(out), in(in), U(U), parity(parity), mu(mu), nParity(in.SiteSubset()), nFace(1),
 	dim{ (3-nParity) * in.X(0), in.X(1), in.X(2), in.X(3), 1 },
       commDim{comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3)},
-      volumeCB(in.VolumeCB())
+      volumeCB(in.VolumeCB()),
+      nbr(in.Location() == QUDA_CPU_FIELD_LOCATION ? getStencilIndex(dim, 4, QUDA_4D_PC, 1, nFace, commDim).Index() : nullptr)
     {
       if (!U.isNative())
       errorQuda("Unsupported field order colorspinor=%d gauge=%d combination\n", in.FieldOrder(), U.FieldOrder());
@@ -53,26 +56,24 @@ namespace quda {
      @param[in] parity The site parity
      @param[in] x_cb The checkerboarded site index
    */
-  template <typename Float, int nDim, int nColor, int mu, typename Vector, typename Arg>
+  template <typename Float, int nDim, int nColor, int mu, bool table, typename Vector, typename Arg>
   __device__ __host__ inline void applyCovDev(Vector &out, Arg &arg, int x_cb, int parity) {
     typedef Matrix<complex<Float>,nColor> Link;
     const int their_spinor_parity = (arg.nParity == 2) ? 1-parity : 0;
 
-    int coord[5];
-    getCoords(coord, x_cb, arg.dim, parity);
-    coord[4] = 0;
+    int coord[5] = { };
+    if (!table) getCoords(coord, x_cb, arg.dim, parity);
 
     const int d = mu%4;
+    bool ghost;
 
     if (mu < 4) {
       //Forward gather - compute fwd offset for vector fetch
-      const int fwd_idx = linkIndexP1(coord, arg.dim, d);
-
-      if ( arg.commDim[d] && (coord[d] + arg.nFace >= arg.dim[d]) ) {
-	const int ghost_idx = ghostFaceIndex<1>(coord, arg.dim, d, arg.nFace);
+      const int fwd_idx = stencilNeighbor<1,table>(ghost, coord, arg, d, x_cb, parity);
 
+      if (ghost) {
 	const Link U = arg.U(d, x_cb, parity);
-	const Vector in = arg.in.Ghost(d, 1, ghost_idx, their_spinor_parity);
+	const Vector in = arg.in.Ghost(d, 1, fwd_idx, their_spinor_parity);
 
 	out += U * in;
       } else {
@@ -84,19 +85,16 @@ namespace quda {
       }
     } else {
       //Backward gather - compute back offset for spinor and gauge fetch
-      const int back_idx = linkIndexM1(coord, arg.dim, d);
-      const int gauge_idx = back_idx;
-
-      if ( arg.commDim[d] && (coord[d] - arg.nFace < 0) ) {
-	const int ghost_idx = ghostFaceIndex<0>(coord, arg.dim, d, arg.nFace);
+      const int back_idx = stencilNeighbor<0,table>(ghost, coord, arg, d, x_cb, parity);
 
-	const Link U = arg.U.Ghost(d, ghost_idx, 1-parity);
-	const Vector in = arg.in.Ghost(d, 0, ghost_idx, their_spinor_parity);
+      if (ghost) {
+	const Link U = arg.U.Ghost(d, back_idx, 1-parity);
+	const Vector in = arg.in.Ghost(d, 0, back_idx, their_spinor_parity);
 
 	out += conj(U) * in;
       } else {
 	
-	const Link U = arg.U(d, gauge_idx, 1-parity);
+	const Link U = arg.U(d, back_idx, 1-parity);
 	const Vector in = arg.in(back_idx, their_spinor_parity);
 
 	out += conj(U) * in;
@@ -107,21 +105,21 @@ namespace quda {
 
 
   //out(x) = M*in
-  template <typename Float, int nDim, int nSpin, int nColor, typename Arg>
+  template <typename Float, int nDim, int nSpin, int nColor, bool table, typename Arg>
   __device__ __host__ inline void covDev(Arg &arg, int x_cb, int parity)
   {
     typedef ColorSpinor<Float,nColor,nSpin> Vector;
     Vector out;
 
     switch (arg.mu) {
-    case 0: applyCovDev<Float,nDim,nColor,0>(out, arg, x_cb, parity); break;
-    case 1: applyCovDev<Float,nDim,nColor,1>(out, arg, x_cb, parity); break;
-    case 2: applyCovDev<Float,nDim,nColor,2>(out, arg, x_cb, parity); break;
-    case 3: applyCovDev<Float,nDim,nColor,3>(out, arg, x_cb, parity); break;
-    case 4: applyCovDev<Float,nDim,nColor,4>(out, arg, x_cb, parity); break;
-    case 5: applyCovDev<Float,nDim,nColor,5>(out, arg, x_cb, parity); break;
-    case 6: applyCovDev<Float,nDim,nColor,6>(out, arg, x_cb, parity); break;
-    case 7: applyCovDev<Float,nDim,nColor,7>(out, arg, x_cb, parity); break;
+    case 0: applyCovDev<Float,nDim,nColor,0,table>(out, arg, x_cb, parity); break;
+    case 1: applyCovDev<Float,nDim,nColor,1,table>(out, arg, x_cb, parity); break;
+    case 2: applyCovDev<Float,nDim,nColor,2,table>(out, arg, x_cb, parity); break;
+    case 3: applyCovDev<Float,nDim,nColor,3,table>(out, arg, x_cb, parity); break;
+    case 4: applyCovDev<Float,nDim,nColor,4,table>(out, arg, x_cb, parity); break;
+    case 5: applyCovDev<Float,nDim,nColor,5,table>(out, arg, x_cb, parity); break;
+    case 6: applyCovDev<Float,nDim,nColor,6,table>(out, arg, x_cb, parity); break;
+    case 7: applyCovDev<Float,nDim,nColor,7,table>(out, arg, x_cb, parity); break;
     }
     arg.out(x_cb, parity) = out;
   }
@@ -135,8 +133,9 @@ namespace quda {
       // for full fields then set parity from loop else use arg setting
       parity = (arg.nParity == 2) ? parity : arg.parity;
 
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
       for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-	covDev<Float,nDim,nSpin,nColor>(arg, x_cb, parity);
+	covDev<Float,nDim,nSpin,nColor,true>(arg, x_cb, parity);
       } // 4-d volumeCB
     } // parity
 
@@ -154,7 +153,7 @@ namespace quda {
     if (x_cb >= arg.volumeCB) return;
     if (parity >= arg.nParity) return;
 
-    covDev<Float,nDim,nSpin,nColor>(arg, x_cb, parity);
+    covDev<Float,nDim,nSpin,nColor,false>(arg, x_cb, parity);
   }
 
   template <typename Float, int nDim, int nSpin, int nColor, typename Arg>
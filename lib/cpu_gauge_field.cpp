@@ -376,7 +376,16 @@ namespace quda {
   }
 
   void cpuGaugeField::zero() {
-    memset(gauge, 0, bytes);
+    if (order == QUDA_QDP_GAUGE_ORDER) {
+      // QDP-ordered fields are stored as one allocation per link direction
+      int siteDim = 1;
+      if (geometry == QUDA_VECTOR_GEOMETRY) siteDim = nDim;
+      else if (geometry == QUDA_TENSOR_GEOMETRY) siteDim = nDim * (nDim-1) / 2;
+      else if (geometry == QUDA_COARSE_GEOMETRY) siteDim = 2*nDim;
+      for (int d=0; d<siteDim; d++) memset(gauge[d], 0, (size_t)volume * nInternal * precision);
+    } else {
+      memset(gauge, 0, bytes);
+    }
   }
 
 /*template <typename Float>
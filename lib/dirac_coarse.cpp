@@ -4,13 +4,13 @@
 
 namespace quda {
 
-  DiracCoarse::DiracCoarse(const DiracParam &param, bool enable_gpu)
+  DiracCoarse::DiracCoarse(const DiracParam &param, bool enable_gpu, bool compute)
     : Dirac(param), mu(param.mu), mu_factor(param.mu_factor), transfer(param.transfer), dirac(param.dirac),
       Y_h(nullptr), X_h(nullptr), Xinv_h(nullptr), Yhat_h(nullptr),
       Y_d(nullptr), X_d(nullptr), Xinv_d(nullptr), Yhat_d(nullptr),
       enable_gpu(enable_gpu), init(true)
   {
-    initializeCoarse();
+    initializeCoarse(compute);
   }
 
   DiracCoarse::DiracCoarse(const DiracParam &param,
@@ -47,7 +47,7 @@ namespace quda {
     }
   }
 
-  void DiracCoarse::initializeCoarse()
+  void DiracCoarse::initializeCoarse(bool compute)
   {
     QudaPrecision prec = transfer->Vectors().Precision();
     int ndim = transfer->Vectors().Ndim();
@@ -108,6 +108,11 @@ namespace quda {
       Xinv_d = new cudaGaugeField(gParam);
     }
 
+    if (compute) computeCoarse();
+  }
+
+  void DiracCoarse::computeCoarse()
+  {
     bool gpu_setup = true;
 
     if (enable_gpu && gpu_setup) dirac->createCoarseOp(*Y_d,*X_d,*Xinv_d,*Yhat_d,*transfer,kappa,Mu(),MuFactor());
@@ -120,15 +125,41 @@ namespace quda {
 	X_h->copy(*X_d);
 	Xinv_h->copy(*Xinv_d);
       } else {
-	Y_d->copy(*Y_h);
-	Yhat_d->copy(*Yhat_h);
-	X_d->copy(*X_h);
-	Xinv_d->copy(*Xinv_h);
+	uploadCoarse();
       }
     }
 
   }
 
+  void DiracCoarse::uploadCoarse()
+  {
+    if (!enable_gpu) return;
+    Y_d->copy(*Y_h);
+    Yhat_d->copy(*Yhat_h);
+    X_d->copy(*X_h);
+    Xinv_d->copy(*Xinv_h);
+  }
+
+  void DiracCoarse::updateCoarse(const Dirac &dirac)
+  {
+    if (!init) errorQuda("Coarse fields can only be updated through the operator that allocated them");
+    this->dirac = &dirac;
+
+    // the coarse links are accumulated into, so start from zero
+    Y_h->zero();
+    X_h->zero();
+    Xinv_h->zero();
+    Yhat_h->zero();
+    if (enable_gpu) {
+      Y_d->zero();
+      X_d->zero();
+      Xinv_d->zero();
+      Yhat_d->zero();
+    }
+
+    computeCoarse();
+  }
+
   void DiracCoarse::Clover(ColorSpinorField &out, const ColorSpinorField &in, const QudaParity parity) const
   {
     if (&in == &out) errorQuda("Fields cannot alias");
@@ -361,31 +361,150 @@ namespace quda {
     }
   }
 
+  /**
+     Applies the coarse operator at a given parity and checkerboard
+     site index to a block of right-hand sides at once.  This is the
+     host variant of coarseDslash: rather than re-reading the Y and X
+     links for every source, each link element is loaded once and then
+     applied to all nSrc vectors in [src_begin, src_begin+nSrc).
+
+     @param arg Kernel argument struct
+     @param x_cb The checkerboarded site index
+     @param src_begin The first fifth-dimension (source) index of the block
+     @param nSrc The number of sources in the block (nSrc <= src_block)
+     @param parity The site parity
+   */
+  template <typename Float, int nDim, int Ns, int Nc, int src_block, bool dslash, bool clover, bool dagger, DslashType type, typename Arg>
+  inline void coarseDslashMultiSrc(Arg &arg, int x_cb, int src_begin, int nSrc, int parity)
+  {
+    const int their_spinor_parity = (arg.nParity == 2) ? 1-parity : 0;
+    const int my_spinor_parity = (arg.nParity == 2) ? parity : 0;
+
+    complex<Float> out[src_block][Ns*Nc];
+    for (int i=0; i<nSrc; i++)
+      for (int row=0; row<Ns*Nc; row++) out[i][row] = 0.0;
+
+    if (dslash) {
+      int coord[5];
+      getCoordsCB(coord, x_cb, arg.dim, arg.X0h, parity);
+      coord[4] = 0; // the links are four dimensional
+
+      // Index of the neighboring spinor of each source.  The bulk is
+      // laid out source by source, while the ghost zone of a 5-d field
+      // has the fifth dimension folded into the face index.
+      int idx[src_block];
+
+      for (int d=0; d<nDim; d++) { // loop over dimension
+
+	//Forward gather - compute fwd offset for spinor fetch
+	const bool fwd_ghost = arg.commDim[d] && (coord[d] + arg.nFace >= arg.dim[d]);
+	if ( fwd_ghost ? doHalo<type>() : doBulk<type>() ) {
+	  const int fwd_idx = fwd_ghost ? 0 : linkIndexP1(coord, arg.dim, d);
+	  for (int i=0; i<nSrc; i++) {
+	    if (fwd_ghost) {
+	      int x[5] = {coord[0], coord[1], coord[2], coord[3], src_begin+i};
+	      idx[i] = ghostFaceIndex<1>(x, arg.dim, d, arg.nFace);
+	    } else {
+	      idx[i] = fwd_idx + (src_begin+i)*arg.volumeCB;
+	    }
+	  }
+
+	  for (int row=0; row<Ns*Nc; row++) { //Color-spin row
+	    for (int s_col=0; s_col<Ns; s_col++) { //Spin column
+	      for (int c_col=0; c_col<Nc; c_col++) { //Color column
+		const complex<Float> Y = arg.Y(dagger ? d : d+4, parity, x_cb, row, s_col*Nc + c_col);
+		for (int i=0; i<nSrc; i++) {
+		  out[i][row] += Y * (fwd_ghost ? arg.inA.Ghost(d, 1, their_spinor_parity, idx[i], s_col, c_col) :
+				      arg.inA(their_spinor_parity, idx[i], s_col, c_col));
+		}
+	      }
+	    }
+	  }
+	}
+
+	//Backward gather - compute back offset for spinor and gauge fetch
+	const bool back_ghost = arg.commDim[d] && (coord[d] - arg.nFace < 0);
+	if ( back_ghost ? doHalo<type>() : doBulk<type>() ) {
+	  // for the ghost this is the 4-d face index of the link
+	  const int back_idx = back_ghost ? ghostFaceIndex<0>(coord, arg.dim, d, arg.nFace) : linkIndexM1(coord, arg.dim, d);
+	  for (int i=0; i<nSrc; i++) {
+	    if (back_ghost) {
+	      int x[5] = {coord[0], coord[1], coord[2], coord[3], src_begin+i};
+	      idx[i] = ghostFaceIndex<0>(x, arg.dim, d, arg.nFace);
+	    } else {
+	      idx[i] = back_idx + (src_begin+i)*arg.volumeCB;
+	    }
+	  }
+
+	  for (int row=0; row<Ns*Nc; row++) { //Color-spin row
+	    for (int s_col=0; s_col<Ns; s_col++) { //Spin column
+	      for (int c_col=0; c_col<Nc; c_col++) { //Color column
+		const int col = s_col*Nc + c_col;
+		const complex<Float> Y = back_ghost ? conj(arg.Y.Ghost(dagger ? d+4 : d, 1-parity, back_idx, col, row)) :
+		  conj(arg.Y(dagger ? d+4 : d, 1-parity, back_idx, col, row));
+		for (int i=0; i<nSrc; i++) {
+		  out[i][row] += Y * (back_ghost ? arg.inA.Ghost(d, 0, their_spinor_parity, idx[i], s_col, c_col) :
+				      arg.inA(their_spinor_parity, idx[i], s_col, c_col));
+		}
+	      }
+	    }
+	  }
+	}
+
+      } // nDim
+
+      for (int i=0; i<nSrc; i++)
+	for (int row=0; row<Ns*Nc; row++) out[i][row] *= -arg.kappa;
+    }
+
+    if (doBulk<type>() && clover) {
+      for (int row=0; row<Ns*Nc; row++) { //Color-spin out
+	for (int s_col=0; s_col<Ns; s_col++) { //Spin in
+	  for (int c_col=0; c_col<Nc; c_col++) { //Color in
+	    //Factor of kappa and diagonal addition now incorporated in X
+	    const int col = s_col*Nc + c_col;
+	    const complex<Float> X = !dagger ? arg.X(0, parity, x_cb, row, col) : conj(arg.X(0, parity, x_cb, col, row));
+	    for (int i=0; i<nSrc; i++)
+	      out[i][row] += X * arg.inB(my_spinor_parity, x_cb+(src_begin+i)*arg.volumeCB, s_col, c_col);
+	  }
+	}
+      }
+    }
+
+    for (int i=0; i<nSrc; i++) {
+      for (int s=0; s<Ns; s++) {
+	for (int c=0; c<Nc; c++) {
+	  // if not halo we just store, else we accumulate
+	  if (doBulk<type>()) arg.out(my_spinor_parity, x_cb+(src_begin+i)*arg.volumeCB, s, c) = out[i][s*Nc+c];
+	  else arg.out(my_spinor_parity, x_cb+(src_begin+i)*arg.volumeCB, s, c) += out[i][s*Nc+c];
+	}
+      }
+    }
+  }
+
   // CPU kernel for applying the coarse Dslash to a vector
   template <typename Float, int nDim, int Ns, int Nc, int Mc, bool dslash, bool clover, bool dagger, DslashType type, typename Arg>
   void coarseDslash(Arg arg)
   {
-    // the fine-grain parameters mean nothing for CPU variant
-    const int color_stride = 1;
-    const int color_offset = 0;
-    const int dim_thread_split = 1;
-    const int dir = 0;
-    const int dim = 0;
-
-    for (int parity= 0; parity < arg.nParity; parity++) {
+    // the fine-grain parameters mean nothing for CPU variant, instead
+    // we block over the fifth dimension so that each link is reused
+    // across src_block right-hand sides per site
+    constexpr int src_block = 8;
+    const int nSrc = arg.dim[4];
+    const int nSrcBlock = (nSrc + src_block - 1) / src_block;
+
+    for (int parity_= 0; parity_ < arg.nParity; parity_++) {
       // for full fields then set parity from loop else use arg setting
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-
-      for (int src_idx = 0; src_idx < arg.dim[4]; src_idx++) {
-	//#pragma omp parallel for
-	for(int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-	  for (int s=0; s<2; s++) {
-	    for (int color_block=0; color_block<Nc; color_block+=Mc) { // Mc=Nc means all colors in a thread
-	      coarseDslash<Float,nDim,Ns,Nc,Mc,color_stride,dim_thread_split,dslash,clover,dagger,type,dir,dim>(arg, x_cb, src_idx, parity, s, color_block, color_offset);
-	    }
-	  }
+      const int parity = (arg.nParity == 2) ? parity_ : arg.parity;
+
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
+      for (int src_block_idx = 0; src_block_idx < nSrcBlock; src_block_idx++) { // src index block
+	for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
+	  const int src_begin = src_block_idx * src_block;
+	  const int n = (nSrc - src_begin < src_block) ? nSrc - src_begin : src_block;
+	  coarseDslashMultiSrc<Float,nDim,Ns,Nc,src_block,dslash,clover,dagger,type>(arg, x_cb, src_begin, n, parity);
 	} // 4-d volumeCB
-      } // src index
+      } // src index block
     } // parity
 
   }
@@ -945,9 +1064,6 @@ namespace quda {
   };
 
   // hooks into tune.cpp variables for policy tuning
-  typedef std::map<TuneKey, TuneParam> map;
-  const map& getTuneCache();
-
   void disableProfileCount();
   void enableProfileCount();
   void setPolicyTuning(bool);
@@ -1016,7 +1132,7 @@ namespace quda {
 
       // before we do policy tuning we must ensure the kernel
       // constituents have been tuned since we can't do nested tuning
-      if (getTuning() && getTuneCache().find(tuneKey()) == getTuneCache().end()) {
+      if (getTuning() && !tuneCacheHit(tuneKey())) {
 	disableProfileCount();
 	for (auto &i : policy) dslash(i);
 	enableProfileCount();
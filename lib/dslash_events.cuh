@@ -10,6 +10,7 @@ namespace dslash {
   extern cudaEvent_t scatterStart[Nstream];
   extern cudaEvent_t scatterEnd[Nstream];
   extern cudaEvent_t dslashStart[2]; // double buffered
+  extern cudaEvent_t interiorEnd; // end of the interior kernel, for overlap accounting
 
   // FIX this is a hack from hell
   // Auxiliary work that can be done while waiting on comms to finis
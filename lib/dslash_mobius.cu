@@ -158,6 +158,7 @@ namespace quda {
 	strcat(key.aux,",Dslash5inv");
 	break;
       }
+      key.rehash();
       return key;
     }
 
@@ -101,6 +101,7 @@ namespace quda {
     {
       TuneKey key = DslashCuda::tuneKey();
       strcat(key.aux,",NdegDslash");
+      key.rehash();
       return key;
     }
 
@@ -1,9 +1,6 @@
 static cudaColorSpinorField *inSpinor;
 
 // hooks into tune.cpp variables for policy tuning
-typedef std::map<TuneKey, TuneParam> map;
-const map& getTuneCache();
-
 void disableProfileCount();
 void enableProfileCount();
 
@@ -250,6 +247,75 @@ namespace {
     return index;
   }
 
+  /**
+     @brief State used to measure how much of the halo exchange of a
+     dslash application is hidden behind its interior kernel.  Only
+     active when QUDA_ENABLE_COMM_STATS=1 and not tuning.  The interior
+     kernel's completion is observed by the host while it polls for
+     comms, so it is resolved to the polling interval.
+  */
+  struct DslashOverlapState {
+    bool active;          // whether this application is being measured
+    bool pending;         // interior kernel launched, but not yet seen complete
+    double interior_done; // host time at which the interior kernel was seen complete (-1 if not yet)
+  };
+
+  static DslashOverlapState overlap = { false, false, -1.0 };
+
+  /**
+     @brief Start measuring the overlap of a dslash application
+   */
+  inline void overlapBegin() {
+    overlap.active = comm_stats_enabled() && !activeTuning();
+    overlap.pending = false;
+    overlap.interior_done = -1.0;
+    if (overlap.active) comm_stats_window_reset();
+  }
+
+  /**
+     @brief Mark the end of the interior kernel on the compute stream
+   */
+  inline void overlapInterior() {
+    if (!overlap.active) return;
+    qudaEventRecord(dslash::interiorEnd, streams[Nstream-1]);
+    overlap.pending = true;
+  }
+
+  /**
+     @brief Check (without blocking) whether the interior kernel has completed
+   */
+  inline void overlapPoll() {
+    if (overlap.pending && qudaEventQuery(dslash::interiorEnd) == cudaSuccess) {
+      overlap.interior_done = comm_wtime();
+      overlap.pending = false;
+    }
+  }
+
+  /**
+     @brief Finish measuring the overlap of a dslash application and
+     accumulate it for the given policy
+   */
+  inline void overlapEnd(const char *policy) {
+    if (!overlap.active) return;
+    overlap.active = false;
+
+    double first_start, last_complete;
+    if (!comm_stats_window(&first_start, &last_complete)) return; // no halo exchange
+
+    // interior kernel not marked (e.g., launched from a helper thread)
+    if (!overlap.pending && overlap.interior_done < 0.0) return;
+
+    if (overlap.pending) { // never seen complete while polling, so bound it from above
+      cudaEventSynchronize(dslash::interiorEnd);
+      overlap.interior_done = comm_wtime();
+      overlap.pending = false;
+    }
+
+    double window = last_complete - first_start;
+    double exposed = last_complete - std::max(first_start, overlap.interior_done);
+    recordDslashOverlap(policy, window, std::max(exposed, 0.0));
+  }
+
   /**
      @brief Wrapper for querying if communication is finished in the
      dslash, and if it is take the appropriate action:
@@ -283,6 +349,8 @@ namespace {
 
     cudaStream_t *stream = nullptr;
 
+    overlapPoll();
+
     PROFILE(int comms_test = dslash_comms ? in.commsQuery(dslash.Nface()/2, 2*dim+dir, dslash.Dagger(), stream, gdr_send, gdr_recv) : 1, profile, QUDA_PROFILE_COMMS_QUERY);
     if (comms_test) {
       // now we are receive centric
@@ -408,6 +476,7 @@ struct DslashBasic : DslashPolicyImp {
     issueGather(*in, dslash);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     DslashCommsPattern pattern(dslashParam.commDim);
@@ -553,6 +622,7 @@ struct DslashPthreads : DslashPolicyImp {
 
 #if (!defined MULTI_GPU)
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 #endif
 
@@ -660,6 +730,7 @@ struct DslashFusedExterior : DslashPolicyImp {
     issueGather(*in, dslash);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     const int scatterIndex = getStreamIndex(dslashParam);
@@ -735,6 +806,7 @@ struct DslashGDR : DslashPolicyImp {
     issuePack(*in, dslash, 1-dslashParam.parity, static_cast<MemoryLocation>(Device | (Remote*dslashParam.remote_write) ), packIndex);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     bool pack_event = false;
@@ -813,6 +885,7 @@ struct DslashFusedGDR : DslashPolicyImp {
     issuePack(*in, dslash, 1-dslashParam.parity, static_cast<MemoryLocation>(Device | (Remote*dslashParam.remote_write) ), packIndex);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     bool pack_event = false;
@@ -892,6 +965,7 @@ struct DslashGDRRecv : DslashPolicyImp {
     issueGather(*in, dslash);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     DslashCommsPattern pattern(dslashParam.commDim);
@@ -970,6 +1044,7 @@ struct DslashFusedGDRRecv : DslashPolicyImp {
     issueGather(*in, dslash);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     DslashCommsPattern pattern(dslashParam.commDim);
@@ -1059,6 +1134,7 @@ struct DslashAsync : DslashPolicyImp {
     issueGather(*in, dslash);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     DslashCommsPattern pattern(dslashParam.commDim);
@@ -1167,6 +1243,7 @@ struct DslashFusedExteriorAsync : DslashPolicyImp {
     issueGather(*in, dslash);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     const int scatterIndex = getStreamIndex(dslashParam);
@@ -1266,6 +1343,7 @@ struct DslashZeroCopyPack : DslashPolicyImp {
     issuePack(*in, dslash, 1-dslashParam.parity, static_cast<MemoryLocation>(Host | (Remote*dslashParam.remote_write) ), packIndex);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     for (int i=3; i>=0; i--) { // only synchronize if we need to
@@ -1360,6 +1438,7 @@ struct DslashFusedZeroCopyPack : DslashPolicyImp {
     issueRecv(*in, dslash, 0, false); // Prepost receives
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     for (int i=3; i>=0; i--) { // only synchronize if we need to
@@ -1448,6 +1527,7 @@ struct DslashZeroCopyPackGDRRecv : DslashPolicyImp {
     issuePack(*in, dslash, 1-dslashParam.parity, static_cast<MemoryLocation>(Host | (Remote*dslashParam.remote_write) ), packIndex);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     for (int i=3; i>=0; i--) { // only synchronize if we need to
@@ -1533,6 +1613,7 @@ struct DslashFusedZeroCopyPackGDRRecv : DslashPolicyImp {
     issueRecv(*in, dslash, 0, true); // Prepost receives
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     for (int i=3; i>=0; i--) { // only synchronize if we need to
@@ -1613,6 +1694,7 @@ struct DslashZeroCopy : DslashPolicyImp {
     issuePack(*in, dslash, 1-dslashParam.parity, static_cast<MemoryLocation>(Host | (Remote*dslashParam.remote_write) ), packIndex);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     for (int i=3; i>=0; i--) { // only synchronize if we need to
@@ -1700,6 +1782,7 @@ struct DslashFusedZeroCopy : DslashPolicyImp {
     issuePack(*in, dslash, 1-dslashParam.parity, static_cast<MemoryLocation>(Host | (Remote*dslashParam.remote_write) ), packIndex);
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
     if (aux_worker) aux_worker->apply(streams[Nstream-1]);
 
     for (int i=3; i>=0; i--) { // only synchronize if we need to
@@ -1770,6 +1853,7 @@ struct DslashNC : DslashPolicyImp {
     dslashParam.threads = volume;
 
     PROFILE(if (dslash_interior_compute) dslash.apply(streams[Nstream-1]), profile, QUDA_PROFILE_DSLASH_KERNEL);
+    overlapInterior();
 
     profile.TPSTOP(QUDA_PROFILE_TOTAL);
   }
@@ -1892,6 +1976,28 @@ struct DslashFactory {
     policies[static_cast<std::size_t>(p)] = QudaDslashPolicy::QUDA_DSLASH_POLICY_DISABLED;
   }
 
+  const char *policy_name(QudaDslashPolicy p) {
+    switch (p) {
+    case QudaDslashPolicy::QUDA_DSLASH: return "QUDA_DSLASH";
+    case QudaDslashPolicy::QUDA_FUSED_DSLASH: return "QUDA_FUSED_DSLASH";
+    case QudaDslashPolicy::QUDA_GDR_DSLASH: return "QUDA_GDR_DSLASH";
+    case QudaDslashPolicy::QUDA_FUSED_GDR_DSLASH: return "QUDA_FUSED_GDR_DSLASH";
+    case QudaDslashPolicy::QUDA_GDR_RECV_DSLASH: return "QUDA_GDR_RECV_DSLASH";
+    case QudaDslashPolicy::QUDA_FUSED_GDR_RECV_DSLASH: return "QUDA_FUSED_GDR_RECV_DSLASH";
+    case QudaDslashPolicy::QUDA_ZERO_COPY_PACK_DSLASH: return "QUDA_ZERO_COPY_PACK_DSLASH";
+    case QudaDslashPolicy::QUDA_FUSED_ZERO_COPY_PACK_DSLASH: return "QUDA_FUSED_ZERO_COPY_PACK_DSLASH";
+    case QudaDslashPolicy::QUDA_ZERO_COPY_DSLASH: return "QUDA_ZERO_COPY_DSLASH";
+    case QudaDslashPolicy::QUDA_FUSED_ZERO_COPY_DSLASH: return "QUDA_FUSED_ZERO_COPY_DSLASH";
+    case QudaDslashPolicy::QUDA_ZERO_COPY_PACK_GDR_RECV_DSLASH: return "QUDA_ZERO_COPY_PACK_GDR_RECV_DSLASH";
+    case QudaDslashPolicy::QUDA_FUSED_ZERO_COPY_PACK_GDR_RECV_DSLASH: return "QUDA_FUSED_ZERO_COPY_PACK_GDR_RECV_DSLASH";
+    case QudaDslashPolicy::QUDA_DSLASH_ASYNC: return "QUDA_DSLASH_ASYNC";
+    case QudaDslashPolicy::QUDA_FUSED_DSLASH_ASYNC: return "QUDA_FUSED_DSLASH_ASYNC";
+    case QudaDslashPolicy::QUDA_PTHREADS_DSLASH: return "QUDA_PTHREADS_DSLASH";
+    case QudaDslashPolicy::QUDA_DSLASH_NC: return "QUDA_DSLASH_NC";
+    default: return "QUDA_DSLASH_POLICY_DISABLED";
+    }
+  }
+
  class DslashPolicyTune : public Tunable {
 
    DslashCuda &dslash;
@@ -2027,7 +2133,7 @@ struct DslashFactory {
 
      // before we do policy tuning we must ensure the kernel
      // constituents have been tuned since we can't do nested tuning
-     if (getTuning() && getTuneCache().find(tuneKey()) == getTuneCache().end()) {
+     if (getTuning() && !tuneCacheHit(tuneKey())) {
        disableProfileCount();
 
        for (auto &p2p : p2p_policies) {
@@ -2146,7 +2252,9 @@ struct DslashFactory {
      }
 
      DslashPolicyImp* dslashImp = DslashFactory::create(static_cast<QudaDslashPolicy>(tp.aux.x));
+     overlapBegin();
      (*dslashImp)(dslash, in, volume, ghostFace, profile);
+     overlapEnd(policy_name(p));
      delete dslashImp;
 
      // restore p2p state
@@ -2193,6 +2301,7 @@ struct DslashFactory {
      dslashParam.kernel_type = KERNEL_POLICY;
      TuneKey key = dslash.tuneKey();
      strcat(key.aux,comm_dim_topology_string());
+     key.rehash();
      dslashParam.kernel_type = kernel_type;
      return key;
    }
@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <cstdio>
 #include <string>
+#include <map>
 #include <iostream>
 
 #include <color_spinor_field.h>
@@ -72,6 +73,7 @@ namespace quda {
     cudaEvent_t scatterStart[Nstream];
     cudaEvent_t scatterEnd[Nstream];
     cudaEvent_t dslashStart[2];
+    cudaEvent_t interiorEnd;
 
     // FIX this is a hack from hell
     // Auxiliary work that can be done while waiting on comms to finis
@@ -97,6 +99,7 @@ namespace quda {
       cudaEventCreateWithFlags(&packEnd[i], cudaEventDisableTiming);
       cudaEventCreateWithFlags(&dslashStart[i], cudaEventDisableTiming);
     }
+    cudaEventCreateWithFlags(&interiorEnd, cudaEventDisableTiming);
 #ifdef PTHREADS
     cudaEventCreateWithFlags(&interiorDslashEnd, cudaEventDisableTiming);
 #endif
@@ -135,6 +138,7 @@ namespace quda {
       cudaEventDestroy(packEnd[i]);
       cudaEventDestroy(dslashStart[i]);
     }
+    cudaEventDestroy(interiorEnd);
 #ifdef PTHREADS
     cudaEventDestroy(interiorDslashEnd);
 #endif
@@ -142,6 +146,58 @@ namespace quda {
     checkCudaError();
   }
 
+  struct DslashOverlap {
+    long count;     // number of dslash applications
+    double window;  // total halo-exchange time
+    double exposed; // total halo-exchange time after the interior kernel completed
+  };
+
+  // keyed by policy name, since the policies are instantiated per dslash translation unit
+  static std::map<std::string, DslashOverlap> dslash_overlap;
+
+  void recordDslashOverlap(const char *policy, double window, double exposed)
+  {
+    DslashOverlap &overlap = dslash_overlap[policy];
+    overlap.count++;
+    overlap.window += window;
+    overlap.exposed += exposed;
+  }
+
+  void printDslashOverlap()
+  {
+    if (!comm_stats_enabled()) return;
+
+    // the tuned policy is the same on every rank, so every rank should
+    // hold the same policies in the same order, else the reduction
+    // below would mix up entries: compare a hash of the ordered names
+    // (FNV-1a, truncated to 52 bits so that it is exact as a double)
+    uint64_t hash = 14695981039346656037ull;
+    for (auto &p : dslash_overlap) {
+      for (const char *c = p.first.c_str(); ; c++) { // include the terminator to separate the names
+	hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+	if (*c == '\0') break;
+      }
+    }
+    double hash_max = static_cast<double>(hash & ((1ull << 52) - 1)), hash_min = -hash_max;
+    comm_allreduce_max(&hash_max);
+    comm_allreduce_max(&hash_min);
+    if (hash_max != -hash_min) {
+      warningQuda("Ranks used different dslash policies, skipping overlap report");
+      return;
+    }
+    if (dslash_overlap.size() == 0) return;
+
+    printfQuda("Dslash halo-exchange overlap per policy (averaged over %d ranks)\n", comm_size());
+    printfQuda("  %-44s %10s %16s %16s %9s\n", "policy", "calls", "avg comms (us)", "avg exposed (us)", "overlap");
+    for (auto &p : dslash_overlap) { // std::map iterates in the same order on every rank
+      double sum[3] = { static_cast<double>(p.second.count), p.second.window, p.second.exposed };
+      comm_allreduce_array(sum, 3);
+      if (sum[0] == 0 || sum[1] == 0) continue;
+      printfQuda("  %-44s %10.0f %16.2f %16.2f %8.1f%%\n", p.first.c_str(), sum[0]/comm_size(),
+                 1e6*sum[1]/sum[0], 1e6*sum[2]/sum[0], 100.0*(1.0 - sum[2]/sum[1]));
+    }
+  }
+
   /**
      @brief Parameter structure for driving the Gamma operator
    */
@@ -113,6 +113,7 @@ namespace quda {
       default:
 	errorQuda("Unsupported twisted-dslash type %d", dslashType);
       }
+      key.rehash();
       return key;
     }
 
@@ -12,6 +12,10 @@
 #include <lanczos_quda.h>
 
 #include <iostream>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <Eigen/Dense>
 
 namespace quda {
 
@@ -91,17 +95,261 @@ namespace quda {
     return;
   }
   
-#if 0
   ImpRstLanczos::ImpRstLanczos(RitzMat &ritz_mat, QudaEigParam &eigParam, TimeProfile &profile) :
     Eig_Solver(eigParam, profile), ritz_mat(ritz_mat)
   { }
 
   ImpRstLanczos::~ImpRstLanczos()
-  { }
+  {
+    for (auto w : rotation_work) delete w;
+  }
+
+  void ImpRstLanczos::rotate(cudaColorSpinorField **V, int offset, int n_in, const double *Y, int n_out)
+  {
+    // (re)allocate the work space only if it is too small or does not match the basis
+    if (rotation_work.size() > 0 && (rotation_work[0]->Precision() != V[0]->Precision() ||
+				     rotation_work[0]->Length() != V[0]->Length())) {
+      for (auto w : rotation_work) delete w;
+      rotation_work.clear();
+    }
+
+    if ((int)rotation_work.size() < n_out) {
+      ColorSpinorParam csParam(*V[0]);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      while ((int)rotation_work.size() < n_out) rotation_work.push_back(ColorSpinorField::Create(csParam));
+    }
+
+    std::vector<ColorSpinorField*> x(V + offset, V + offset + n_in), y(rotation_work.begin(), rotation_work.begin() + n_out);
+    for (auto yt : y) blas::zero(*yt);
 
-  void ImpRstLanczos::operator()(double *alpha, double *beta, cudaColorSpinorField **Eig_Vec,
+    // block caxpy coefficients are row major a[i*n_out + t]
+    std::vector<Complex> a(n_in * n_out);
+    for (int i=0; i<n_in; i++)
+      for (int t=0; t<n_out; t++) a[i*n_out + t] = Y[t*n_in + i];
+
+    blas::caxpy(a.data(), x, y);
+
+    for (int t=0; t<n_out; t++) blas::copy(*V[offset+t], *y[t]);
+  }
+
+  void ImpRstLanczos::orthogonalize(cudaColorSpinorField &r, cudaColorSpinorField **V, int begin, int end)
+  {
+    if (end <= begin) return;
+    std::vector<ColorSpinorField*> v(V + begin, V + end), w(1, &r);
+    std::vector<Complex> c(end - begin);
+    blas::cDotProduct(c.data(), v, w);
+    for (auto &ci : c) ci = -ci;
+    blas::caxpy(c.data(), v, w);
+  }
+
+  void ImpRstLanczos::operator()(double *alpha, double *beta, cudaColorSpinorField **V,
 				 cudaColorSpinorField &r, cudaColorSpinorField &Apsi, int k0, int m)
-  { }
-#endif
+  {
+    using namespace blas;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> matrix;
+
+    const int nev = eigParam.nk;
+    const double tol = eigParam.Stp_residual;
+    const int max_restarts = eigParam.max_restarts;
+    if (nev <= 0 || nev > m - 2) errorQuda("Requested %d eigenpairs with a search space of %d", nev, m);
+
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    const double b2 = norm2(r);
+    if (b2 == 0) {
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      printfQuda("Warning: initial residual is already zero\n");
+      return;
+    }
+
+    zero(*V[0]);
+    axpy(1.0/sqrt(b2), r, *V[0]);
+
+    // with a Chebychev polynomial the wanted modes are mapped to its largest eigenvalues
+    const bool largest = ritz_mat.NPoly() > 1;
+
+    const double eps = std::numeric_limits<double>::epsilon();
+    const double ortho_tol = sqrt(eps);
+
+    // projected matrix: diagonal for the kept Ritz values, coupled to
+    // the first new Lanczos vector through s, and tridiagonal beyond
+    std::vector<double> T(m*m, 0.0);
+
+    // estimated inner products between the basis vectors
+    std::vector<double> omega(m*m, eps);
+    for (int i=0; i<m; i++) omega[i*m + i] = 1.0;
+
+    std::vector<double> theta(m), res(m);
+    std::vector<int> order(m);
+
+    int nlock = 0; // converged Ritz vectors at the front of the basis
+    int k = 0;     // vectors kept over the restart (including the locked ones)
+    int restart = 0;
+    long n_op = 0;
+    long n_reorth = 0;
+    double beta_m = 0.0;
+    bool converged = false;
+
+    while (true) {
+
+      // extend the basis from k to m vectors
+      bool reorth_next = false;
+      for (int j=k; j<m; j++) {
+	ritz_mat(r, *V[j]);
+	n_op++;
+
+	if (j == k && k > nlock) { // coupling to the kept Ritz vectors
+	  std::vector<Complex> c(k - nlock);
+	  for (int i=nlock; i<k; i++) c[i-nlock] = -T[i*m + k];
+	  std::vector<ColorSpinorField*> v(V + nlock, V + k), w(1, &r);
+	  caxpy(c.data(), v, w);
+	} else if (j > nlock) {
+	  axpy(-T[(j-1)*m + j], *V[j-1], r);
+	}
+
+	const double a_j = reDotProduct(*V[j], r);
+	axpy(-a_j, *V[j], r);
+	T[j*m + j] = a_j;
+
+	double b_j = sqrt(norm2(r));
+
+	// Estimate the inner products of v_{j+1} with the Lanczos vectors
+	// since the restart.  This is Simon's recurrence, generalized to
+	// the arrowhead structure left by the restart:
+	//   b_j w_{j+1,i} = (v_j, A v_i) - sum_{l<=j} T_lj w_{l,i}
+	// with (v_j, A v_i) = sum_l T_li w_{j,l}
+	std::vector<double> omega_next(j+1, eps);
+	double omega_max = 0.0;
+	if (j > k) {
+	  for (int i=k; i<j; i++) {
+	    double t = 0.0;
+	    for (int l=nlock; l<=j; l++) t += T[l*m + i] * omega[j*m + l] - T[l*m + j] * omega[l*m + i];
+	    t += (t >= 0.0 ? 1.0 : -1.0) * eps * (fabs(T[i*m + i+1]) + b_j);
+	    omega_next[i] = t / b_j;
+	    omega_max = std::max(omega_max, fabs(omega_next[i]));
+	  }
+	}
+
+	const bool full = (j == k) || reorth_next || omega_max > ortho_tol;
+	if (full) {
+	  // the step after an estimate-triggered reorthogonalization is also reorthogonalized
+	  reorth_next = (j > k) && !reorth_next;
+	  orthogonalize(r, V, 0, j+1);
+	  std::fill(omega_next.begin(), omega_next.end(), eps);
+	  b_j = sqrt(norm2(r));
+	  n_reorth++;
+	} else {
+	  reorth_next = false;
+	  // Selective reorthogonalization against the locked and kept Ritz
+	  // vectors: errors in their restart relation would otherwise feed
+	  // back into every new vector and grow from one restart to the next
+	  orthogonalize(r, V, 0, k);
+	}
+	omega_next[j] = eps;
+
+	if (b_j < eps * fabs(a_j)) errorQuda("Lanczos breakdown at step %d (beta = %e)", j, b_j);
+
+	if (j < m-1) {
+	  T[j*m + j+1] = T[(j+1)*m + j] = b_j;
+	  zero(*V[j+1]);
+	  axpy(1.0/b_j, r, *V[j+1]);
+	  for (int i=0; i<=j; i++) omega[(j+1)*m + i] = omega[i*m + j+1] = omega_next[i];
+	} else {
+	  beta_m = b_j;
+	}
+      }
+
+      // Rayleigh-Ritz on the active (unlocked) part of the basis
+      const int na = m - nlock;
+      matrix A(na, na);
+      for (int i=0; i<na; i++)
+	for (int l=0; l<na; l++) A(i,l) = T[(nlock+i)*m + nlock+l];
+
+      Eigen::SelfAdjointEigenSolver<matrix> es(A);
+      const matrix &Y = es.eigenvectors();
+      for (int i=0; i<na; i++) {
+	theta[i] = es.eigenvalues()(i);
+	res[i] = fabs(beta_m * Y(na-1, i));
+	order[i] = largest ? na-1-i : i;
+      }
+
+      // converged wanted Ritz pairs, in order
+      const int wanted = nev - nlock;
+      int nconv = 0;
+      while (nconv < wanted && res[order[nconv]] < tol * std::max(fabs(theta[order[nconv]]), ortho_tol)) nconv++;
+
+      if (getVerbosity() >= QUDA_VERBOSE)
+	printfQuda("ImpRstLanczos: restart %d, %d locked, %d newly converged, first unconverged residual %e\n",
+		   restart, nlock, nconv, nconv < wanted ? res[order[nconv]] : 0.0);
+
+      converged = (nconv == wanted);
+      if (converged || restart == max_restarts) {
+	// rotate the wanted Ritz vectors into place
+	std::vector<double> Yw(na * wanted);
+	for (int t=0; t<wanted; t++)
+	  for (int i=0; i<na; i++) Yw[t*na + i] = Y(i, order[t]);
+	rotate(V, nlock, na, Yw.data(), wanted);
+	break;
+      }
+
+      // thick restart: keep the converged pairs plus half of the remaining space
+      int keep = wanted + (na - wanted) / 2;
+      if (nlock + keep > m - 1) keep = m - 1 - nlock;
+
+      std::vector<double> Yk(na * keep);
+      for (int t=0; t<keep; t++)
+	for (int i=0; i<na; i++) Yk[t*na + i] = Y(i, order[t]);
+      rotate(V, nlock, na, Yk.data(), keep);
+
+      // lock the converged pairs, dropping their (negligible) coupling
+      std::fill(T.begin() + nlock*m, T.end(), 0.0);
+      for (int i=0; i<nlock; i++)
+	for (int l=nlock; l<m; l++) T[i*m + l] = 0.0;
+
+      k = nlock + keep;
+      for (int t=0; t<keep; t++) {
+	const int i = nlock + t;
+	T[i*m + i] = theta[order[t]];
+	if (t >= nconv) T[i*m + k] = T[k*m + i] = beta_m * Y(na-1, order[t]);
+      }
+      nlock += nconv;
+
+      zero(*V[k]);
+      axpy(1.0/beta_m, r, *V[k]);
+
+      for (int i=0; i<m; i++)
+	for (int l=0; l<m; l++) omega[i*m + l] = (i == l) ? 1.0 : eps;
+
+      restart++;
+    }
+
+    // eigenvalues and true residuals with respect to the operator itself
+    for (int i=0; i<nev; i++) {
+      ritz_mat.Mat(Apsi, *V[i]);
+      alpha[i] = reDotProduct(*V[i], Apsi);
+      axpy(-alpha[i], *V[i], Apsi);
+      beta[i] = sqrt(norm2(Apsi));
+    }
+
+    // order by increasing eigenvalue
+    for (int i=1; i<nev; i++) {
+      for (int l=i; l>0 && alpha[l] < alpha[l-1]; l--) {
+	std::swap(alpha[l], alpha[l-1]);
+	std::swap(beta[l], beta[l-1]);
+	std::swap(V[l], V[l-1]);
+      }
+    }
+
+    if (!converged) warningQuda("ImpRstLanczos: not converged after %d restarts", restart);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("ImpRstLanczos: %d eigenpairs after %d restarts, %ld operator applications, %ld full reorthogonalizations\n",
+		 nev, restart, n_op, n_reorth);
+      if (getVerbosity() >= QUDA_VERBOSE)
+	for (int i=0; i<nev; i++) printfQuda("Eigenvalue %d: %1.12e Residual: %1.12e\n", i, alpha[i], beta[i]);
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+  }
 
 } // namespace quda
@@ -0,0 +1,453 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <quda_internal.h>
+#include <comm_quda.h>
+#include <util_quda.h>
+#include <field_io.h>
+
+namespace quda {
+
+  enum FieldFileType { FIELD_FILE_COLOR_SPINOR = 1, FIELD_FILE_GAUGE = 2 };
+
+  struct FieldFileHeader {
+    char magic[8];
+    int version;
+    int type;                 // FieldFileType
+    int precision;            // bytes per real number in the file
+    int n_dim;
+    int x[QUDA_MAX_DIM];      // global lattice dimensions
+    int grid[QUDA_MAX_DIM];   // process grid the file was written with
+    int n_chunk;              // number of vectors or link directions
+    int n_internal;           // real numbers per site per chunk
+    int n_spin;
+    int n_color;
+    int site_subset;
+    int site_order;
+    int link_type;
+    int geometry;
+    uint64_t rank_bytes;      // bytes of data held by each rank
+    uint64_t data_offset;     // file offset of the first rank's data
+  };
+
+  static const char field_file_magic[8] = "QUDAFLD";
+  static const int field_file_version = 1;
+
+  // the data start on a block boundary of the file system
+  static const uint64_t field_file_alignment = 4096;
+
+  /**
+     A host field seen as n_chunk arrays (one per vector or link
+     direction), each holding n_site sites of n_internal reals with
+     stride reals between consecutive sites.
+   */
+  struct FieldIOLayout {
+    std::vector<char*> chunk;
+    size_t n_site;
+    int n_internal;
+    size_t stride;
+    QudaPrecision precision;
+
+    size_t Bytes(QudaPrecision prec) const { return chunk.size() * n_site * n_internal * prec; }
+  };
+
+  template <bool to_file, typename FileFloat, typename FieldFloat>
+  static void convertField(FileFloat *file, const FieldIOLayout &f)
+  {
+    for (size_t c=0; c<f.chunk.size(); c++) {
+      FieldFloat *field = reinterpret_cast<FieldFloat*>(f.chunk[c]);
+      FileFloat *buf = file + c * f.n_site * f.n_internal;
+#pragma omp parallel for num_threads(getOmpThreads())
+      for (long i=0; i<(long)f.n_site; i++) {
+	for (int k=0; k<f.n_internal; k++) {
+	  if (to_file) buf[i*f.n_internal + k] = field[i*f.stride + k];
+	  else field[i*f.stride + k] = buf[i*f.n_internal + k];
+	}
+      }
+    }
+  }
+
+  /**
+     Copy between a host field and its file image, converting the
+     precision on the way
+   */
+  template <bool to_file>
+  static void convertField(char *file, QudaPrecision file_prec, const FieldIOLayout &f)
+  {
+    if (file_prec == QUDA_DOUBLE_PRECISION) {
+      if (f.precision == QUDA_DOUBLE_PRECISION) convertField<to_file,double,double>(reinterpret_cast<double*>(file), f);
+      else if (f.precision == QUDA_SINGLE_PRECISION) convertField<to_file,double,float>(reinterpret_cast<double*>(file), f);
+      else errorQuda("Unsupported field precision %d", f.precision);
+    } else if (file_prec == QUDA_SINGLE_PRECISION) {
+      if (f.precision == QUDA_DOUBLE_PRECISION) convertField<to_file,float,double>(reinterpret_cast<float*>(file), f);
+      else if (f.precision == QUDA_SINGLE_PRECISION) convertField<to_file,float,float>(reinterpret_cast<float*>(file), f);
+      else errorQuda("Unsupported field precision %d", f.precision);
+    } else {
+      errorQuda("Unsupported file precision %d", file_prec);
+    }
+  }
+
+  /**
+     Checksum of a rank's data.  The data are split into fixed-size
+     pieces which are hashed in parallel (FNV-1a over 64-bit words) and
+     the piece checksums are then hashed in turn, so the result does
+     not depend on the number of threads.
+   */
+  static uint64_t fieldChecksum(const char *data, size_t bytes)
+  {
+    const uint64_t prime = 0x100000001b3ull;
+    const uint64_t basis = 0xcbf29ce484222325ull;
+    const size_t piece = 1 << 20;
+    const long n_piece = (bytes + piece - 1) / piece;
+    std::vector<uint64_t> partial(n_piece);
+
+#pragma omp parallel for num_threads(getOmpThreads())
+    for (long p=0; p<n_piece; p++) {
+      const char *d = data + p*piece;
+      const size_t b = std::min(piece, bytes - p*piece);
+      uint64_t sum = basis;
+      const size_t n = b / sizeof(uint64_t);
+      for (size_t i=0; i<n; i++) {
+	uint64_t w;
+	memcpy(&w, d + i*sizeof(uint64_t), sizeof(uint64_t));
+	sum = (sum ^ w) * prime;
+	sum ^= sum >> 32;
+      }
+      for (size_t i=n*sizeof(uint64_t); i<b; i++) sum = (sum ^ (unsigned char)d[i]) * prime;
+      partial[p] = sum;
+    }
+
+    uint64_t sum = basis;
+    for (long p=0; p<n_piece; p++) {
+      sum = (sum ^ partial[p]) * prime;
+      sum ^= sum >> 32;
+    }
+    return sum;
+  }
+
+  static bool pwriteAll(int fd, const char *buf, size_t bytes, uint64_t offset)
+  {
+    while (bytes > 0) {
+      ssize_t n = pwrite(fd, buf, bytes, offset);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      buf += n; bytes -= n; offset += n;
+    }
+    return true;
+  }
+
+  static bool preadAll(int fd, char *buf, size_t bytes, uint64_t offset)
+  {
+    while (bytes > 0) {
+      ssize_t n = pread(fd, buf, bytes, offset);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      buf += n; bytes -= n; offset += n;
+    }
+    return true;
+  }
+
+  /**
+     @return This rank's position in the process grid (x fastest),
+     which determines where its data live in the file
+   */
+  static int fieldFileBlock()
+  {
+    int block = 0;
+    for (int d=3; d>=0; d--) block = block * comm_dim(d) + comm_coord(d);
+    return block;
+  }
+
+  static uint64_t fieldFileDataOffset(int n_rank)
+  {
+    uint64_t offset = sizeof(FieldFileHeader) + n_rank * sizeof(uint64_t);
+    return ((offset + field_file_alignment - 1) / field_file_alignment) * field_file_alignment;
+  }
+
+  /**
+     An asynchronous write in flight: the staged data and the thread
+     that is writing them.
+   */
+  struct PendingWrite {
+    std::vector<char> data;
+    std::thread thread;
+    std::string error;
+  };
+
+  static std::vector<std::unique_ptr<PendingWrite> > pending_writes;
+
+  /**
+     Write this rank's block (and on rank 0 the header) to a file that
+     has already been created.  Returns an empty string on success.
+   */
+  static std::string writeFieldBlock(const std::string &filename, const FieldFileHeader &header,
+				     const std::vector<char> &data, uint64_t sum, int block, bool write_header)
+  {
+    int fd = open(filename.c_str(), O_WRONLY);
+    if (fd < 0) return "unable to open " + filename + " for writing: " + strerror(errno);
+
+    bool ok = true;
+    if (write_header) ok = ok && pwriteAll(fd, reinterpret_cast<const char*>(&header), sizeof(header), 0);
+    ok = ok && pwriteAll(fd, reinterpret_cast<const char*>(&sum), sizeof(sum), sizeof(header) + block * sizeof(uint64_t));
+    ok = ok && pwriteAll(fd, data.data(), data.size(), header.data_offset + block * header.rank_bytes);
+    std::string error = ok ? "" : "failed writing " + filename + ": " + strerror(errno);
+
+    if (close(fd) != 0 && error.empty()) error = "failed closing " + filename + ": " + strerror(errno);
+    return error;
+  }
+
+  static void writeField(const char *filename, FieldFileHeader &header, const FieldIOLayout &layout,
+			 QudaPrecision file_prec, bool async)
+  {
+    const int n_rank = comm_size();
+    header.precision = file_prec;
+    header.rank_bytes = layout.Bytes(file_prec);
+    header.data_offset = fieldFileDataOffset(n_rank);
+
+    // stage this rank's block in the file precision and checksum it
+    std::vector<char> data(header.rank_bytes);
+    convertField<true>(data.data(), file_prec, layout);
+    uint64_t sum = fieldChecksum(data.data(), data.size());
+
+    // rank 0 creates (or truncates) the file before anyone writes to it
+    if (comm_rank() == 0) {
+      int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+      if (fd < 0) errorQuda("Unable to create %s: %s", filename, strerror(errno));
+      close(fd);
+    }
+    comm_barrier();
+
+    const int block = fieldFileBlock();
+    const bool write_header = (comm_rank() == 0);
+    std::string name(filename);
+
+    if (async) {
+      PendingWrite *w = new PendingWrite;
+      pending_writes.push_back(std::unique_ptr<PendingWrite>(w));
+      w->data.swap(data); // the staged block is owned by the write
+      w->thread = std::thread([=]() {
+	  w->error = writeFieldBlock(name, header, w->data, sum, block, write_header);
+	});
+    } else {
+      std::string error = writeFieldBlock(name, header, data, sum, block, write_header);
+      if (!error.empty()) errorQuda("Field I/O: %s", error.c_str());
+      comm_barrier();
+    }
+  }
+
+  /**
+     Read and validate the header, then read this rank's block into the
+     layout, converting from the file precision
+   */
+  static void readField(const char *filename, const FieldFileHeader &expected, const FieldIOLayout &layout)
+  {
+    fieldIOSync(); // an asynchronous write to this file may still be in flight
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) errorQuda("Unable to open %s for reading: %s", filename, strerror(errno));
+
+    FieldFileHeader header;
+    if (!preadAll(fd, reinterpret_cast<char*>(&header), sizeof(header), 0))
+      errorQuda("Field file %s is truncated", filename);
+    if (memcmp(header.magic, field_file_magic, sizeof(header.magic)) != 0)
+      errorQuda("%s is not a QUDA field file", filename);
+    if (header.version != field_file_version)
+      errorQuda("Field file %s has version %d, expected %d", filename, header.version, field_file_version);
+    if (header.type != expected.type)
+      errorQuda("Field file %s holds field type %d, expected %d", filename, header.type, expected.type);
+    if (header.n_dim != expected.n_dim)
+      errorQuda("Field file %s has %d dimensions, expected %d", filename, header.n_dim, expected.n_dim);
+    for (int d=0; d<header.n_dim; d++) {
+      if (header.grid[d] != expected.grid[d])
+	errorQuda("Field file %s was written with process grid %d in dimension %d, current grid is %d",
+		  filename, header.grid[d], d, expected.grid[d]);
+      if (header.x[d] != expected.x[d])
+	errorQuda("Field file %s has lattice dimension %d = %d, expected %d", filename, d, header.x[d], expected.x[d]);
+    }
+    if (header.n_chunk != expected.n_chunk || header.n_internal != expected.n_internal ||
+	header.n_spin != expected.n_spin || header.n_color != expected.n_color ||
+	header.site_subset != expected.site_subset || header.site_order != expected.site_order ||
+	header.geometry != expected.geometry)
+      errorQuda("Field file %s (n_chunk=%d n_internal=%d n_spin=%d n_color=%d site_subset=%d site_order=%d geometry=%d) "
+		"does not match the field (n_chunk=%d n_internal=%d n_spin=%d n_color=%d site_subset=%d site_order=%d geometry=%d)",
+		filename, header.n_chunk, header.n_internal, header.n_spin, header.n_color, header.site_subset,
+		header.site_order, header.geometry, expected.n_chunk, expected.n_internal, expected.n_spin,
+		expected.n_color, expected.site_subset, expected.site_order, expected.geometry);
+
+    const QudaPrecision file_prec = static_cast<QudaPrecision>(header.precision);
+    if (header.rank_bytes != layout.Bytes(file_prec))
+      errorQuda("Field file %s has %lu bytes per rank, expected %lu", filename, header.rank_bytes, layout.Bytes(file_prec));
+    if (header.type == FIELD_FILE_GAUGE && header.link_type != expected.link_type)
+      warningQuda("Field file %s holds link type %d, reading into link type %d", filename, header.link_type, expected.link_type);
+
+    const int block = fieldFileBlock();
+    uint64_t stored_sum;
+    std::vector<char> data(header.rank_bytes);
+    if (!preadAll(fd, reinterpret_cast<char*>(&stored_sum), sizeof(stored_sum), sizeof(header) + block * sizeof(uint64_t)) ||
+	!preadAll(fd, data.data(), data.size(), header.data_offset + block * header.rank_bytes))
+      errorQuda("Field file %s is truncated", filename);
+    close(fd);
+
+    uint64_t sum = fieldChecksum(data.data(), data.size());
+    if (sum != stored_sum)
+      errorQuda("Field file %s: checksum mismatch on rank %d (%lx != %lx)", filename, comm_rank(), sum, stored_sum);
+
+    convertField<false>(data.data(), file_prec, layout);
+  }
+
+  static FieldFileHeader fieldFileHeader(FieldFileType type, const LatticeField &meta, int n_chunk, int n_internal)
+  {
+    FieldFileHeader header;
+    memset(&header, 0, sizeof(header)); // so the padding is deterministic
+    memcpy(header.magic, field_file_magic, sizeof(header.magic));
+    header.version = field_file_version;
+    header.type = type;
+    header.n_dim = meta.Ndim();
+    for (int d=0; d<meta.Ndim(); d++) {
+      header.grid[d] = d < 4 ? comm_dim(d) : 1;
+      header.x[d] = meta.X()[d] * header.grid[d];
+    }
+    header.n_chunk = n_chunk;
+    header.n_internal = n_internal;
+    return header;
+  }
+
+  static FieldIOLayout colorSpinorLayout(const std::vector<ColorSpinorField*> &V, FieldFileHeader &header)
+  {
+    if (V.size() == 0) errorQuda("No fields given");
+    const ColorSpinorField &v0 = *V[0];
+
+    FieldIOLayout layout;
+    for (auto v : V) {
+      if (v->Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Only host fields are supported");
+      if (v->FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) errorQuda("Unsupported field order %d", v->FieldOrder());
+      if (v->Precision() != v0.Precision() || v->Volume() != v0.Volume() || v->Nspin() != v0.Nspin() ||
+	  v->Ncolor() != v0.Ncolor() || v->SiteSubset() != v0.SiteSubset() || v->SiteOrder() != v0.SiteOrder())
+	errorQuda("Fields must all have the same geometry and precision");
+      layout.chunk.push_back(static_cast<char*>(v->V()));
+    }
+    layout.n_site = v0.Volume();
+    layout.n_internal = 2 * v0.Nspin() * v0.Ncolor();
+    layout.stride = layout.n_internal;
+    layout.precision = v0.Precision();
+
+    header = fieldFileHeader(FIELD_FILE_COLOR_SPINOR, v0, V.size(), layout.n_internal);
+    header.n_spin = v0.Nspin();
+    header.n_color = v0.Ncolor();
+    header.site_subset = v0.SiteSubset();
+    header.site_order = v0.SiteOrder();
+    return layout;
+  }
+
+  static FieldIOLayout gaugeLayout(const GaugeField &u, FieldFileHeader &header)
+  {
+    if (u.Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Only host fields are supported");
+    if (u.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Unsupported reconstruct %d", u.Reconstruct());
+    if (u.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED) errorQuda("Extended fields are not supported");
+
+    // Geometry() is the number of directions in 4-d
+    const int n_dir = u.Geometry();
+    FieldIOLayout layout;
+    layout.n_site = u.Volume();
+    layout.n_internal = 2 * u.Ncolor() * u.Ncolor();
+    layout.precision = u.Precision();
+
+    if (u.Order() == QUDA_QDP_GAUGE_ORDER) {
+      // one allocation per direction
+      void * const *gauge = static_cast<void* const*>(u.Gauge_p());
+      for (int d=0; d<n_dir; d++) layout.chunk.push_back(static_cast<char*>(gauge[d]));
+      layout.stride = layout.n_internal;
+    } else if (u.Order() == QUDA_MILC_GAUGE_ORDER) {
+      // the directions are interleaved within each site
+      char *gauge = static_cast<char*>(const_cast<void*>(u.Gauge_p()));
+      for (int d=0; d<n_dir; d++) layout.chunk.push_back(gauge + d * layout.n_internal * u.Precision());
+      layout.stride = n_dir * layout.n_internal;
+    } else {
+      errorQuda("Unsupported gauge order %d", u.Order());
+    }
+
+    header = fieldFileHeader(FIELD_FILE_GAUGE, u, n_dir, layout.n_internal);
+    header.n_color = u.Ncolor();
+    header.site_subset = QUDA_FULL_SITE_SUBSET;
+    header.link_type = u.LinkType();
+    header.geometry = u.Geometry();
+    return layout;
+  }
+
+  bool isFieldFile(const char *filename)
+  {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    char magic[8];
+    bool match = preadAll(fd, magic, sizeof(magic), 0) && memcmp(magic, field_file_magic, sizeof(magic)) == 0;
+    close(fd);
+    return match;
+  }
+
+  void saveColorSpinorFields(const char *filename, const std::vector<ColorSpinorField*> &V,
+			     QudaPrecision file_prec, bool async)
+  {
+    FieldFileHeader header;
+    FieldIOLayout layout = colorSpinorLayout(V, header);
+    if (file_prec == QUDA_INVALID_PRECISION) file_prec = layout.precision;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Saving %lu fields to %s (%s precision%s)\n", V.size(), filename,
+		 file_prec == QUDA_DOUBLE_PRECISION ? "double" : "single", async ? ", asynchronous" : "");
+    writeField(filename, header, layout, file_prec, async);
+  }
+
+  void loadColorSpinorFields(const char *filename, std::vector<ColorSpinorField*> &V)
+  {
+    FieldFileHeader header;
+    FieldIOLayout layout = colorSpinorLayout(V, header);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Loading %lu fields from %s\n", V.size(), filename);
+    readField(filename, header, layout);
+  }
+
+  void saveGaugeField(const char *filename, const GaugeField &u, QudaPrecision file_prec, bool async)
+  {
+    FieldFileHeader header;
+    FieldIOLayout layout = gaugeLayout(u, header);
+    if (file_prec == QUDA_INVALID_PRECISION) file_prec = layout.precision;
+
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Saving gauge field to %s (%s precision%s)\n", filename,
+		 file_prec == QUDA_DOUBLE_PRECISION ? "double" : "single", async ? ", asynchronous" : "");
+    writeField(filename, header, layout, file_prec, async);
+  }
+
+  void loadGaugeField(const char *filename, GaugeField &u)
+  {
+    FieldFileHeader header;
+    FieldIOLayout layout = gaugeLayout(u, header);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Loading gauge field from %s\n", filename);
+    readField(filename, header, layout);
+  }
+
+  void fieldIOSync()
+  {
+    // asynchronous writes are collective, so either every rank has some outstanding or none do
+    if (pending_writes.empty()) return;
+
+    std::string error;
+    for (auto &w : pending_writes) {
+      w->thread.join();
+      if (error.empty()) error = w->error;
+    }
+    pending_writes.clear();
+    if (!error.empty()) errorQuda("Field I/O: %s", error.c_str());
+
+    comm_barrier();
+  }
+
+} // namespace quda
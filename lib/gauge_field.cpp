@@ -35,7 +35,7 @@ namespace quda {
     anisotropy(param.anisotropy), tadpole(param.tadpole), fat_link_max(0.0), scale(param.scale),  
     create(param.create),
     staggeredPhaseType(param.staggeredPhaseType), staggeredPhaseApplied(param.staggeredPhaseApplied), i_mu(param.i_mu),
-    site_offset(param.site_offset), site_size(param.site_size)
+    site_offset(param.site_offset), site_size(param.site_size), checksum_stream(nullptr)
   {
     if (link_type != QUDA_COARSE_LINKS && nColor != 3)
       errorQuda("nColor must be 3, not %d for this link type", nColor);
@@ -329,6 +329,10 @@ namespace quda {
     return Checksum(*this, mini);
   }
 
+  uint64_t GaugeField::checksum(uint64_t *partial, bool mini) const {
+    return Checksum(*this, partial, mini);
+  }
+
 
 
 } // namespace quda
@@ -2,13 +2,42 @@
 #include <quda_matrix.h>
 #include <index_helper.cuh>
 #include <generics/ldg.h>
+#include <vector>
+#include <map>
+#include <algorithm>
 
 namespace quda {
 
 #ifdef GPU_GAUGE_FORCE
 
-  template <typename Mom, typename Gauge>
+  /**
+     @brief A node of the path trie.  The paths contributing to the
+     force in a given direction are merged on their common prefixes,
+     so that each node is a link shared by one or more paths, and the
+     product of the links from the root down to a node is computed
+     once for all paths through it.  The nodes are stored in
+     depth-first order, so a node's parent is the closest preceding
+     node of smaller depth.  Paths too long to be traversed as a trie
+     are instead stored unmerged, one chain of nodes per path, with
+     depth 0 for the first link and 1 for the others.
+   */
+  struct GaugePathNode {
+    double coeff;       // summed coefficient of the paths that end at this node
+    signed char dx[4];  // offset of the link from the site the force is computed at
+    signed char lnkdir; // direction of the link
+    signed char dagger; // whether the link is traversed backwards
+    signed char depth;  // depth in the trie, 0 for the first link of a path
+  };
+
+  /**
+     Deepest trie that is traversed with merged prefixes: every level
+     keeps a live prefix product, so longer paths are applied unmerged.
+   */
+  static constexpr int gauge_path_max_depth = 16;
+
+  template <typename Mom, typename Gauge, int max_length_>
   struct GaugeForceArg {
+    static constexpr int max_length = max_length_; // maximum trie depth of this instantiation (0 for unmerged paths)
     Mom mom;
     const Gauge u;
 
@@ -18,23 +47,23 @@ namespace quda {
     int border[4]; // radius of border
 
     int num_paths;
-    int path_max_length;
 
     double coeff;
 
-    const int *input_path_d[4];
-    const int *length_d;
-    const double *path_coeff_d;
+    const GaugePathNode *nodes; // the path tries of all four directions
+    int offset[4];              // offset of each direction's trie in nodes
+    int num_nodes[4];           // number of nodes in each direction's trie
 
-    int count; // equal to sum of all path lengths.  Used a convenience for computing perf
+    int links; // total number of trie nodes (links loaded per site), used for computing perf
+    int mults; // total number of link multiplications per site, used for computing perf
 
-    GaugeForceArg(Mom &mom, const Gauge &u, int num_paths, int path_max_length, double coeff,
-                  int **input_path_d, const int *length_d, const double* path_coeff_d, int count,
+    GaugeForceArg(Mom &mom, const Gauge &u, int num_paths, double coeff, const GaugePathNode *nodes,
+                  const int *offset, const int *num_nodes, int links, int mults,
 		  const GaugeField &meta_mom, const GaugeField &meta_u)
-      : mom(mom), u(u), threads(meta_mom.VolumeCB()), num_paths(num_paths),
-	path_max_length(path_max_length), coeff(coeff),
-	input_path_d{ input_path_d[0], input_path_d[1], input_path_d[2], input_path_d[3] },
-	length_d(length_d), path_coeff_d(path_coeff_d), count(count)
+      : mom(mom), u(u), threads(meta_mom.VolumeCB()), num_paths(num_paths), coeff(coeff),
+	nodes(nodes), offset{ offset[0], offset[1], offset[2], offset[3] },
+	num_nodes{ num_nodes[0], num_nodes[1], num_nodes[2], num_nodes[3] },
+	links(links), mults(mults)
     {
       for(int i=0; i<4; i++) {
 	X[i] = meta_mom.X()[i];
@@ -49,16 +78,160 @@ namespace quda {
   __device__ __host__ inline static int flipDir(int dir) { return (7-dir); }
   __device__ __host__ inline static bool isForwards(int dir) { return (dir <= 3); }
 
-  // this ensures that array elements are held in cache
-  template <typename T>
-  __device__ __host__ inline static T cache(const T *ptr, int idx) {
-#ifdef __CUDA_ARCH__
-    return __ldg(ptr+idx);
-#else
-    return ptr[idx];
-#endif
+  struct GaugePathTrieNode {
+    double coeff;
+    std::map<int,int> child; // step -> index of child node
+  };
+
+  /**
+     @brief Emit the subtree below trie node in depth-first order,
+     resolving the position of each link relative to x
+     @param[out] nodes Flattened trie
+     @param[in] trie The trie
+     @param[in] node Node whose children are emitted
+     @param[in] depth Depth of the children
+     @param[in] pos Position at the end of the path prefix ending at node
+   */
+  static void flattenPathTrie(std::vector<GaugePathNode> &nodes, const std::vector<GaugePathTrieNode> &trie,
+			      int node, int depth, const int pos[4])
+  {
+    for (auto &c : trie[node].child) {
+      int step = c.first;
+      int y[4] = {pos[0], pos[1], pos[2], pos[3]};
+
+      GaugePathNode n;
+      n.coeff = trie[c.second].coeff;
+      n.depth = depth;
+      n.dagger = isForwards(step) ? 0 : 1;
+      n.lnkdir = isForwards(step) ? step : flipDir(step);
+      if (n.dagger) y[n.lnkdir]--; // if we are going backwards the link is on the adjacent site
+      for (int d=0; d<4; d++) n.dx[d] = y[d];
+      if (!n.dagger) y[n.lnkdir]++;
+
+      nodes.push_back(n);
+      flattenPathTrie(nodes, trie, c.second, depth+1, y);
+    }
+  }
+
+  /**
+     @brief Merge the paths for direction dir into a prefix trie.
+     Paths with zero coefficient are dropped, and identical paths are
+     merged with their coefficients summed.
+     @param[out] nodes The trie nodes in depth-first order are appended here
+     @param[in] dir Direction of the force
+     @param[in] input_path Paths for this direction
+     @param[in] length Length of each path
+     @param[in] path_coeff Coefficient of each path
+     @param[in] num_paths Number of paths
+   */
+  static void buildPathTrie(std::vector<GaugePathNode> &nodes, int dir, int **input_path, const int *length,
+			    const double *path_coeff, int num_paths)
+  {
+    std::vector<GaugePathTrieNode> trie(1); // node 0 is the (empty) root
+    trie[0].coeff = 0.0;
+
+    for (int i=0; i<num_paths; i++) {
+      if (path_coeff[i] == 0) continue;
+
+      int node = 0;
+      for (int j=0; j<length[i]; j++) {
+	int step = input_path[i][j];
+	auto it = trie[node].child.find(step);
+	if (it == trie[node].child.end()) {
+	  trie.push_back(GaugePathTrieNode());
+	  trie.back().coeff = 0.0;
+	  it = trie[node].child.insert(std::make_pair(step, (int)trie.size()-1)).first;
+	}
+	node = it->second;
+      }
+      trie[node].coeff += path_coeff[i];
+    }
+
+    // the paths start from the end of the link in direction dir
+    int pos[4] = {0, 0, 0, 0};
+    pos[dir]++;
+    flattenPathTrie(nodes, trie, 0, 0, pos);
   }
 
+  /**
+     @brief Append the paths for direction dir without merging them,
+     as one chain of nodes per path, for paths that are too long to be
+     traversed as a trie.  Paths with zero coefficient are dropped.
+     @param[out] nodes The chains are appended here
+     @param[in] dir Direction of the force
+     @param[in] input_path Paths for this direction
+     @param[in] length Length of each path
+     @param[in] path_coeff Coefficient of each path
+     @param[in] num_paths Number of paths
+   */
+  static void buildPathChains(std::vector<GaugePathNode> &nodes, int dir, int **input_path, const int *length,
+			      const double *path_coeff, int num_paths)
+  {
+    for (int i=0; i<num_paths; i++) {
+      if (path_coeff[i] == 0) continue;
+
+      // the paths start from the end of the link in direction dir
+      int y[4] = {0, 0, 0, 0};
+      y[dir]++;
+
+      for (int j=0; j<length[i]; j++) {
+	int step = input_path[i][j];
+	GaugePathNode n;
+	n.coeff = j == length[i]-1 ? path_coeff[i] : 0.0;
+	n.depth = j == 0 ? 0 : 1;
+	n.dagger = isForwards(step) ? 0 : 1;
+	n.lnkdir = isForwards(step) ? step : flipDir(step);
+	if (n.dagger) y[n.lnkdir]--; // if we are going backwards the link is on the adjacent site
+	for (int d=0; d<4; d++) n.dx[d] = y[d];
+	if (!n.dagger) y[n.lnkdir]++;
+	nodes.push_back(n);
+      }
+    }
+  }
+
+  /**
+     @brief Depth-first traversal of the path trie.  Each level of the
+     trie is a separate instantiation, so the prefix product at every
+     depth is a named local rather than an element of a dynamically
+     indexed array, and stays in registers: apply<depth> visits the
+     consecutive nodes at this depth (the children of prefix), and
+     recurses into the subtree of each before moving to its sibling.
+     @param[in,out] staple Sum of the coefficient-weighted path products
+     @param[in] prefix Product of the links from the root down to the
+     parent of the nodes at this depth (unused at depth 0)
+     @param[in,out] i Index of the next node, advanced past the subtree
+   */
+  template <typename Float, typename Arg, int depth, int max_depth=Arg::max_length>
+  struct GaugePathTraversal {
+    typedef Matrix<complex<Float>,3> Link;
+    __device__ __host__ inline static void apply(Link &staple, const Link &prefix, const Arg &arg, const int x[4],
+						 int parity, const GaugePathNode *nodes, int &i, int num_nodes)
+    {
+      while (i < num_nodes && nodes[i].depth == depth) {
+	const GaugePathNode &node = nodes[i++];
+	int dx[4] = { node.dx[0], node.dx[1], node.dx[2], node.dx[3] };
+	int nbr_oddbit = parity ^ ((dx[0] + dx[1] + dx[2] + dx[3]) & 1);
+
+	Link linkB = arg.u(node.lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
+	if (node.dagger) linkB = conj(linkB);
+
+	Link link = depth == 0 ? linkB : prefix * linkB;
+
+	Float coeff = node.coeff;
+	if (coeff != 0) staple = staple + coeff*link;
+
+	GaugePathTraversal<Float,Arg,depth+1,max_depth>::apply(staple, link, arg, x, parity, nodes, i, num_nodes);
+      }
+    }
+  };
+
+  template <typename Float, typename Arg, int max_depth>
+  struct GaugePathTraversal<Float,Arg,max_depth,max_depth> {
+    typedef Matrix<complex<Float>,3> Link;
+    __device__ __host__ inline static void apply(Link &, const Link &, const Arg &, const int [4],
+						 int, const GaugePathNode *, int &, int) { }
+  };
+
   template<typename Float, typename Arg, int dir>
   __device__ __host__ inline void GaugeForceKernel(Arg &arg, int idx, int parity)
   {
@@ -68,66 +241,33 @@ namespace quda {
     getCoords(x, idx, arg.X, parity);
     for (int dr=0; dr<4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
 
-    //linkA: current matrix
-    //linkB: the loaded matrix in this round
-    Link linkA, linkB, staple;
-
-#ifdef __CUDA_ARCH__
-    extern __shared__ int s[];
-    int tid = (threadIdx.z*blockDim.y + threadIdx.y)*blockDim.x + threadIdx.x;
-    s[tid] = 0;
-    signed char *dx = (signed char*)&s[tid];
-#else
-    int dx[4] = {0, 0, 0, 0};
-#endif
-
-    for (int i=0; i<arg.num_paths; i++) {
-      Float coeff = cache(arg.path_coeff_d,i);
-      if (coeff == 0) continue;
+    Link staple;
+    const GaugePathNode *nodes = arg.nodes + arg.offset[dir];
 
-      const int* path = arg.input_path_d[dir] + i*arg.path_max_length;
+    if (Arg::max_length > 0) {
+      Link root; // the root prefix is never read
+      int i = 0;
+      GaugePathTraversal<Float,Arg,0>::apply(staple, root, arg, x, parity, nodes, i, arg.num_nodes[dir]);
+    } else {
+      // unmerged paths: a single running product, restarted at the first link of each path
+      Link link;
+      for (int i=0; i<arg.num_nodes[dir]; i++) {
+	const GaugePathNode &node = nodes[i];
+	int dx[4] = { node.dx[0], node.dx[1], node.dx[2], node.dx[3] };
+	int nbr_oddbit = parity ^ ((dx[0] + dx[1] + dx[2] + dx[3]) & 1);
 
-      // start from end of link in direction dir
-      int nbr_oddbit = (parity^1);
-      dx[dir]++;
+	Link linkB = arg.u(node.lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
+	if (node.dagger) linkB = conj(linkB);
 
-      int path0 = cache(path,0);
-      int lnkdir = isForwards(path0) ? path0 : flipDir(path0);
+	link = node.depth == 0 ? linkB : link * linkB;
 
-      if (isForwards(path0)) {
-        linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-        linkA = linkB;
-        dx[lnkdir]++; // now have to update location
-	nbr_oddbit = nbr_oddbit^1;
-      } else {
-        dx[lnkdir]--; // if we are going backwards the link is on the adjacent site
-        nbr_oddbit = nbr_oddbit^1;
-	linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-        linkA = conj(linkB);
+	Float coeff = node.coeff;
+	if (coeff != 0) staple = staple + coeff*link;
       }
-	
-      for (int j=1; j<cache(arg.length_d,i); j++) {
-
-        int pathj = cache(path,j);
-        int lnkdir = isForwards(pathj) ? pathj : flipDir(pathj);
-
-        if (isForwards(pathj)) {
-          linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-          linkA = linkA * linkB;
-          dx[lnkdir]++; // now have to update to new location
-          nbr_oddbit = nbr_oddbit^1;	
-        } else {
-          dx[lnkdir]--; // if we are going backwards the link is on the adjacent site
-	  nbr_oddbit = nbr_oddbit^1;
-          linkB = arg.u(lnkdir, linkIndexShift(x,dx,arg.E), nbr_oddbit);
-          linkA = linkA * conj(linkB);
-        }
-      } //j
-      staple = staple + coeff*linkA;
-    } //i
+    }
 
     // multiply by U(x)
-    linkA = arg.u(dir, linkIndex(x,arg.E), parity);
+    Link linkA = arg.u(dir, linkIndex(x,arg.E), parity);
     linkA = linkA * staple;
 
     // update mom(x)
@@ -141,6 +281,7 @@ namespace quda {
   template <typename Float, typename Arg>
   void GaugeForceCPU(Arg &arg) {
     for (int dir=0; dir<4; dir++) {
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
       for (int parity=0; parity<2; parity++) {
         for (int idx=0; idx<arg.threads; idx++) {
 	  switch(dir) {
@@ -193,7 +334,7 @@ namespace quda {
     Arg &arg;
     QudaFieldLocation location;
     const char *vol_str;
-    unsigned int sharedBytesPerThread() const { return 4; } // for dynamic indexing array
+    unsigned int sharedBytesPerThread() const { return 0; }
     unsigned int minThreads() const { return arg.threads; }
     bool tuneGridDim() const { return false; } // don't tune the grid dimension
 
@@ -214,8 +355,8 @@ namespace quda {
     void preTune() { arg.mom.save(); }
     void postTune() { arg.mom.load(); } 
   
-    long long flops() const { return (arg.count - arg.num_paths + 1) * 198ll * 2 * arg.mom.volumeCB * 4; }
-    long long bytes() const { return ((arg.count + 1ll) * arg.u.Bytes() + 2ll*arg.mom.Bytes()) * 2 * arg.mom.volumeCB * 4; }
+    long long flops() const { return (arg.mults + 4ll) * 198ll * 2 * arg.mom.volumeCB; }
+    long long bytes() const { return ((arg.links + 4ll) * arg.u.Bytes() + 8ll*arg.mom.Bytes()) * 2 * arg.mom.volumeCB; }
 
     TuneKey tuneKey() const {
       std::stringstream aux;
@@ -263,51 +404,84 @@ namespace quda {
     }
   };
   
+  template <typename Float, int max_length, typename Mom, typename Gauge>
+  void gaugeForce(Mom mom, const Gauge &u, GaugeField& meta_mom, const GaugeField& meta_u, const double coeff,
+		  int num_paths, const std::vector<GaugePathNode> &nodes, const int *offset, const int *num_nodes, int mults)
+  {
+    typedef GaugeForceArg<Mom,Gauge,max_length> Arg;
+
+    size_t bytes = nodes.size() * sizeof(GaugePathNode);
+    GaugePathNode *nodes_d = nullptr;
+    if (meta_mom.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      nodes_d = (GaugePathNode*)pool_device_malloc(bytes);
+      qudaMemcpy(nodes_d, nodes.data(), bytes, cudaMemcpyHostToDevice);
+    }
+
+    Arg arg(mom, u, num_paths, coeff, nodes_d ? nodes_d : nodes.data(), offset, num_nodes,
+	    nodes.size(), mults, meta_mom, meta_u);
+    GaugeForce<Float,Arg> gauge_force(arg, meta_mom, meta_u);
+    gauge_force.apply(0);
+    checkCudaError();
+
+    if (nodes_d) pool_device_free(nodes_d);
+    qudaDeviceSynchronize();
+  }
+
   template <typename Float, typename Mom, typename Gauge>
   void gaugeForce(Mom mom, const Gauge &u, GaugeField& meta_mom, const GaugeField& meta_u, const double coeff,
 		  int ***input_path, const int* length_h, const double* path_coeff_h, const int num_paths, const int path_max_length)
   {
-    size_t bytes = num_paths*path_max_length*sizeof(int);
-    int *input_path_d[4];
+    // input_path[dir] holds path_max_length steps per path
+    int depth = 0;
+    for (int i=0; i<num_paths; i++) {
+      if (path_coeff_h[i] == 0) continue;
+      if (length_h[i] < 1 || length_h[i] > path_max_length)
+	errorQuda("Path %d has length %d outside of supported range [1,%d]", i, length_h[i], path_max_length);
+      for (int dir=0; dir<4; dir++)
+	for (int j=0; j<length_h[i]; j++)
+	  if (input_path[dir][i][j] < 0 || input_path[dir][i][j] > 7)
+	    errorQuda("Invalid direction %d in path %d", input_path[dir][i][j], i);
+      depth = std::max(depth, length_h[i]);
+    }
+    const bool merge = depth <= gauge_path_max_depth;
 
-    int count = 0;
+    // compile the paths of each direction into a prefix trie (or into
+    // unmerged chains if the paths are too long)
+    std::vector<GaugePathNode> nodes;
+    int offset[4], num_nodes[4];
+    int mults = 0, mults_unmerged = 0;
     for (int dir=0; dir<4; dir++) {
-      input_path_d[dir] = (int*)pool_device_malloc(bytes);
-      cudaMemset(input_path_d[dir], 0, bytes);
-
-      int* input_path_h = (int*)safe_malloc(bytes);
-      memset(input_path_h, 0, bytes);
-      
-      // flatten the input_path array for copying to the device
-      for (int i=0; i < num_paths; i++) {
-	for (int j=0; j < length_h[i]; j++) {
-	  input_path_h[i*path_max_length + j] = input_path[dir][i][j];
-          if (dir==0) count++;
-	}
-      }
-      qudaMemcpy(input_path_d[dir], input_path_h, bytes, cudaMemcpyHostToDevice);
+      offset[dir] = nodes.size();
+      if (merge) buildPathTrie(nodes, dir, input_path[dir], length_h, path_coeff_h, num_paths);
+      else buildPathChains(nodes, dir, input_path[dir], length_h, path_coeff_h, num_paths);
+      num_nodes[dir] = nodes.size() - offset[dir];
+
+      // every node other than a path's first link costs one multiplication
+      for (int i=0; i<num_nodes[dir]; i++) if (nodes[offset[dir]+i].depth > 0) mults++;
+      for (int i=0; i<num_paths; i++) if (path_coeff_h[i] != 0) mults_unmerged += length_h[i] - 1;
+    }
 
-      host_free(input_path_h);
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      if (merge) {
+	printfQuda("Gauge force: %d paths merged into %lu links, %d link multiplications per site instead of %d "
+		   "(%.1f%% fewer flops)\n", num_paths, nodes.size()/4, mults, mults_unmerged,
+		   100.0 * (1.0 - (mults + 4.0) / (mults_unmerged + 4.0)));
+      } else {
+	printfQuda("Gauge force: paths of length %d are longer than %d, applying them unmerged\n",
+		   depth, gauge_path_max_depth);
+      }
     }
-      
-    //length
-    int* length_d = (int*)pool_device_malloc(num_paths*sizeof(int));
-    qudaMemcpy(length_d, length_h, num_paths*sizeof(int), cudaMemcpyHostToDevice);
-
-    //path_coeff
-    double* path_coeff_d = (double*)pool_device_malloc(num_paths*sizeof(double));
-    qudaMemcpy(path_coeff_d, path_coeff_h, num_paths*sizeof(double), cudaMemcpyHostToDevice);
-
-    GaugeForceArg<Mom,Gauge> arg(mom, u, num_paths, path_max_length, coeff, input_path_d,
-				 length_d, path_coeff_d, count, meta_mom, meta_u);
-    GaugeForce<Float,GaugeForceArg<Mom,Gauge> > gauge_force(arg, meta_mom, meta_u);
-    gauge_force.apply(0);
-    checkCudaError();
 
-    pool_device_free(length_d);
-    pool_device_free(path_coeff_d);
-    for (int dir=0; dir<4; dir++) pool_device_free(input_path_d[dir]);
-    qudaDeviceSynchronize();
+    // instantiate the traversal no deeper than needed, since every
+    // level keeps a live prefix product: 6 covers the plaquette and
+    // rectangle staples of the Symanzik-improved actions
+    if (depth <= 6) {
+      gaugeForce<Float,6>(mom, u, meta_mom, meta_u, coeff, num_paths, nodes, offset, num_nodes, mults);
+    } else if (merge) {
+      gaugeForce<Float,gauge_path_max_depth>(mom, u, meta_mom, meta_u, coeff, num_paths, nodes, offset, num_nodes, mults);
+    } else {
+      gaugeForce<Float,0>(mom, u, meta_mom, meta_u, coeff, num_paths, nodes, offset, num_nodes, mults);
+    }
   }
 
   template <typename Float>
@@ -27,6 +27,8 @@
 #include <ks_improved_force.h>
 #include <ks_force_quda.h>
 #include <random_quda.h>
+#include <stencil_index.h>
+#include <field_io.h>
 
 #include <multigrid.h>
 
@@ -142,8 +144,17 @@ std::vector<cudaColorSpinorField*> solutionResident;
 
 // vector of spinors used for forecasting solutions in HMC
 #define QUDA_MAX_CHRONO 2
-// each entry is a pair for both p and Ap storage
-std::vector< std::vector< std::pair<ColorSpinorField*,ColorSpinorField*> > > chronoResident(QUDA_MAX_CHRONO);
+// each entry is a previous solution p, newest first, stored in
+// chrono_precision; Ap is recomputed when forecasting so is not kept
+std::vector< std::vector<ColorSpinorField*> > chronoResident(QUDA_MAX_CHRONO);
+
+// least-recently-used bookkeeping for evicting from the chrono bases
+static long chrono_tick = 0;
+static long chrono_last_use[QUDA_MAX_CHRONO] = { };
+static long chrono_evictions = 0;
+
+// per chrono index, indexed by the basis size used: (solves, total iterations)
+static std::vector< std::pair<long,long> > chrono_stats[QUDA_MAX_CHRONO];
 
 // Mapped memory buffer used to hold unitarization failures
 static int *num_failures_h = NULL;
@@ -286,6 +297,17 @@ static int qmp_rank_from_coords(const int *coords, void *fdata)
 #endif
 
 
+static void init_node_map(CommNodeMap &node_map, int nDim, const int *dims, const int *X)
+{
+  node_map.ndim = nDim;
+  for (int i=0; i<nDim; i++) {
+    node_map.dims[i] = dims[i];
+    node_map.X[i] = X ? X[i] : 0;
+  }
+  node_map.ranks = NULL;
+}
+
+
 static bool comms_initialized = false;
 
 void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata)
@@ -295,6 +317,8 @@ void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata
   }
 
   LexMapData map_data;
+  CommNodeMap node_map;
+  node_map.ranks = NULL;
   if (!func) {
 
 #if QMP_COMMS
@@ -314,12 +338,19 @@ void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata
       warningQuda("QMP logical topology is undeclared; using default lexicographical ordering");
 #endif
 
-      map_data.ndim = nDim;
-      for (int i=0; i<nDim; i++) {
-        map_data.dims[i] = dims[i];
+      char *comms_map_env = getenv("QUDA_COMMS_MAP");
+      if (comms_map_env && strcmp(comms_map_env, "node") == 0) {
+        init_node_map(node_map, nDim, dims, NULL);
+        fdata = (void *) &node_map;
+        func = comm_node_rank_from_coords;
+      } else {
+        map_data.ndim = nDim;
+        for (int i=0; i<nDim; i++) {
+          map_data.dims[i] = dims[i];
+        }
+        fdata = (void *) &map_data;
+        func = lex_rank_from_coords;
       }
-      fdata = (void *) &map_data;
-      func = lex_rank_from_coords;
 
 #if QMP_COMMS
     }
@@ -327,10 +358,24 @@ void initCommsGridQuda(int nDim, const int *dims, QudaCommsMap func, void *fdata
 
   }
   comm_init(nDim, dims, func, fdata);
+  comm_node_map_free(&node_map);
   comms_initialized = true;
 }
 
 
+void initCommsGridNodeQuda(int nDim, const int *dims, const int *X)
+{
+  if (nDim != 4) {
+    errorQuda("Number of communication grid dimensions must be 4");
+  }
+
+  CommNodeMap node_map;
+  init_node_map(node_map, nDim, dims, X);
+  initCommsGridQuda(nDim, dims, comm_node_rank_from_coords, &node_map);
+  comm_node_map_free(&node_map);
+}
+
+
 static void init_default_comms()
 {
 #if defined(QMP_COMMS)
@@ -688,8 +733,21 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
   } else {
     profileGauge.TPSTOP(QUDA_PROFILE_INIT);
     profileGauge.TPSTART(QUDA_PROFILE_H2D);
+    GaugeChecksumStream checksum_stream;
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE) in->streamChecksum(&checksum_stream);
     precise->copy(*in);
+    in->streamChecksum(nullptr);
     profileGauge.TPSTOP(QUDA_PROFILE_H2D);
+
+    // checksum of the input field as computed during a host-side reorder
+    if (checksum_stream.complete) {
+      uint64_t partial[2*QUDA_MAX_GEOMETRY];
+      uint64_t checksum = reduceChecksum(checksum_stream, partial, in->Geometry());
+      printfQuda("Gauge field checksum = %016lx\n", checksum);
+      for (int parity=0; parity<2; parity++)
+	for (int d=0; d<in->Geometry(); d++)
+	  printfQuda("  parity = %d, dim = %d: checksum = %016lx\n", parity, d, partial[parity*in->Geometry()+d]);
+    }
   }
 
   param->gaugeGiB += precise->GBytes();
@@ -1280,13 +1338,101 @@ void flushChronoQuda(int i)
 
   auto &basis = chronoResident[i];
 
-  for (unsigned int j=0; j<basis.size(); j++) {
-    if (basis[j].first)  delete basis[j].first;
-    if (basis[j].second) delete basis[j].second;
-  }
+  for (auto v : basis) delete v;
   basis.clear();
 }
 
+/**
+   @return The device memory budget in bytes for the chronological
+   bases, summed over all indices, as set by QUDA_CHRONO_MEMORY (in
+   MiB).  Zero means no limit.
+ */
+static size_t chronoBudget()
+{
+  static bool init = false;
+  static size_t budget = 0;
+  if (!init) {
+    char *chrono_memory_env = getenv("QUDA_CHRONO_MEMORY");
+    if (chrono_memory_env) budget = static_cast<size_t>(atof(chrono_memory_env) * 1024 * 1024);
+    init = true;
+  }
+  return budget;
+}
+
+static size_t chronoResidentBytes()
+{
+  size_t bytes = 0;
+  for (auto &basis : chronoResident)
+    for (auto v : basis) bytes += v->Bytes() + v->NormBytes();
+  return bytes;
+}
+
+/**
+   @brief Evict basis vectors until a new vector of the given size
+   fits within the chrono memory budget.  Vectors are evicted oldest
+   first from the least recently used index, with the index being
+   augmented evicted from last.
+   @param[in] index The chrono index being augmented
+   @param[in] bytes Size of the vector to be added
+   @param[in] work_bytes Size of the transient work vectors used when
+   forecasting, which also count against the budget
+   @return Whether the new vector fits
+ */
+static bool chronoMakeRoom(int index, size_t bytes, size_t work_bytes)
+{
+  const size_t budget = chronoBudget();
+  if (budget == 0) return true;
+  if (bytes + work_bytes > budget) return false;
+
+  while (chronoResidentBytes() + bytes + work_bytes > budget) {
+    int lru = index;
+    for (int i=0; i<QUDA_MAX_CHRONO; i++) {
+      if (i == index || chronoResident[i].empty()) continue;
+      if (lru == index || chrono_last_use[i] < chrono_last_use[lru]) lru = i;
+    }
+
+    auto &basis = chronoResident[lru];
+    if (basis.empty()) return false;
+    delete basis.back();
+    basis.pop_back();
+    chrono_evictions++;
+  }
+
+  return true;
+}
+
+/**
+   @brief Print the solver iteration counts for each chrono index as a
+   function of the basis size used to forecast the initial guess, so
+   that the memory spent on the basis can be weighed against the
+   iterations it saves.
+ */
+static void printChronoSummary()
+{
+  if (getVerbosity() < QUDA_SUMMARIZE) return;
+
+  for (int i=0; i<QUDA_MAX_CHRONO; i++) {
+    auto &stats = chrono_stats[i];
+    if (stats.empty()) continue;
+
+    printfQuda("Chronological forecasting for index %d:\n", i);
+    const double base = stats[0].first > 0 ? static_cast<double>(stats[0].second) / stats[0].first : 0.0;
+    for (unsigned int n=0; n<stats.size(); n++) {
+      if (stats[n].first == 0) continue;
+      const double iter = static_cast<double>(stats[n].second) / stats[n].first;
+      if (n > 0 && base > 0.0)
+        printfQuda("  basis size %2u: %6ld solves, %8.1f iterations per solve (%5.1f%% saved)\n",
+                   n, stats[n].first, iter, 100.0 * (1.0 - iter / base));
+      else
+        printfQuda("  basis size %2u: %6ld solves, %8.1f iterations per solve\n", n, stats[n].first, iter);
+    }
+  }
+
+  if (chrono_evictions > 0)
+    printfQuda("Chronological forecasting: evicted %ld basis vectors to stay within %.1f MiB\n",
+               chrono_evictions, chronoBudget() / (1024.0 * 1024.0));
+}
+
 void endQuda(void)
 {
   profileEnd.TPSTART(QUDA_PROFILE_TOTAL);
@@ -1296,7 +1442,12 @@ void endQuda(void)
   freeGaugeQuda();
   freeCloverQuda();
 
-  for (int i=0; i<QUDA_MAX_CHRONO; i++) flushChronoQuda(i);
+  printChronoSummary();
+  for (int i=0; i<QUDA_MAX_CHRONO; i++) {
+    flushChronoQuda(i);
+    chrono_stats[i].clear();
+  }
+  chrono_evictions = 0;
 
   for (auto v : solutionResident) if (v) delete v;
   solutionResident.clear();
@@ -1305,11 +1456,14 @@ void endQuda(void)
 
   LatticeField::freeGhostBuffer();
   cpuColorSpinorField::freeGhostBuffer();
+  flushStencilIndex();
+  fieldIOSync();
 
   blas::end();
 
   pool::flush_pinned();
   pool::flush_device();
+  pool::flush_host();
 
   host_free(num_failures_h);
   num_failures_h = NULL;
@@ -1322,6 +1476,10 @@ void endQuda(void)
   }
   destroyDslashEvents();
 
+  // collective, so must be called on all ranks before comm_finalize
+  comm_stats_report();
+  printDslashOverlap();
+
   saveTuneCache();
   saveProfile();
 
@@ -2359,6 +2517,9 @@ multigrid_solver::multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &pr
   mg = new MG(*mgParam, profile);
   mgParam->updateInvertParam(*param);
   profile.TPSTOP(QUDA_PROFILE_INIT);
+
+  setup_secs = profile.Last(QUDA_PROFILE_INIT);
+  mg_param.secs = setup_secs;
 }
 
 void* newMultigridQuda(QudaMultigridParam *mg_param) {
@@ -2379,6 +2540,9 @@ void destroyMultigridQuda(void *mg) {
 }
 
 void updateMultigridQuda(void *mg_, QudaMultigridParam *mg_param) {
+  profileInvert.TPSTART(QUDA_PROFILE_TOTAL);
+  profileInvert.TPSTART(QUDA_PROFILE_INIT);
+
   multigrid_solver *mg = static_cast<multigrid_solver*>(mg_);
 
   QudaInvertParam *param = mg_param->invert_param;
@@ -2427,16 +2591,36 @@ void updateMultigridQuda(void *mg_, QudaMultigridParam *mg_param) {
   mg->mg->destroySmoother();
   mg->mg->createSmoother();
 
+  // rebuild the coarse grids from the existing null space rather than regenerating it
+  if (mg_param->setup_refresh == QUDA_BOOLEAN_YES) mg->mg->refresh();
+
   //mgParam = new MGParam(mg_param, B, *m, *mSmooth, *mSmoothSloppy);
   //mg = new MG(*mgParam, profile);
   mg->mgParam->updateInvertParam(*param);
+
+  profileInvert.TPSTOP(QUDA_PROFILE_INIT);
+  profileInvert.TPSTOP(QUDA_PROFILE_TOTAL);
+
+  mg_param->secs = profileInvert.Last(QUDA_PROFILE_INIT);
+  if (getVerbosity() >= QUDA_SUMMARIZE)
+    printfQuda("Multigrid %s took %g secs (full setup took %g secs)\n",
+	       mg_param->setup_refresh == QUDA_BOOLEAN_YES ? "refresh" : "update", mg_param->secs, mg->setup_secs);
+
+  saveProfile(__func__);
+  flushProfile();
 }
 
 deflated_solver::deflated_solver(QudaEigParam &eig_param, TimeProfile &profile)
   : d(nullptr), m(nullptr), RV(nullptr), deflParam(nullptr), defl(nullptr),  profile(profile) {
 
   QudaInvertParam *param = eig_param.invert_param;
-  
+
+  // the deflation space is only consumed by the eigCG solvers, so a
+  // Lanczos-computed space would otherwise be silently dropped
+  if (eig_param.eig_type == QUDA_IMP_RST_LANCZOS && !eig_param.import_vectors &&
+      param->inv_type != QUDA_EIGCG_INVERTER && param->inv_type != QUDA_INC_EIGCG_INVERTER)
+    errorQuda("Lanczos deflation space requires the EIGCG or INC_EIGCG inverter (inv_type = %d)", param->inv_type);
+
   if(param->inv_type != QUDA_EIGCG_INVERTER && param->inv_type != QUDA_INC_EIGCG_INVERTER)  return;
 
   profile.TPSTART(QUDA_PROFILE_INIT);
@@ -2494,6 +2678,45 @@ deflated_solver::deflated_solver(QudaEigParam &eig_param, TimeProfile &profile)
 
   defl = new Deflation(*deflParam, profile);
 
+  // compute the deflation space up front from the low modes of the operator
+  if (eig_param.eig_type == QUDA_IMP_RST_LANCZOS && !eig_param.import_vectors) {
+    if (!pc_solve) errorQuda("Lanczos deflation space requires a normal-operator PC solve");
+    if (eig_param.location != QUDA_CUDA_FIELD_LOCATION) errorQuda("Lanczos deflation space must be computed on the device");
+
+    const int nvec = RV->CompositeDim();
+    std::vector<cudaColorSpinorField*> V(nvec);
+    for (int i=0; i<nvec; i++) V[i] = static_cast<cudaColorSpinorField*>(&RV->Component(i));
+
+    ColorSpinorParam csParam(RV->Component(0));
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+    cudaColorSpinorField r(csParam), Apsi(csParam);
+    r.Source(QUDA_RANDOM_SOURCE);
+
+    std::vector<double> evals(nvec), resid(nvec);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    RitzMat ritz_mat(*m, eig_param);
+    Eig_Solver *eig_solve = Eig_Solver::create(eig_param, ritz_mat, profile);
+    (*eig_solve)(evals.data(), resid.data(), V.data(), r, Apsi, 0, nvec);
+    delete eig_solve;
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    // without a polynomial the residuals are directly comparable with the stopping criterion
+    if (eig_param.run_verify && eig_param.NPoly < 2) {
+      for (int i=0; i<eig_param.nk; i++) {
+        const double rel = resid[i] / fabs(evals[i]);
+        if (getVerbosity() >= QUDA_SUMMARIZE)
+          printfQuda("Lanczos eigenpair %d: eigenvalue = %e, |A v - lambda v| / |lambda| = %e\n", i, evals[i], rel);
+        if (!(rel <= 10 * eig_param.Stp_residual))
+          errorQuda("Lanczos eigenpair %d has relative residual %e (tolerance %e)", i, rel, eig_param.Stp_residual);
+      }
+    }
+
+    // the eigenvectors are in the first nk components of RV
+    defl->increment(*RV, eig_param.nk);
+    if (eig_param.run_verify) defl->verify();
+  }
+
   profile.TPSTOP(QUDA_PROFILE_INIT);
 }
 
@@ -2726,25 +2949,40 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     SolverParam solverParam(*param);
 
     // chronological forecasting
+    unsigned int chrono_dim = 0;
     if (param->use_resident_chrono && chronoResident[param->chrono_index].size() > 0) {
       auto &basis = chronoResident[param->chrono_index];
+      chrono_last_use[param->chrono_index] = ++chrono_tick;
+      chrono_dim = basis.size();
 
-      cudaColorSpinorField tmp(*in), tmp2(*in);
-
-      for (unsigned int j=0; j<basis.size(); j++) m(*basis[j].second, *basis[j].first, tmp, tmp2);
+      // the basis may be stored in reduced precision, so the projected
+      // system is accumulated through a single pair of full-precision
+      // work vectors, which are released again before the solve
+      ColorSpinorParam cs_param(*x);
+      cs_param.create = QUDA_NULL_FIELD_CREATE;
+      ColorSpinorField *p = ColorSpinorField::Create(cs_param);
+      ColorSpinorField *q = ColorSpinorField::Create(cs_param);
 
-      bool orthogonal = true;
-      bool apply_mat = false;
+      bool orthogonal = false;
+      bool apply_mat = true;
       MinResExt mre(m, orthogonal, apply_mat, profileInvert);
-      blas::copy(tmp, *in);
+      mre(*out, *in, basis, *p, *q);
 
-      mre(*out, tmp, basis);
+      delete p;
+      delete q;
     }
 
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, profileInvert);
     (*solve)(*out, *in);
     solverParam.updateInvertParam(*param);
     delete solve;
+
+    if (param->use_resident_chrono) {
+      auto &stats = chrono_stats[param->chrono_index];
+      if (stats.size() <= chrono_dim) stats.resize(chrono_dim + 1, std::make_pair(0l, 0l));
+      stats[chrono_dim].first++;
+      stats[chrono_dim].second += param->iter;
+    }
   } else { // norm_error_solve
     DiracMMdag m(dirac), mSloppy(diracSloppy), mPre(diracPre);
     cudaColorSpinorField tmp(*out);
@@ -2784,18 +3022,40 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
       errorQuda("Requested chrono index %d is outside of max %d\n", i, QUDA_MAX_CHRONO);
 
     auto &basis = chronoResident[i];
+    chrono_last_use[i] = ++chrono_tick;
+
+    // if the space is full, recycle the oldest entry
+    ColorSpinorField *v = nullptr;
+    if ((int)basis.size() >= param->max_chrono_dim && basis.size() > 0) {
+      v = basis.back();
+      basis.pop_back();
+      if (v->Precision() != param->chrono_precision) {
+        delete v;
+        v = nullptr;
+      }
+    }
 
-    // if we have filled the space yet just augment
-    if ((int)basis.size() < param->max_chrono_dim) {
+    if (!v) {
       ColorSpinorParam cs_param(*x);
-      basis.push_back(std::pair<ColorSpinorField*,ColorSpinorField*>(ColorSpinorField::Create(cs_param),ColorSpinorField::Create(cs_param)));
+      cs_param.create = QUDA_NULL_FIELD_CREATE;
+      cs_param.setPrecision(param->chrono_precision);
+
+      // half precision carries an additional float norm per site
+      size_t bytes = x->Bytes() / x->Precision() * param->chrono_precision;
+      if (param->chrono_precision < QUDA_SINGLE_PRECISION) bytes += x->Volume() * sizeof(float);
+
+      // the forecast also needs a pair of full-precision work vectors
+      size_t work_bytes = 2 * (x->Bytes() + x->NormBytes());
+
+      if (chronoMakeRoom(i, bytes, work_bytes)) v = ColorSpinorField::Create(cs_param);
+      else warningQuda("Chrono basis vector of %lu bytes (plus %lu bytes of work space) exceeds the QUDA_CHRONO_MEMORY budget",
+                       bytes, work_bytes);
     }
 
-    // shuffle every entry down one and bring the last to the front
-    ColorSpinorField *tmp = basis[basis.size()-1].first;
-    for (unsigned int j=basis.size()-1; j>0; j--) basis[j].first = basis[j-1].first;
-    basis[0].first = tmp;
-    *(basis[0]).first = *x; // set first entry to new solution
+    if (v) {
+      *v = *x;
+      basis.insert(basis.begin(), v); // newest entry at the front
+    }
   }
 
   if (param->compute_action) {
@@ -0,0 +1,842 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+/**
+   Communication-avoiding (s-step) CG and BiCGstab, following
+   E. Carson, "Communication-Avoiding Krylov Subspace Methods in
+   Theory and Practice", PhD thesis, UC Berkeley (2015).
+
+   Each outer iteration generates the basis
+
+     Y = [P, R],  P = [p, rho_1(A) p, ..., rho_m(A) p],
+                  R = [r, rho_1(A) r, ..., rho_{m-1}(A) r]
+
+   with m = s for CG and m = 2s for BiCGstab.  The polynomials rho_j
+   obey the three-term recurrence
+
+     A rho_j = sub_j rho_{j+1} + diag_j rho_j + sup_j rho_{j-1}
+
+   so that A Y c = Y T c for any coordinate vector c whose last
+   component in each block vanishes.  After the Gram matrix G = Y^dag
+   Y has been formed with a single batched reduction, the s inner
+   iterations only update coordinate vectors of length 2m+1 and need
+   no further global communication.  The monomial basis (rho_j = A^j)
+   quickly becomes ill conditioned, so by default we use a Chebyshev
+   basis on an estimate of the spectral interval.
+ */
+
+namespace quda {
+
+  /**
+     @brief Recurrence coefficients of the s-step basis polynomials
+   */
+  struct CABasis {
+    std::vector<double> sub, diag, sup;
+
+    CABasis(QudaCABasis type, int degree, double lambda_min, double lambda_max)
+      : sub(degree, 1.0), diag(degree, 0.0), sup(degree, 0.0)
+    {
+      if (type == QUDA_POWER_BASIS) return;
+
+      if (lambda_max <= lambda_min)
+	errorQuda("Invalid spectral interval [%e, %e] for the s-step basis", lambda_min, lambda_max);
+      const double c = 0.5 * (lambda_max + lambda_min);
+      const double h = 0.5 * (lambda_max - lambda_min);
+
+      switch (type) {
+      case QUDA_NEWTON_BASIS:
+	{
+	  // the shifts are the Chebyshev points of the interval in Leja order
+	  std::vector<double> theta(degree);
+	  for (int i=0; i<degree; i++) theta[i] = c + h * cos((2*i+1) * M_PI / (2*degree));
+	  for (int i=0; i<degree; i++) {
+	    int leja = i;
+	    double max = -std::numeric_limits<double>::max();
+	    for (int j=i; j<degree; j++) {
+	      double dist = 0.0;
+	      if (i == 0) dist = log(fabs(theta[j]));
+	      else for (int l=0; l<i; l++) dist += log(fabs(theta[j] - theta[l]));
+	      if (dist > max) { max = dist; leja = j; }
+	    }
+	    std::swap(theta[i], theta[leja]);
+	    diag[i] = theta[i];
+	  }
+	}
+	break;
+      case QUDA_CHEBYSHEV_BASIS:
+	// T_0 = 1, T_1 = (A - c)/h, T_{k+1} = 2 (A - c)/h T_k - T_{k-1}
+	for (int k=0; k<degree; k++) {
+	  sub[k] = k == 0 ? h : 0.5 * h;
+	  diag[k] = c;
+	  sup[k] = k == 0 ? 0.0 : 0.5 * h;
+	}
+	break;
+      default:
+	errorQuda("Unsupported s-step basis %d", type);
+      }
+    }
+
+    /**
+       @brief Generate v[offset+1], ..., v[offset+n] from v[offset]
+     */
+    void generate(const DiracMatrix &mat, std::vector<ColorSpinorField*> &v, int offset, int n,
+		  ColorSpinorField &tmp, ColorSpinorField &tmp2) const
+    {
+      for (int k=0; k<n; k++) {
+	ColorSpinorField &vk = *v[offset+k];
+	ColorSpinorField &vk1 = *v[offset+k+1];
+	mat(vk1, vk, tmp, tmp2);
+	if (diag[k] != 0.0 || sub[k] != 1.0) blas::axpby(-diag[k]/sub[k], vk, 1.0/sub[k], vk1);
+	if (sup[k] != 0.0) blas::axpy(-sup[k]/sub[k], *v[offset+k-1], vk1);
+      }
+    }
+
+    /**
+       @brief Accumulate the action of the change-of-basis matrix on
+       the coordinates of the basis block of length n starting at
+       offset: out += T in
+     */
+    void apply(Complex *out, const Complex *in, int offset, int n) const
+    {
+      for (int k=0; k<n-1; k++) {
+	const Complex c = in[offset+k];
+	out[offset+k+1] += sub[k] * c;
+	out[offset+k] += diag[k] * c;
+	if (k > 0) out[offset+k-1] += sup[k] * c;
+      }
+    }
+  };
+
+  /**
+     @brief Compute the Gram matrix G[i*n+j] = (W[i], W[j]) of a set
+     of vectors using a single batched global reduction
+   */
+  static void computeGram(std::vector<Complex> &G, std::vector<ColorSpinorField*> &W)
+  {
+    const int n = W.size();
+    std::vector<Complex> dot(n*n);
+    blas::hDotProduct(dot.data(), W, W);
+    G.resize(n*n);
+    for (int i=0; i<n; i++)
+      for (int j=0; j<n; j++) G[i*n+j] = dot[j*n+i];
+  }
+
+  /**
+     @brief Return u^dag G v for coordinate vectors u and v of length
+     n, where G has leading dimension ld
+   */
+  static Complex gramDot(const std::vector<Complex> &u, const std::vector<Complex> &G, const std::vector<Complex> &v,
+			 int n, int ld)
+  {
+    Complex sum = 0.0;
+    for (int i=0; i<n; i++) {
+      if (u[i] == 0.0) continue;
+      Complex Gv = 0.0;
+      for (int j=0; j<n; j++) Gv += G[i*ld+j] * v[j];
+      sum += conj(u[i]) * Gv;
+    }
+    return sum;
+  }
+
+  /**
+     @brief Estimate the largest eigenvalue magnitude of mat with a
+     few power iterations starting from v.  Av is used as workspace.
+   */
+  static double estimateLambdaMax(const DiracMatrix &mat, ColorSpinorField &v, ColorSpinorField &Av,
+				  ColorSpinorField &tmp, ColorSpinorField &tmp2, int niter)
+  {
+    double lambda = 0.0;
+    blas::ax(1.0/sqrt(blas::norm2(v)), v);
+    for (int i=0; i<niter; i++) {
+      mat(Av, v, tmp, tmp2);
+      lambda = sqrt(blas::norm2(Av));
+      blas::copy(v, Av);
+      blas::ax(1.0/lambda, v);
+    }
+    return lambda;
+  }
+
+  /**
+     @brief Project the coordinates back onto the basis: x += V xc,
+     r = V rc, p = V pc
+   */
+  static void reconstruct(ColorSpinorField &x, ColorSpinorField &r, ColorSpinorField &p,
+			  std::vector<ColorSpinorField*> &V, const std::vector<Complex> &xc,
+			  const std::vector<Complex> &rc, const std::vector<Complex> &pc)
+  {
+    const int n = V.size();
+
+    std::vector<ColorSpinorField*> x_;
+    x_.push_back(&x);
+    blas::caxpy(xc.data(), V, x_);
+
+    std::vector<Complex> c(2*n);
+    for (int i=0; i<n; i++) { c[2*i+0] = rc[i]; c[2*i+1] = pc[i]; }
+    std::vector<ColorSpinorField*> rp_;
+    rp_.push_back(&r);
+    rp_.push_back(&p);
+    blas::zero(r);
+    blas::zero(p);
+    blas::caxpy(c.data(), V, rp_);
+  }
+
+  // number of power iterations used to estimate lambda_max
+  static constexpr int ca_power_iter = 20;
+
+  CACG::CACG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy), init(false) {
+  }
+
+  CACG::~CACG() {
+    if ( init ) {
+      for (auto v : V) delete v;
+      delete rp;
+      delete yp;
+      delete pp;
+      delete tmpp;
+      init = false;
+    }
+  }
+
+  void CACG::operator()(ColorSpinorField &x, ColorSpinorField &b) {
+    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
+      errorQuda("Not supported");
+
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL)
+      errorQuda("Heavy-quark residual not supported by CACG");
+
+    const int s = param.Nsteps;
+    if (s < 1 || s > 16) errorQuda("Invalid number of s-steps %d", s);
+    const int n = 2*s + 1; // dimension of the s-step basis
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    double b2 = blas::norm2(b);
+
+    // Check to see that we're not trying to invert on a zero-field source
+    if (b2 == 0 && param.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    ColorSpinorParam csParam(x);
+    if (!init) {
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      rp = ColorSpinorField::Create(b, csParam);
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      yp = ColorSpinorField::Create(b, csParam);
+      // sloppy fields
+      csParam.setPrecision(param.precision_sloppy);
+      pp = ColorSpinorField::Create(csParam);
+      tmpp = ColorSpinorField::Create(csParam);
+
+      init = true;
+    }
+
+    if ((int)V.size() != n) {
+      for (auto v : V) delete v;
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      csParam.setPrecision(param.precision_sloppy);
+      V.resize(n);
+      for (auto &v : V) v = ColorSpinorField::Create(csParam);
+    }
+
+    ColorSpinorField &r = *rp;
+    ColorSpinorField &y = *yp;
+    ColorSpinorField &p = *pp;
+    ColorSpinorField &tmp = *tmpp;
+
+    csParam.setPrecision(param.precision_sloppy);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    // tmp2 only needed for multi-gpu Wilson-like kernels
+    ColorSpinorField *tmp2_p = !mat.isStaggered() ? ColorSpinorField::Create(x, csParam) : &tmp;
+    ColorSpinorField &tmp2 = *tmp2_p;
+
+    // additional high-precision temporary if Wilson and mixed-precision
+    csParam.setPrecision(param.precision);
+    ColorSpinorField *tmp3_p = (x.Precision() != param.precision_sloppy && !mat.isStaggered()) ?
+      ColorSpinorField::Create(x, csParam) : &tmp;
+    ColorSpinorField &tmp3 = *tmp3_p;
+
+    // compute initial residual
+    mat(r, x, y, tmp3);
+    double r2 = blas::xmyNorm(b, r);
+    if (b2 == 0) {
+      b2 = r2;
+    }
+
+    csParam.setPrecision(param.precision_sloppy);
+    ColorSpinorField *r_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      r_sloppy = &r;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      r_sloppy = ColorSpinorField::Create(r, csParam);
+    }
+
+    ColorSpinorField *x_sloppy;
+    if (param.precision_sloppy == x.Precision() ||
+        !param.use_sloppy_partial_accumulator) {
+      x_sloppy = &x;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      x_sloppy = ColorSpinorField::Create(x, csParam);
+    }
+
+    ColorSpinorField &xSloppy = *x_sloppy;
+    ColorSpinorField &rSloppy = *r_sloppy;
+
+    if (&x != &xSloppy) {
+      blas::copy(y, x);
+      blas::zero(xSloppy);
+    } else {
+      blas::zero(y);
+    }
+
+    blas::copy(p, rSloppy);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    const double stop = stopping(param.tol, b2, param.residual_type);  // stopping condition of solver
+
+    int rUpdate = 0;
+    int nReduce = 0; // number of global reductions in the iteration
+    int nOuter = 0;  // number of s-step blocks
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+
+    const int maxResIncrease = param.max_res_increase;
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+    int resIncrease = 0;
+    int resIncreaseTotal = 0;
+
+    // coordinates with respect to the s-step basis and the Gram matrix
+    std::vector<Complex> G(n*n), xc(n), rc(n), pc(n), Tp(n);
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    int k = 0;
+
+    PrintStats("CACG", k, r2, b2, 0.0);
+    bool converged = convergence(r2, 0.0, stop, param.tol_hq);
+
+    if (!converged && param.ca_basis != QUDA_POWER_BASIS && param.ca_lambda_max <= 0.0) {
+      blas::copy(*V[0], rSloppy);
+      param.ca_lambda_max = 1.1 * estimateLambdaMax(matSloppy, *V[0], *V[1], tmp, tmp2, ca_power_iter);
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("CACG: estimated lambda_max = %e\n", param.ca_lambda_max);
+    }
+    const CABasis basis(param.ca_basis, s, param.ca_lambda_min, param.ca_lambda_max);
+
+    bool restarted = false;
+
+    while ( !converged && k < param.maxiter ) {
+
+      // generate the basis [P, R] from p and r
+      blas::copy(*V[0], p);
+      basis.generate(matSloppy, V, 0, s, tmp, tmp2);
+      blas::copy(*V[s+1], rSloppy);
+      basis.generate(matSloppy, V, s+1, s-1, tmp, tmp2);
+
+      computeGram(G, V);
+      nReduce++;
+
+      std::fill(xc.begin(), xc.end(), 0.0);
+      std::fill(rc.begin(), rc.end(), 0.0);
+      std::fill(pc.begin(), pc.end(), 0.0);
+      pc[0] = 1.0;
+      rc[s+1] = 1.0;
+
+      bool breakdown = false;
+      int j = 0;
+      for ( ; j<s && k<param.maxiter; j++) {
+	std::fill(Tp.begin(), Tp.end(), 0.0);
+	basis.apply(Tp.data(), pc.data(), 0, s+1);
+	basis.apply(Tp.data(), pc.data(), s+1, s);
+
+	const double pAp = real(gramDot(pc, G, Tp, n, n));
+	if (pAp <= 0.0) { breakdown = true; break; }
+
+	const double alpha = r2 / pAp;
+	for (int i=0; i<n; i++) {
+	  xc[i] += alpha * pc[i];
+	  rc[i] -= alpha * Tp[i];
+	}
+	k++;
+
+	const double r2_new = real(gramDot(rc, G, rc, n, n));
+	if (r2_new <= 0.0) { breakdown = true; break; }
+
+	const double beta = r2_new / r2;
+	r2 = r2_new;
+	for (int i=0; i<n; i++) pc[i] = rc[i] + beta * pc[i];
+
+	PrintStats("CACG", k, r2, b2, 0.0);
+	if (convergence(r2, 0.0, stop, param.tol_hq)) break;
+      }
+
+      reconstruct(xSloppy, rSloppy, p, V, xc, rc, pc);
+      nOuter++;
+
+      if (breakdown && j == 0 && restarted) {
+	warningQuda("CACG: unrecoverable breakdown of the s-step basis, exiting");
+	break;
+      }
+
+      // reliable update conditions
+      rNorm = sqrt(r2);
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+      bool updateX = (rNorm < param.delta*r0Norm && r0Norm <= maxrx);
+      bool updateR = ((rNorm < param.delta*maxrr && r0Norm <= maxrr) || updateX);
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if ( convergence(r2, 0.0, stop, param.tol_hq) && param.delta >= param.tol ) updateX = true;
+
+      restarted = false;
+      if (updateR || updateX || breakdown) {
+	blas::copy(x, xSloppy); // nop when these pointers alias
+	blas::xpy(x, y);
+	mat(r, y, x, tmp3); //  here we can use x as tmp
+	r2 = blas::xmyNorm(b, r);
+	nReduce++;
+
+	blas::copy(rSloppy, r); //nop when these pointers alias
+	blas::zero(xSloppy);
+
+	// break-out check if we have reached the limit of the precision
+	if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+	  resIncrease++;
+	  resIncreaseTotal++;
+	  warningQuda("CACG: new reliable residual norm %e is greater than previous reliable residual norm %e (total #inc %i)",
+		      sqrt(r2), r0Norm, resIncreaseTotal);
+	  if ( resIncrease > maxResIncrease or resIncreaseTotal > maxResIncreaseTotal) {
+	    warningQuda("CACG: solver exiting due to too many true residual norm increases");
+	    break;
+	  }
+	} else {
+	  resIncrease = 0;
+	}
+
+	if (breakdown) {
+	  warningQuda("CACG: breakdown of the s-step basis at iteration %d, restarting", k);
+	  blas::copy(p, rSloppy);
+	  restarted = true;
+	}
+
+	rNorm = sqrt(r2);
+	r0Norm = rNorm;
+	maxrr = rNorm;
+	maxrx = rNorm;
+	rUpdate++;
+      }
+
+      converged = convergence(r2, 0.0, stop, param.tol_hq);
+    }
+
+    blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops())*1e-9;
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k >= param.maxiter)
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("CACG: %d iterations in %d blocks of s = %d, %d global reductions, %d reliable updates\n",
+		 k, nOuter, s, nReduce, rUpdate);
+
+    if (param.compute_true_res) {
+      // compute the true residuals
+      mat(r, x, y, tmp3);
+      param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+      param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x, r).z);
+    }
+
+    PrintSummary("CACG", k, r2, b2);
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (&tmp3 != &tmp) delete tmp3_p;
+    if (&tmp2 != &tmp) delete tmp2_p;
+
+    if (&rSloppy != &r) delete r_sloppy;
+    if (&xSloppy != &x) delete x_sloppy;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+
+    return;
+  }
+
+  CABiCGstab::CABiCGstab(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy), init(false) {
+  }
+
+  CABiCGstab::~CABiCGstab() {
+    if ( init ) {
+      for (auto v : V) delete v;
+      delete rp;
+      delete yp;
+      delete pp;
+      delete r0p;
+      delete tmpp;
+      init = false;
+    }
+  }
+
+  void CABiCGstab::operator()(ColorSpinorField &x, ColorSpinorField &b) {
+    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
+      errorQuda("Not supported");
+
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL)
+      errorQuda("Heavy-quark residual not supported by CABiCGstab");
+
+    const int s = param.Nsteps;
+    if (s < 1 || s > 8) errorQuda("Invalid number of s-steps %d", s);
+    const int n = 4*s + 1; // dimension of the s-step basis
+    const int m = n + 1;   // the Gram matrix also includes the shadow residual
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    double b2 = blas::norm2(b);
+
+    // Check to see that we're not trying to invert on a zero-field source
+    if (b2 == 0 && param.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    ColorSpinorParam csParam(x);
+    if (!init) {
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      rp = ColorSpinorField::Create(b, csParam);
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      yp = ColorSpinorField::Create(b, csParam);
+      // sloppy fields
+      csParam.setPrecision(param.precision_sloppy);
+      pp = ColorSpinorField::Create(csParam);
+      r0p = ColorSpinorField::Create(csParam);
+      tmpp = ColorSpinorField::Create(csParam);
+
+      init = true;
+    }
+
+    if ((int)V.size() != n) {
+      for (auto v : V) delete v;
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      csParam.setPrecision(param.precision_sloppy);
+      V.resize(n);
+      for (auto &v : V) v = ColorSpinorField::Create(csParam);
+    }
+
+    ColorSpinorField &r = *rp;
+    ColorSpinorField &y = *yp;
+    ColorSpinorField &p = *pp;
+    ColorSpinorField &r0 = *r0p;
+    ColorSpinorField &tmp = *tmpp;
+
+    csParam.setPrecision(param.precision_sloppy);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    // tmp2 only needed for multi-gpu Wilson-like kernels
+    ColorSpinorField *tmp2_p = !mat.isStaggered() ? ColorSpinorField::Create(x, csParam) : &tmp;
+    ColorSpinorField &tmp2 = *tmp2_p;
+
+    // additional high-precision temporary if Wilson and mixed-precision
+    csParam.setPrecision(param.precision);
+    ColorSpinorField *tmp3_p = (x.Precision() != param.precision_sloppy && !mat.isStaggered()) ?
+      ColorSpinorField::Create(x, csParam) : &tmp;
+    ColorSpinorField &tmp3 = *tmp3_p;
+
+    // compute initial residual
+    mat(r, x, y, tmp3);
+    double r2 = blas::xmyNorm(b, r);
+    if (b2 == 0) {
+      b2 = r2;
+    }
+
+    csParam.setPrecision(param.precision_sloppy);
+    ColorSpinorField *r_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      r_sloppy = &r;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      r_sloppy = ColorSpinorField::Create(r, csParam);
+    }
+
+    ColorSpinorField *x_sloppy;
+    if (param.precision_sloppy == x.Precision() ||
+        !param.use_sloppy_partial_accumulator) {
+      x_sloppy = &x;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      x_sloppy = ColorSpinorField::Create(x, csParam);
+    }
+
+    ColorSpinorField &xSloppy = *x_sloppy;
+    ColorSpinorField &rSloppy = *r_sloppy;
+
+    if (&x != &xSloppy) {
+      blas::copy(y, x);
+      blas::zero(xSloppy);
+    } else {
+      blas::zero(y);
+    }
+
+    blas::copy(p, rSloppy);
+    blas::copy(r0, rSloppy);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    const double stop = stopping(param.tol, b2, param.residual_type);  // stopping condition of solver
+
+    int rUpdate = 0;
+    int nReduce = 0; // number of global reductions in the iteration
+    int nOuter = 0;  // number of s-step blocks
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+
+    const int maxResIncrease = param.max_res_increase;
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+    int resIncrease = 0;
+    int resIncreaseTotal = 0;
+
+    // coordinates with respect to the s-step basis and the Gram matrix
+    std::vector<Complex> G(m*m), xc(n), rc(n), pc(n), qc(n), Tp(n), Tq(n);
+
+    // the basis followed by the shadow residual, for the Gram matrix
+    std::vector<ColorSpinorField*> W(V);
+    W.push_back(&r0);
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    int k = 0;
+
+    PrintStats("CABiCGstab", k, r2, b2, 0.0);
+    bool converged = convergence(r2, 0.0, stop, param.tol_hq);
+
+    if (!converged && param.ca_basis != QUDA_POWER_BASIS && param.ca_lambda_max <= 0.0) {
+      blas::copy(*V[0], rSloppy);
+      param.ca_lambda_max = 1.1 * estimateLambdaMax(matSloppy, *V[0], *V[1], tmp, tmp2, ca_power_iter);
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("CABiCGstab: estimated lambda_max = %e\n", param.ca_lambda_max);
+    }
+    const CABasis basis(param.ca_basis, 2*s, param.ca_lambda_min, param.ca_lambda_max);
+
+    // (r0, v) for a coordinate vector v
+    auto shadowDot = [&](const std::vector<Complex> &v) {
+      Complex sum = 0.0;
+      for (int i=0; i<n; i++) sum += G[n*m+i] * v[i];
+      return sum;
+    };
+
+    bool restarted = false;
+
+    while ( !converged && k < param.maxiter ) {
+
+      // generate the basis [P, R] from p and r
+      blas::copy(*V[0], p);
+      basis.generate(matSloppy, V, 0, 2*s, tmp, tmp2);
+      blas::copy(*V[2*s+1], rSloppy);
+      basis.generate(matSloppy, V, 2*s+1, 2*s-1, tmp, tmp2);
+
+      computeGram(G, W);
+      nReduce++;
+
+      std::fill(xc.begin(), xc.end(), 0.0);
+      std::fill(rc.begin(), rc.end(), 0.0);
+      std::fill(pc.begin(), pc.end(), 0.0);
+      pc[0] = 1.0;
+      rc[2*s+1] = 1.0;
+
+      Complex rho = shadowDot(rc);
+
+      bool breakdown = false;
+      int j = 0;
+      for ( ; j<s && k<param.maxiter; j++) {
+	std::fill(Tp.begin(), Tp.end(), 0.0);
+	basis.apply(Tp.data(), pc.data(), 0, 2*s+1);
+	basis.apply(Tp.data(), pc.data(), 2*s+1, 2*s);
+
+	const Complex r0Ap = shadowDot(Tp);
+	if (abs(r0Ap) == 0.0) { breakdown = true; break; }
+	const Complex alpha = rho / r0Ap;
+
+	for (int i=0; i<n; i++) qc[i] = rc[i] - alpha * Tp[i];
+	std::fill(Tq.begin(), Tq.end(), 0.0);
+	basis.apply(Tq.data(), qc.data(), 0, 2*s+1);
+	basis.apply(Tq.data(), qc.data(), 2*s+1, 2*s);
+
+	const double Aq2 = real(gramDot(Tq, G, Tq, n, m));
+	if (Aq2 <= 0.0) { breakdown = true; break; }
+	const Complex omega = gramDot(Tq, G, qc, n, m) / Aq2;
+	if (abs(omega) == 0.0) { breakdown = true; break; }
+
+	for (int i=0; i<n; i++) {
+	  xc[i] += alpha * pc[i] + omega * qc[i];
+	  rc[i] = qc[i] - omega * Tq[i];
+	}
+	k++;
+
+	const Complex rho_new = shadowDot(rc);
+	const Complex beta = (rho_new / rho) * (alpha / omega);
+	for (int i=0; i<n; i++) pc[i] = rc[i] + beta * (pc[i] - omega * Tp[i]);
+	rho = rho_new;
+
+	r2 = real(gramDot(rc, G, rc, n, m));
+	if (r2 <= 0.0) { breakdown = true; break; }
+
+	PrintStats("CABiCGstab", k, r2, b2, 0.0);
+	if (convergence(r2, 0.0, stop, param.tol_hq)) break;
+      }
+
+      reconstruct(xSloppy, rSloppy, p, V, xc, rc, pc);
+      nOuter++;
+
+      if (breakdown && j == 0 && restarted) {
+	warningQuda("CABiCGstab: unrecoverable breakdown of the s-step basis, exiting");
+	break;
+      }
+
+      // reliable update conditions
+      rNorm = sqrt(r2);
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+      bool updateX = (rNorm < param.delta*r0Norm && r0Norm <= maxrx);
+      bool updateR = ((rNorm < param.delta*maxrr && r0Norm <= maxrr) || updateX);
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if ( convergence(r2, 0.0, stop, param.tol_hq) && param.delta >= param.tol ) updateX = true;
+
+      restarted = false;
+      if (updateR || updateX || breakdown) {
+	blas::copy(x, xSloppy); // nop when these pointers alias
+	blas::xpy(x, y);
+	mat(r, y, x, tmp3); //  here we can use x as tmp
+	r2 = blas::xmyNorm(b, r);
+	nReduce++;
+
+	blas::copy(rSloppy, r); //nop when these pointers alias
+	blas::zero(xSloppy);
+
+	// break-out check if we have reached the limit of the precision
+	if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+	  resIncrease++;
+	  resIncreaseTotal++;
+	  warningQuda("CABiCGstab: new reliable residual norm %e is greater than previous reliable residual norm %e (total #inc %i)",
+		      sqrt(r2), r0Norm, resIncreaseTotal);
+	  if ( resIncrease > maxResIncrease or resIncreaseTotal > maxResIncreaseTotal) {
+	    warningQuda("CABiCGstab: solver exiting due to too many true residual norm increases");
+	    break;
+	  }
+	} else {
+	  resIncrease = 0;
+	}
+
+	if (breakdown) {
+	  // restart with a new shadow residual
+	  warningQuda("CABiCGstab: breakdown at iteration %d, restarting", k);
+	  blas::copy(p, rSloppy);
+	  blas::copy(r0, rSloppy);
+	  restarted = true;
+	}
+
+	rNorm = sqrt(r2);
+	r0Norm = rNorm;
+	maxrr = rNorm;
+	maxrx = rNorm;
+	rUpdate++;
+      }
+
+      converged = convergence(r2, 0.0, stop, param.tol_hq);
+    }
+
+    blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops())*1e-9;
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k >= param.maxiter)
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("CABiCGstab: %d iterations in %d blocks of s = %d, %d global reductions, %d reliable updates\n",
+		 k, nOuter, s, nReduce, rUpdate);
+
+    if (param.compute_true_res) {
+      // compute the true residuals
+      mat(r, x, y, tmp3);
+      param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+      param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x, r).z);
+    }
+
+    PrintSummary("CABiCGstab", k, r2, b2);
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (&tmp3 != &tmp) delete tmp3_p;
+    if (&tmp2 != &tmp) delete tmp2_p;
+
+    if (&rSloppy != &r) delete r_sloppy;
+    if (&xSloppy != &x) delete x_sloppy;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+
+    return;
+  }
+
+} // namespace quda
@@ -19,51 +19,46 @@ namespace quda {
 #ifdef EIGEN
 
   /**
-     @brief Solve the equation A p_k psi_k = b by minimizing the
-     residual and using Eigen's SVD algorithm for numerical stability
+     @brief Solve the N x N Hermitian system A psi = phi on the host
+     using Eigen's SVD algorithm for numerical stability
 
      @param psi[out] Array of coefficients
-     @param p[in] Search direction vectors
-     @param q[in] Search direction vectors with the operator applied
+     @param A[in] The matrix (row major)
+     @param phi[in] The right hand side
+     @param N[in] The dimension of the system
   */
-  void solve(Complex *psi_, std::vector<ColorSpinorField*> &p, std::vector<ColorSpinorField*> &q, ColorSpinorField &b) {
+  static void solve(Complex *psi_, const Complex *A_, const Complex *phi_, int N) {
 
     using namespace Eigen;
     typedef Matrix<Complex, Dynamic, Dynamic> matrix;
     typedef Matrix<Complex, Dynamic, 1> vector;
 
-    vector phi(p.size()), psi(p.size());
-    matrix A(p.size(),p.size());
+    vector phi(N), psi(N);
+    matrix A(N,N);
 
-    for (unsigned int i=0; i<p.size(); i++) phi(i) = blas::cDotProduct(*p[i], b);
-
-    // Construct the matrix
-    for (unsigned int j=0; j<p.size(); j++) {
-      A(j,j) = blas::cDotProduct(*q[j], *p[j]);
-      for (unsigned int k=j+1; k<p.size(); k++) {
-	A(j,k) = blas::cDotProduct(*p[j], *q[k]);
-	A(k,j) = conj(A(j,k));
-      }
+    for (int j=0; j<N; j++) {
+      phi(j) = phi_[j];
+      for (int k=0; k<N; k++) A(j,k) = A_[j*N+k];
     }
+
     JacobiSVD<matrix> svd(A, ComputeThinU | ComputeThinV);
     psi = svd.solve(phi);
 
-    for (unsigned int i=0; i<p.size(); i++) psi_[i] = psi(i);
+    for (int i=0; i<N; i++) psi_[i] = psi(i);
   }
 
 #else
 
   /**
-     @brief Solve the equation A p_k psi_k = b by minimizing the
-     residual and using Gaussian elimination
+     @brief Solve the N x N system A psi = phi on the host using
+     Gaussian elimination
 
      @param psi[out] Array of coefficients
-     @param p[in] Search direction vectors
-     @param q[in] Search direction vectors with the operator applied
+     @param A[in] The matrix (row major)
+     @param phi[in] The right hand side
+     @param N[in] The dimension of the system
   */
-  void solve(Complex *psi, std::vector<ColorSpinorField*> &p, std::vector<ColorSpinorField*> &q, ColorSpinorField &b) {
-
-    const int N = p.size();
+  static void solve(Complex *psi, const Complex *A_, const Complex *phi_, int N) {
 
     // Array to hold the matrix elements
     Complex **A = new Complex*[N];
@@ -72,16 +67,9 @@ namespace quda {
     // Solution and source vectors
     Complex *phi = new Complex[N];
 
-    // construct right hand side
-    for (unsigned int i=0; i<p.size(); i++) phi[i] = blas::cDotProduct(*p[i], b);
-
-    // Construct the matrix
-    for (unsigned int j=0; j<p.size(); j++) {
-      A[j][j] = blas::cDotProduct(*q[j], *p[j]);
-      for (unsigned int k=j+1; k<p.size(); k++) {
-	A[j][k] = blas::cDotProduct(*p[j], *q[k]);
-	A[k][j] = conj(A[j][k]);
-      }
+    for (int j=0; j<N; j++) {
+      phi[j] = phi_[j];
+      for (int k=0; k<N; k++) A[j][k] = A_[j*N+k];
     }
 
     // Gauss-Jordan elimination with partial pivoting
@@ -118,6 +106,34 @@ namespace quda {
 
 #endif // EIGEN
 
+  /**
+     @brief Solve the equation A p_k psi_k = b by minimizing the
+     residual
+
+     @param psi[out] Array of coefficients
+     @param p[in] Search direction vectors
+     @param q[in] Search direction vectors with the operator applied
+  */
+  void solve(Complex *psi, std::vector<ColorSpinorField*> &p, std::vector<ColorSpinorField*> &q, ColorSpinorField &b) {
+
+    const int N = p.size();
+    std::vector<Complex> A(N*N), phi(N);
+
+    // construct right hand side
+    for (int i=0; i<N; i++) phi[i] = blas::cDotProduct(*p[i], b);
+
+    // Construct the matrix
+    for (int j=0; j<N; j++) {
+      A[j*N+j] = blas::cDotProduct(*q[j], *p[j]);
+      for (int k=j+1; k<N; k++) {
+	A[j*N+k] = blas::cDotProduct(*p[j], *q[k]);
+	A[k*N+j] = conj(A[j*N+k]);
+      }
+    }
+
+    solve(psi, A.data(), phi.data(), N);
+  }
+
 
   /*
     We want to find the best initial guess of the solution of
@@ -206,6 +222,74 @@ namespace quda {
     (*this)(x, b, p, q);
   }
 
+  /*
+    As above, but the basis vectors are expanded into p one at a time
+    and the matrix G_ij is built column by column, so that only two
+    vectors of the precision of x are needed regardless of N.  Since
+    the basis is not orthonormalized, the system is rescaled to unit
+    diagonal before it is solved.
+  */
+  void MinResExt::operator()(ColorSpinorField &x, ColorSpinorField &b, const std::vector<ColorSpinorField*> &basis,
+			     ColorSpinorField &p, ColorSpinorField &q) {
 
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    const int N = basis.size();
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Constructing minimum residual extrapolation with basis size %d\n", N);
+
+    if (N == 0) {
+      blas::zero(x);
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      return;
+    }
+
+    std::vector<Complex> A(N*N), phi(N), alpha(N);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    const double b2 = blas::norm2(b);
+
+    // A_ij = (p_i, A p_j): the upper triangle is formed from column j,
+    // while p_j and A p_j are resident, and A is Hermitian
+    for (int j=0; j<N; j++) {
+      p = *basis[j];
+      mat(q, p);
+      phi[j] = blas::cDotProduct(p, b);
+      A[j*N+j] = blas::cDotProduct(p, q);
+      for (int i=0; i<j; i++) {
+	if (basis[i]->Precision() == q.Precision()) {
+	  A[i*N+j] = blas::cDotProduct(*basis[i], q);
+	} else {
+	  p = *basis[i];
+	  A[i*N+j] = blas::cDotProduct(p, q);
+	}
+	A[j*N+i] = conj(A[i*N+j]);
+      }
+    }
+
+    // rescale to unit diagonal, since the basis is not normalized
+    std::vector<double> d(N);
+    for (int i=0; i<N; i++) d[i] = A[i*N+i].real() > 0.0 ? 1.0 / sqrt(A[i*N+i].real()) : 1.0;
+    for (int i=0; i<N; i++) {
+      phi[i] *= d[i];
+      for (int j=0; j<N; j++) A[i*N+j] *= d[i] * d[j];
+    }
+
+    solve(alpha.data(), A.data(), phi.data(), N);
+
+    blas::zero(x);
+    for (int i=0; i<N; i++) blas::caxpy(alpha[i] * d[i], *basis[i], x);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      // the true residual costs one more application of the operator
+      mat(q, x);
+      double r2 = blas::xmyNorm(b, q);
+      printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, sqrt(r2 / b2));
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+  }
 
 } // namespace quda
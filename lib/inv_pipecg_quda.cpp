@@ -0,0 +1,334 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+#include <quda_internal.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <dslash_quda.h>
+#include <invert_quda.h>
+#include <util_quda.h>
+
+/**
+   Pipelined CG (P. Ghysels and W. Vanroose, Parallel Computing 40,
+   224 (2014)).  In addition to the usual CG vectors we carry
+
+     w = A r,  s = A p,  z = A s = A^2 p,  q = A w
+
+   which lets the two inner products (r,r) and (w,r) of an iteration
+   be formed before the matrix-vector product q = A w rather than
+   after it.  Both are combined into a single non-blocking global
+   reduction that is in flight while q is being computed.
+
+   The extra recurrences make the recursively updated residual drift
+   from the true one faster than in standard CG, so reliable updates
+   replace r with the high-precision true residual and recompute w, s
+   and z from it and the current search direction.
+ */
+
+namespace quda {
+
+  PipelinedCG::PipelinedCG(DiracMatrix &mat, DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile) :
+    Solver(param, profile), mat(mat), matSloppy(matSloppy), init(false) {
+  }
+
+  PipelinedCG::~PipelinedCG() {
+    if ( init ) {
+      delete rp;
+      delete yp;
+      delete pp;
+      delete sp;
+      delete wp;
+      delete zp;
+      delete qp;
+      delete tmpp;
+      init = false;
+    }
+  }
+
+  void PipelinedCG::operator()(ColorSpinorField &x, ColorSpinorField &b) {
+    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION)
+      errorQuda("Not supported");
+
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL)
+      errorQuda("Heavy-quark residual not supported by pipelined CG");
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    double b2 = blas::norm2(b);
+
+    // Check to see that we're not trying to invert on a zero-field source
+    if (b2 == 0 && param.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      printfQuda("Warning: inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      return;
+    }
+
+    ColorSpinorParam csParam(x);
+    if (!init) {
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      rp = ColorSpinorField::Create(b, csParam);
+      csParam.create = QUDA_ZERO_FIELD_CREATE;
+      yp = ColorSpinorField::Create(b, csParam);
+      // sloppy fields
+      csParam.setPrecision(param.precision_sloppy);
+      pp = ColorSpinorField::Create(csParam);
+      sp = ColorSpinorField::Create(csParam);
+      wp = ColorSpinorField::Create(csParam);
+      zp = ColorSpinorField::Create(csParam);
+      qp = ColorSpinorField::Create(csParam);
+      tmpp = ColorSpinorField::Create(csParam);
+
+      init = true;
+    }
+    ColorSpinorField &r = *rp;
+    ColorSpinorField &y = *yp;
+    ColorSpinorField &p = *pp;
+    ColorSpinorField &s = *sp;
+    ColorSpinorField &w = *wp;
+    ColorSpinorField &z = *zp;
+    ColorSpinorField &q = *qp;
+    ColorSpinorField &tmp = *tmpp;
+
+    csParam.setPrecision(param.precision_sloppy);
+    csParam.create = QUDA_ZERO_FIELD_CREATE;
+
+    // tmp2 only needed for multi-gpu Wilson-like kernels
+    ColorSpinorField *tmp2_p = !mat.isStaggered() ? ColorSpinorField::Create(x, csParam) : &tmp;
+    ColorSpinorField &tmp2 = *tmp2_p;
+
+    // additional high-precision temporary if Wilson and mixed-precision
+    csParam.setPrecision(param.precision);
+    ColorSpinorField *tmp3_p = (x.Precision() != param.precision_sloppy && !mat.isStaggered()) ?
+      ColorSpinorField::Create(x, csParam) : &tmp;
+    ColorSpinorField &tmp3 = *tmp3_p;
+
+    // compute initial residual
+    mat(r, x, y, tmp3);
+    double r2 = blas::xmyNorm(b, r);
+    if (b2 == 0) {
+      b2 = r2;
+    }
+
+    csParam.setPrecision(param.precision_sloppy);
+    ColorSpinorField *r_sloppy;
+    if (param.precision_sloppy == x.Precision()) {
+      r_sloppy = &r;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      r_sloppy = ColorSpinorField::Create(r, csParam);
+    }
+
+    ColorSpinorField *x_sloppy;
+    if (param.precision_sloppy == x.Precision() ||
+        !param.use_sloppy_partial_accumulator) {
+      x_sloppy = &x;
+    } else {
+      csParam.create = QUDA_COPY_FIELD_CREATE;
+      x_sloppy = ColorSpinorField::Create(x, csParam);
+    }
+
+    ColorSpinorField &xSloppy = *x_sloppy;
+    ColorSpinorField &rSloppy = *r_sloppy;
+
+    if (&x != &xSloppy) {
+      blas::copy(y, x);
+      blas::zero(xSloppy);
+    } else {
+      blas::zero(y);
+    }
+
+    // the first iteration has beta = 0, so the recurrences must start from zero
+    blas::zero(p);
+    blas::zero(s);
+    blas::zero(z);
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    const double stop = stopping(param.tol, b2, param.residual_type);  // stopping condition of solver
+
+    double alpha = 0.0, alpha_old = 0.0;
+    double beta = 0.0;
+    double gamma = r2, gamma_old = 0.0;  // (r,r)
+    double delta = 0.0;  // (w,r)
+    int rUpdate = 0;
+
+    double rNorm = sqrt(r2);
+    double r0Norm = rNorm;
+    double maxrx = rNorm;
+    double maxrr = rNorm;
+
+    const int maxResIncrease = param.max_res_increase;
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+    int resIncrease = 0;
+    int resIncreaseTotal = 0;
+
+    // the local sums are formed with global reductions disabled and
+    // then reduced explicitly, honouring the caller's setting
+    const bool global_reduction = commGlobalReduction();
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    // w = A r
+    matSloppy(w, rSloppy, tmp, tmp2);
+
+    int k = 0;
+    int steps_since_reliable = 1;
+    bool restart = true; // no previous search direction to build on
+
+    PrintStats("PipelinedCG", k, r2, b2, 0.0);
+    bool converged = convergence(r2, 0.0, stop, param.tol_hq);
+
+    while ( !converged && k < param.maxiter ) {
+
+      // local contributions to gamma = (r,r) and delta = (w,r)
+      commGlobalReductionSet(false);
+      double2 rw = blas::reDotProductNormA(rSloppy, w);
+      commGlobalReductionSet(global_reduction);
+
+      double sum[2] = { rw.y, rw.x };
+      MsgHandle *mh = reduceDoubleArrayAsync(sum, 2);
+
+      // q = A w, overlapped with the reduction
+      matSloppy(q, w, tmp, tmp2);
+
+      reduceDoubleArrayWait(mh);
+      gamma = sum[0];
+      delta = sum[1];
+
+      r2 = gamma;
+      rNorm = sqrt(r2);
+
+      // reliable update conditions
+      if (rNorm > maxrx) maxrx = rNorm;
+      if (rNorm > maxrr) maxrr = rNorm;
+      int updateX = (rNorm < param.delta*r0Norm && r0Norm <= maxrx) ? 1 : 0;
+      int updateR = ((rNorm < param.delta*maxrr && r0Norm <= maxrr) || updateX) ? 1 : 0;
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if ( convergence(r2, 0.0, stop, param.tol_hq) && param.delta >= param.tol && steps_since_reliable > 0 ) updateX = 1;
+
+      if ( (updateR || updateX) && steps_since_reliable > 0 ) {
+
+        blas::copy(x, xSloppy); // nop when these pointers alias
+        blas::xpy(x, y);
+        mat(r, y, x, tmp3); //  here we can use x as tmp
+        r2 = blas::xmyNorm(b, r);
+
+        blas::copy(rSloppy, r); //nop when these pointers alias
+        blas::zero(xSloppy);
+
+        // break-out check if we have reached the limit of the precision
+        if (sqrt(r2) > r0Norm && updateX) { // reuse r0Norm for this
+          resIncrease++;
+          resIncreaseTotal++;
+          warningQuda("PipelinedCG: new reliable residual norm %e is greater than previous reliable residual norm %e (total #inc %i)",
+                      sqrt(r2), r0Norm, resIncreaseTotal);
+          if ( resIncrease > maxResIncrease or resIncreaseTotal > maxResIncreaseTotal) {
+            warningQuda("PipelinedCG: solver exiting due to too many true residual norm increases");
+            break;
+          }
+        } else {
+          resIncrease = 0;
+        }
+
+        // recompute the auxiliary vectors consistently with the new residual
+        matSloppy(w, rSloppy, tmp, tmp2);
+        matSloppy(s, p, tmp, tmp2);
+        matSloppy(z, s, tmp, tmp2);
+
+        steps_since_reliable = 0;
+        rNorm = sqrt(r2);
+        r0Norm = rNorm;
+        maxrr = rNorm;
+        maxrx = rNorm;
+        rUpdate++;
+
+        PrintStats("PipelinedCG", k, r2, b2, 0.0);
+        converged = convergence(r2, 0.0, stop, param.tol_hq);
+        continue; // gamma and delta must be reformed from the new residual
+      }
+
+      if (convergence(r2, 0.0, stop, param.tol_hq)) {
+        converged = true;
+        break;
+      }
+
+      if (restart) {
+        beta = 0.0;
+        alpha = gamma / delta;
+        restart = false;
+      } else {
+        beta = gamma / gamma_old;
+        alpha = gamma / (delta - beta * gamma / alpha_old);
+      }
+
+      blas::xpay(q, beta, z);        // z = q + beta z
+      blas::xpay(w, beta, s);        // s = w + beta s
+      blas::xpay(rSloppy, beta, p);  // p = r + beta p
+      blas::axpy(alpha, p, xSloppy); // x = x + alpha p
+      blas::axpy(-alpha, s, rSloppy);// r = r - alpha s
+      blas::axpy(-alpha, z, w);      // w = w - alpha z
+
+      gamma_old = gamma;
+      alpha_old = alpha;
+
+      steps_since_reliable++;
+      k++;
+
+      PrintStats("PipelinedCG", k, r2, b2, 0.0);
+    }
+
+    blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs = profile.Last(QUDA_PROFILE_COMPUTE);
+    double gflops = (blas::flops + mat.flops() + matSloppy.flops())*1e-9;
+    param.gflops = gflops;
+    param.iter += k;
+
+    if (k == param.maxiter)
+      warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("PipelinedCG: Reliable updates = %d\n", rUpdate);
+
+    if (param.compute_true_res) {
+      // compute the true residuals
+      mat(r, x, y, tmp3);
+      param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+      param.true_res_hq = sqrt(blas::HeavyQuarkResidualNorm(x, r).z);
+    }
+
+    PrintSummary("PipelinedCG", k, r2, b2);
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    profile.TPSTART(QUDA_PROFILE_FREE);
+
+    if (&tmp3 != &tmp) delete tmp3_p;
+    if (&tmp2 != &tmp) delete tmp2_p;
+
+    if (&rSloppy != &r) delete r_sloppy;
+    if (&xSloppy != &x) delete x_sloppy;
+
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+
+    return;
+  }
+
+} // namespace quda
@@ -3,6 +3,7 @@
 #include <color_spinor_field_order.h>
 #include <index_helper.cuh>
 #include <stencil.h>
+#include <stencil_index.h>
 #include <color_spinor.h>
 
 /**
@@ -30,6 +31,7 @@ namespace quda {
     const int dim[5];     // full lattice dimensions
     const int commDim[4]; // whether a given dimension is partitioned or not
     const int volumeCB;   // checkerboarded volume
+    const int *nbr;       // precomputed neighbor table (host fields only)
 
     __host__ __device__ static constexpr bool isXpay() { return xpay; }
 
@@ -38,7 +40,8 @@ namespace quda {
       : out(out), in(in), U(U), kappa(kappa), x(xpay ? *x : in), parity(parity), nParity(in.SiteSubset()), nFace(1),
 	dim{ (3-nParity) * in.X(0), in.X(1), in.X(2), in.X(3), 1 },
       commDim{comm_dim_partitioned(0), comm_dim_partitioned(1), comm_dim_partitioned(2), comm_dim_partitioned(3)},
-      volumeCB(in.VolumeCB())
+      volumeCB(in.VolumeCB()),
+      nbr(in.Location() == QUDA_CPU_FIELD_LOCATION ? getStencilIndex(dim, 4, QUDA_4D_PC, 1, nFace, commDim).Index() : nullptr)
     {
       if (in.FieldOrder() != QUDA_FLOAT2_FIELD_ORDER || !U.isNative())
       errorQuda("Unsupported field order colorspinor=%d gauge=%d combination\n", in.FieldOrder(), U.FieldOrder());
@@ -55,26 +58,25 @@ namespace quda {
      @param[in] parity The site parity
      @param[in] x_cb The checkerboarded site index
    */
-  template <typename Float, int nDim, int nColor, typename Vector, typename Arg>
+  template <typename Float, int nDim, int nColor, bool table, typename Vector, typename Arg>
   __device__ __host__ inline void applyLaplace(Vector &out, Arg &arg, int x_cb, int parity) {
     typedef Matrix<complex<Float>,nColor> Link;
     const int their_spinor_parity = (arg.nParity == 2) ? 1-parity : 0;
 
-    int coord[5];
-    getCoords(coord, x_cb, arg.dim, parity);
-    coord[4] = 0;
+    int coord[5] = { };
+    if (!table) getCoords(coord, x_cb, arg.dim, parity);
 
 #pragma unroll
     for (int d = 0; d<nDim; d++) // loop over dimension
     {
-      //Forward gather - compute fwd offset for vector fetch
-      const int fwd_idx = linkIndexP1(coord, arg.dim, d);
+      bool ghost;
 
-      if ( arg.commDim[d] && (coord[d] + arg.nFace >= arg.dim[d]) ) {
-	const int ghost_idx = ghostFaceIndex<1>(coord, arg.dim, d, arg.nFace);
+      //Forward gather - compute fwd offset for vector fetch
+      const int fwd_idx = stencilNeighbor<1,table>(ghost, coord, arg, d, x_cb, parity);
 
+      if (ghost) {
 	const Link U = arg.U(d, x_cb, parity);
-	const Vector in = arg.in.Ghost(d, 1, ghost_idx, their_spinor_parity);
+	const Vector in = arg.in.Ghost(d, 1, fwd_idx, their_spinor_parity);
 
 	out += U * in;
 	} else {
@@ -86,19 +88,16 @@ namespace quda {
       }
 
       //Backward gather - compute back offset for spinor and gauge fetch
-      const int back_idx = linkIndexM1(coord, arg.dim, d);
-      const int gauge_idx = back_idx;
+      const int back_idx = stencilNeighbor<0,table>(ghost, coord, arg, d, x_cb, parity);
 
-      if ( arg.commDim[d] && (coord[d] - arg.nFace < 0) ) {
-	const int ghost_idx = ghostFaceIndex<0>(coord, arg.dim, d, arg.nFace);
-
-	const Link U = arg.U.Ghost(d, ghost_idx, 1-parity);
-	const Vector in = arg.in.Ghost(d, 0, ghost_idx, their_spinor_parity);
+      if (ghost) {
+	const Link U = arg.U.Ghost(d, back_idx, 1-parity);
+	const Vector in = arg.in.Ghost(d, 0, back_idx, their_spinor_parity);
 
 	out += conj(U) * in;
       } else {
 	
-	const Link U = arg.U(d, gauge_idx, 1-parity);
+	const Link U = arg.U(d, back_idx, 1-parity);
 	const Vector in = arg.in(back_idx, their_spinor_parity);
 
 	out += conj(U) * in;
@@ -109,13 +108,13 @@ namespace quda {
 
 
   //out(x) = M*in = (-D + m) * in(x-mu)
-  template <typename Float, int nDim, int nColor, typename Arg>
+  template <typename Float, int nDim, int nColor, bool table, typename Arg>
   __device__ __host__ inline void laplace(Arg &arg, int x_cb, int parity)
   {
     typedef ColorSpinor<Float,nColor,1> Vector;
     Vector out;
 
-    applyLaplace<Float,nDim,nColor>(out, arg, x_cb, parity);
+    applyLaplace<Float,nDim,nColor,table>(out, arg, x_cb, parity);
 
     if (arg.isXpay()) {
       Vector x = arg.x(x_cb, parity);
@@ -133,8 +132,9 @@ namespace quda {
       // for full fields then set parity from loop else use arg setting
       parity = (arg.nParity == 2) ? parity : arg.parity;
 
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
       for (int x_cb = 0; x_cb < arg.volumeCB; x_cb++) { // 4-d volume
-	laplace<Float,nDim,nColor>(arg, x_cb, parity);
+	laplace<Float,nDim,nColor,true>(arg, x_cb, parity);
       } // 4-d volumeCB
     } // parity
 
@@ -152,7 +152,7 @@ namespace quda {
     if (x_cb >= arg.volumeCB) return;
     if (parity >= arg.nParity) return;
 
-    laplace<Float,nDim,nColor>(arg, x_cb, parity);
+    laplace<Float,nDim,nColor,false>(arg, x_cb, parity);
   }
 
   template <typename Float, int nDim, int nColor, typename Arg>
@@ -2,6 +2,9 @@
 #include <cstdio>
 #include <string>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <mutex>
 #include <unistd.h> // for getpagesize()
 #include <execinfo.h> // for backtrace
 #include <quda_internal.h>
@@ -54,6 +57,9 @@ namespace quda {
   static long total_host_bytes, max_total_host_bytes;
   static long total_pinned_bytes, max_total_pinned_bytes;
 
+  // serializes the allocation tracking so that host threads may allocate concurrently
+  static std::mutex track_mutex;
+
   long device_allocated_peak() { return max_total_bytes[DEVICE]; }
 
   long pinned_allocated_peak() { return max_total_bytes[PINNED]; }
@@ -96,6 +102,7 @@ namespace quda {
 
   static void track_malloc(const AllocType &type, const MemAlloc &a, void *ptr)
   {
+    std::lock_guard<std::mutex> lock(track_mutex);
     total_bytes[type] += a.base_size;
     if (total_bytes[type] > max_total_bytes[type]) {
       max_total_bytes[type] = total_bytes[type];
@@ -116,8 +123,16 @@ namespace quda {
   }
 
 
+  static bool is_tracked(const AllocType &type, void *ptr)
+  {
+    std::lock_guard<std::mutex> lock(track_mutex);
+    return alloc[type].count(ptr);
+  }
+
+
   static void track_free(const AllocType &type, void *ptr)
   {
+    std::lock_guard<std::mutex> lock(track_mutex);
     size_t size = alloc[type][ptr].base_size;
     total_bytes[type] -= size;
     if (type != DEVICE) {
@@ -134,7 +149,8 @@ namespace quda {
    * Under CUDA 4.0, cudaHostRegister seems to require that both the
    * beginning and end of the buffer be aligned on page boundaries.
    * This local function takes care of the alignment and gets called
-   * by pinned_malloc_() and mapped_malloc_()
+   * by pinned_malloc_() and mapped_malloc_().  Returns nullptr on
+   * failure.
    */
   static void *aligned_malloc(MemAlloc &a, size_t size)
   {
@@ -152,19 +168,35 @@ namespace quda {
     int align = posix_memalign(&ptr, page_size, a.base_size);
     if (!ptr || align != 0) {
 #endif
-      printfQuda("ERROR: Failed to allocate aligned host memory of size %zu (%s:%d in %s())\n", size, a.file.c_str(), a.line, a.func.c_str());
-      errorQuda("Aborting");
+      return nullptr;
     }
     return ptr;
   }
 
 
   /**
-   * Perform a standard cudaMalloc() with error-checking.  This
-   * function should only be called via the device_malloc() macro,
-   * defined in malloc_quda.h
+   * Register host memory from aligned_malloc() as page-locked memory
+   * with the given cudaHostRegister flags.  Returns nullptr (having
+   * released the memory) on failure.
    */
-  void *device_malloc_(const char *func, const char *file, int line, size_t size)
+  static void *aligned_register(MemAlloc &a, void *ptr, unsigned int flags)
+  {
+    cudaError_t err = cudaHostRegister(ptr, a.base_size, flags);
+    if (err != cudaSuccess) {
+      cudaGetLastError(); // clear the error state
+      free(ptr);
+      return nullptr;
+    }
+    return ptr;
+  }
+
+
+  /**
+   * Allocate device memory, returning nullptr rather than aborting on
+   * failure.  The memory pool uses this so that it can release its
+   * cache and retry before giving up.
+   */
+  static void *device_try_malloc(const char *func, const char *file, int line, size_t size)
   {
     MemAlloc a(func, file, line);
     void *ptr;
@@ -173,8 +205,8 @@ namespace quda {
 
     cudaError_t err = cudaMalloc(&ptr, size);
     if (err != cudaSuccess) {
-      printfQuda("ERROR: Failed to allocate device memory of size %zu (%s:%d in %s())\n", size, file, line, func);
-      errorQuda("Aborting");
+      cudaGetLastError(); // clear the error state
+      return nullptr;
     }
     track_malloc(DEVICE, a, ptr);
 #ifdef HOST_DEBUG
@@ -184,6 +216,59 @@ namespace quda {
   }
 
 
+  /**
+   * Allocate host memory, returning nullptr rather than aborting on
+   * failure (see device_try_malloc)
+   */
+  static void *host_try_malloc(const char *func, const char *file, int line, size_t size)
+  {
+    MemAlloc a(func, file, line);
+    a.size = a.base_size = size;
+
+    void *ptr = malloc(size);
+    if (!ptr) return nullptr;
+    track_malloc(HOST, a, ptr);
+#ifdef HOST_DEBUG
+    memset(ptr, 0xff, size);
+#endif
+    return ptr;
+  }
+
+
+  /**
+   * Allocate pinned host memory, returning nullptr rather than
+   * aborting on failure (see device_try_malloc)
+   */
+  static void *pinned_try_malloc(const char *func, const char *file, int line, size_t size)
+  {
+    MemAlloc a(func, file, line);
+    void *ptr = aligned_malloc(a, size);
+    if (ptr) ptr = aligned_register(a, ptr, cudaHostRegisterDefault);
+    if (!ptr) return nullptr;
+    track_malloc(PINNED, a, ptr);
+#ifdef HOST_DEBUG
+    memset(ptr, 0xff, a.base_size);
+#endif
+    return ptr;
+  }
+
+
+  /**
+   * Perform a standard cudaMalloc() with error-checking.  This
+   * function should only be called via the device_malloc() macro,
+   * defined in malloc_quda.h
+   */
+  void *device_malloc_(const char *func, const char *file, int line, size_t size)
+  {
+    void *ptr = device_try_malloc(func, file, line, size);
+    if (!ptr) {
+      printfQuda("ERROR: Failed to allocate device memory of size %zu (%s:%d in %s())\n", size, file, line, func);
+      errorQuda("Aborting");
+    }
+    return ptr;
+  }
+
+
   /**
    * Perform a cuMemAlloc with error-checking.  This function is to
    * guarantee a unique memory allocation on the device, since
@@ -218,18 +303,11 @@ namespace quda {
    */
   void *safe_malloc_(const char *func, const char *file, int line, size_t size)
   {
-    MemAlloc a(func, file, line);
-    a.size = a.base_size = size;
-
-    void *ptr = malloc(size);
+    void *ptr = host_try_malloc(func, file, line, size);
     if (!ptr) {
       printfQuda("ERROR: Failed to allocate host memory of size %zu (%s:%d in %s())\n", size, file, line, func);
       errorQuda("Aborting");
     }
-    track_malloc(HOST, a, ptr);
-#ifdef HOST_DEBUG
-    memset(ptr, 0xff, size);
-#endif
     return ptr;
   }
 
@@ -245,18 +323,11 @@ namespace quda {
    */
   void *pinned_malloc_(const char *func, const char *file, int line, size_t size)
   {
-    MemAlloc a(func, file, line);
-    void *ptr = aligned_malloc(a, size);
-    
-    cudaError_t err = cudaHostRegister(ptr, a.base_size, cudaHostRegisterDefault);
-    if (err != cudaSuccess) {
-      printfQuda("ERROR: Failed to register pinned memory of size %zu (%s:%d in %s())\n", size, file, line, func);
+    void *ptr = pinned_try_malloc(func, file, line, size);
+    if (!ptr) {
+      printfQuda("ERROR: Failed to allocate pinned memory of size %zu (%s:%d in %s())\n", size, file, line, func);
       errorQuda("Aborting");
     }
-    track_malloc(PINNED, a, ptr);
-#ifdef HOST_DEBUG
-    memset(ptr, 0xff, a.base_size);
-#endif
     return ptr;
   }
 
@@ -270,9 +341,13 @@ namespace quda {
   {
     MemAlloc a(func, file, line);
     void *ptr = aligned_malloc(a, size);
-    
-    cudaError_t err = cudaHostRegister(ptr, a.base_size, cudaHostRegisterMapped);
-    if (err != cudaSuccess) {
+    if (!ptr) {
+      printfQuda("ERROR: Failed to allocate aligned host memory of size %zu (%s:%d in %s())\n", size, file, line, func);
+      errorQuda("Aborting");
+    }
+
+    ptr = aligned_register(a, ptr, cudaHostRegisterMapped);
+    if (!ptr) {
       printfQuda("ERROR: Failed to register host-mapped memory of size %zu (%s:%d in %s())\n", size, file, line, func);
       errorQuda("Aborting");
     }
@@ -295,7 +370,7 @@ namespace quda {
       printfQuda("ERROR: Attempt to free NULL device pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
-    if (!alloc[DEVICE].count(ptr)) {
+    if (!is_tracked(DEVICE, ptr)) {
       printfQuda("ERROR: Attempt to free invalid device pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
@@ -319,7 +394,7 @@ namespace quda {
       printfQuda("ERROR: Attempt to free NULL device pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
-    if (!alloc[DEVICE].count(ptr)) {
+    if (!is_tracked(DEVICE, ptr)) {
       printfQuda("ERROR: Attempt to free invalid device pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
@@ -343,16 +418,16 @@ namespace quda {
       printfQuda("ERROR: Attempt to free NULL host pointer (%s:%d in %s())\n", file, line, func);
       errorQuda("Aborting");
     }
-    if (alloc[HOST].count(ptr)) {
+    if (is_tracked(HOST, ptr)) {
       track_free(HOST, ptr);
-    } else if (alloc[PINNED].count(ptr)) {
+    } else if (is_tracked(PINNED, ptr)) {
       cudaError_t err = cudaHostUnregister(ptr);
       if (err != cudaSuccess) {
 	printfQuda("ERROR: Failed to unregister pinned memory (%s:%d in %s())\n", file, line, func);
 	errorQuda("Aborting");
       }
       track_free(PINNED, ptr);
-    } else if (alloc[MAPPED].count(ptr)) {
+    } else if (is_tracked(MAPPED, ptr)) {
       cudaError_t err = cudaHostUnregister(ptr);
       if (err != cudaSuccess) {
 	printfQuda("ERROR: Failed to unregister host-mapped memory (%s:%d in %s())\n", file, line, func);
@@ -368,11 +443,16 @@ namespace quda {
   }
 
 
+  namespace pool {
+    static void printStatistics();
+  }
+
   void printPeakMemUsage()
   {
     printfQuda("Device memory used = %.1f MB\n", max_total_bytes[DEVICE] / (double)(1<<20));
     printfQuda("Page-locked host memory used = %.1f MB\n", max_total_pinned_bytes / (double)(1<<20));
     printfQuda("Total host memory used >= %.1f MB\n", max_total_host_bytes / (double)(1<<20));
+    pool::printStatistics();
   }
 
 
@@ -393,25 +473,272 @@ namespace quda {
 
   namespace pool {
 
-    /** Cache of inactive pinned-memory allocations.  We cache pinned
-	memory allocations so that fields can reuse these with minimal
-	overhead.*/
-    static std::multimap<size_t, void *> pinnedCache;
+    /**
+       Size-class memory pool used for the device, pinned and host
+       memory pools.
+
+       Allocations up to arena_size are carved out of arenas of
+       arena_size bytes with a binary buddy allocator.  An allocation
+       is rounded up to the granularity (2^min_order bytes) and is
+       represented as the binary decomposition of its size into
+       aligned buddy blocks, with the unused tail of the enclosing
+       power-of-two block returned to the free lists immediately.  The
+       slack per allocation is thus bounded by the granularity, and
+       freed blocks are coalesced with their buddies, so that small
+       requests can never pin down a much larger cached buffer.
+
+       Allocations larger than arena_size get a dedicated backing
+       allocation which is cached when freed, and is only reused for
+       a request that would waste at most 1/large_slack_ratio of it.
+       On a miss, the cached allocations that are too large to be
+       reused are released before a new one is made, so that the
+       cache cannot grow without bound.  If the backing allocator
+       fails, the whole cache is released and the allocation retried.
+
+       All operations are serialized with a mutex so the pools can be
+       used from threaded host kernels.
+    */
+    class MemoryPool {
+
+      typedef void* (*backing_malloc_t)(const char *, const char *, int, size_t); // returns nullptr on failure
+      typedef void (*backing_free_t)(const char *, const char *, int, void *);
+
+      static constexpr int min_order = 12;        // 4 KiB granularity
+      static constexpr int arena_order = 25;      // 32 MiB arenas
+      static constexpr size_t arena_size = static_cast<size_t>(1) << arena_order;
+      static constexpr size_t large_slack_ratio = 8;
+
+      const char *label;
+      backing_malloc_t backing_malloc;
+      backing_free_t backing_free;
+
+      std::set<uintptr_t> free_list[arena_order+1]; // free buddy blocks of each order
+      std::set<uintptr_t> arenas;                   // base address of each arena
+      std::multimap<size_t, void*> large_cache;     // cached large allocations
+
+      struct Allocation {
+	size_t size;  // requested size
+	size_t bytes; // footprint in the pool
+	bool large;   // whether this is a dedicated large allocation
+      };
+      std::unordered_map<void*, Allocation> active;
+
+      std::mutex mutex;
+
+      // statistics
+      size_t n_malloc;
+      size_t n_hit;
+      size_t bytes_reserved; // bytes obtained from the backing allocator
+      size_t bytes_held;     // footprint of active allocations
+      size_t bytes_waste;    // footprint minus requested size of active allocations
+      size_t peak_reserved;
+      size_t peak_waste;
+
+      static inline int ceil_log2(size_t x) { int k = 0; while ((static_cast<size_t>(1) << k) < x) k++; return k; }
+
+      inline uintptr_t buddy(uintptr_t block, int order) const
+      {
+	uintptr_t base = *(--arenas.upper_bound(block));
+	return base + ((block - base) ^ (static_cast<uintptr_t>(1) << order));
+      }
+
+      /**
+	 @brief Return a buddy block to the free lists, coalescing it
+	 with its buddy for as long as the buddy is also free
+      */
+      void release(uintptr_t block, int order)
+      {
+	while (order < arena_order) {
+	  uintptr_t b = buddy(block, order);
+	  auto it = free_list[order].find(b);
+	  if (it == free_list[order].end()) break;
+	  free_list[order].erase(it);
+	  block = std::min(block, b);
+	  order++;
+	}
+	free_list[order].insert(block);
+      }
+
+      void* malloc_small(const char *func, const char *file, int line, size_t bytes)
+      {
+	const int order = ceil_log2(bytes);
+
+	int j = order;
+	while (j <= arena_order && free_list[j].empty()) j++;
+
+	if (j > arena_order) { // no free block large enough so add a new arena
+	  uintptr_t base = reinterpret_cast<uintptr_t>(reserve(func, file, line, arena_size));
+	  arenas.insert(base);
+	  free_list[arena_order].insert(base);
+	  bytes_reserved += arena_size;
+	  j = arena_order;
+	} else {
+	  n_hit++;
+	}
+
+	uintptr_t block = *free_list[j].begin();
+	free_list[j].erase(free_list[j].begin());
 
-    /** Sizes of active pinned-memory allocations.  For convenience,
-	we keep track of the sizes of active allocations (i.e., those not
-	in the cache). */
-    static std::map<void *, size_t> pinnedSize;
+	// split down to the required order, keeping the lower half
+	while (j > order) { j--; free_list[j].insert(block + (static_cast<uintptr_t>(1) << j)); }
 
-    /** Cache of inactive device-memory allocations.  We cache pinned
-	memory allocations so that fields can reuse these with minimal
-	overhead.*/
-    static std::multimap<size_t, void *> deviceCache;
+	// return the unused tail of the block in increasing order of size
+	const size_t tail = (static_cast<size_t>(1) << order) - bytes;
+	uintptr_t pos = block + bytes;
+	for (int o = min_order; o < order; o++) {
+	  if (tail & (static_cast<size_t>(1) << o)) {
+	    release(pos, o);
+	    pos += static_cast<uintptr_t>(1) << o;
+	  }
+	}
 
-    /** Sizes of active device-memory allocations.  For convenience,
-	we keep track of the sizes of active allocations (i.e., those not
-	in the cache). */
-    static std::map<void *, size_t> deviceSize;
+	return reinterpret_cast<void*>(block);
+      }
+
+      void free_small(void *ptr, size_t bytes)
+      {
+	// the allocation is the binary decomposition of bytes in decreasing order of size
+	uintptr_t pos = reinterpret_cast<uintptr_t>(ptr);
+	for (int o = arena_order; o >= min_order; o--) {
+	  if (bytes & (static_cast<size_t>(1) << o)) {
+	    release(pos, o);
+	    pos += static_cast<uintptr_t>(1) << o;
+	  }
+	}
+      }
+
+      void* malloc_large(const char *func, const char *file, int line, size_t &bytes)
+      {
+	auto it = large_cache.lower_bound(bytes);
+	if (it != large_cache.end() && it->first - bytes <= bytes / large_slack_ratio) {
+	  n_hit++;
+	  bytes = it->first;
+	  void *ptr = it->second;
+	  large_cache.erase(it);
+	  return ptr;
+	}
+
+	if (it != large_cache.end()) { // release the cached allocations that are too large to be reused
+	  for (auto e = it; e != large_cache.end(); e++) {
+	    backing_free(func, file, line, e->second);
+	    bytes_reserved -= e->first;
+	  }
+	  large_cache.erase(it, large_cache.end());
+	} else if (!large_cache.empty()) { // sacrifice the smallest cached allocation
+	  it = large_cache.begin();
+	  backing_free(func, file, line, it->second);
+	  bytes_reserved -= it->first;
+	  large_cache.erase(it);
+	}
+
+	void *ptr = reserve(func, file, line, bytes);
+	bytes_reserved += bytes;
+	return ptr;
+      }
+
+      /**
+	 @brief Obtain memory from the backing allocator, releasing
+	 all cached memory and retrying if the first attempt fails
+      */
+      void* reserve(const char *func, const char *file, int line, size_t bytes)
+      {
+	void *ptr = backing_malloc(func, file, line, bytes);
+	if (!ptr) {
+	  release_cache();
+	  ptr = backing_malloc(func, file, line, bytes);
+	}
+	if (!ptr) {
+	  printfQuda("ERROR: Failed to allocate %s memory of size %zu (%s:%d in %s())\n", label, bytes, file, line, func);
+	  errorQuda("Aborting");
+	}
+	return ptr;
+      }
+
+      /**
+	 @brief Release all cached memory (free arenas and large
+	 allocations) back to the backing allocator.  The mutex must be
+	 held by the caller.
+      */
+      void release_cache()
+      {
+	for (auto &entry : large_cache) {
+	  backing_free(__func__, file_name(__FILE__), __LINE__, entry.second);
+	  bytes_reserved -= entry.first;
+	}
+	large_cache.clear();
+
+	for (auto base : free_list[arena_order]) {
+	  backing_free(__func__, file_name(__FILE__), __LINE__, reinterpret_cast<void*>(base));
+	  arenas.erase(base);
+	  bytes_reserved -= arena_size;
+	}
+	free_list[arena_order].clear();
+      }
+
+    public:
+      MemoryPool(const char *label, backing_malloc_t backing_malloc, backing_free_t backing_free)
+	: label(label), backing_malloc(backing_malloc), backing_free(backing_free), n_malloc(0), n_hit(0),
+	  bytes_reserved(0), bytes_held(0), bytes_waste(0), peak_reserved(0), peak_waste(0) { }
+
+      void* malloc(const char *func, const char *file, int line, size_t size)
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const size_t granularity = static_cast<size_t>(1) << min_order;
+	size_t bytes = ((size + granularity - 1) / granularity) * granularity;
+	if (bytes == 0) bytes = granularity;
+	const bool large = bytes > arena_size;
+
+	void *ptr = large ? malloc_large(func, file, line, bytes) : malloc_small(func, file, line, bytes);
+
+	active[ptr] = {size, bytes, large};
+	n_malloc++;
+	bytes_held += bytes;
+	bytes_waste += bytes - size;
+	peak_reserved = std::max(peak_reserved, bytes_reserved);
+	peak_waste = std::max(peak_waste, bytes_waste);
+	return ptr;
+      }
+
+      void free(void *ptr)
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto it = active.find(ptr);
+	if (it == active.end()) errorQuda("Attempt to free invalid pointer from %s memory pool", label);
+	const Allocation &a = it->second;
+
+	if (a.large) large_cache.insert(std::make_pair(a.bytes, ptr));
+	else free_small(ptr, a.bytes);
+
+	bytes_held -= a.bytes;
+	bytes_waste -= a.bytes - a.size;
+	active.erase(it);
+      }
+
+      /**
+	 @brief Release all cached memory (free arenas and large
+	 allocations) back to the backing allocator
+      */
+      void flush()
+      {
+	std::lock_guard<std::mutex> lock(mutex);
+	release_cache();
+      }
+
+      void printStatistics() const
+      {
+	if (n_malloc == 0) return;
+	printfQuda("%s memory pool: %lu allocations, hit rate = %.1f%%, cached = %.1f MB, peak reserved = %.1f MB, "
+		   "peak waste = %.1f MB\n", label, static_cast<unsigned long>(n_malloc), 100.0 * n_hit / n_malloc,
+		   (bytes_reserved - bytes_held) / (double)(1<<20), peak_reserved / (double)(1<<20),
+		   peak_waste / (double)(1<<20));
+      }
+    };
+
+    static MemoryPool devicePool("Device", quda::device_try_malloc, quda::device_free_);
+    static MemoryPool pinnedPool("Pinned", quda::pinned_try_malloc, quda::host_free_);
+    static MemoryPool hostPool("Host", quda::host_try_malloc, quda::host_free_);
 
     static bool pool_init = false;
 
@@ -421,6 +748,9 @@ namespace quda {
     /** whether to use a memory pool allocator for pinned memory */
     static bool pinned_memory_pool = true;
 
+    /** whether to use a memory pool allocator for host memory */
+    static bool host_memory_pool = true;
+
     void init() {
       if (!pool_init) {
 	// device memory pool
@@ -442,116 +772,73 @@ namespace quda {
 	  warningQuda("Not using pinned memory pool allocator");
 	  pinned_memory_pool = false;
 	}
+
+	// host memory pool
+	char *enable_host_pool = getenv("QUDA_ENABLE_HOST_MEMORY_POOL");
+	if (!enable_host_pool || strcmp(enable_host_pool,"0")!=0) {
+	  warningQuda("Using host memory pool allocator");
+	  host_memory_pool = true;
+	} else {
+	  warningQuda("Not using host memory pool allocator");
+	  host_memory_pool = false;
+	}
 	pool_init = true;
       }
     }
 
     void* pinned_malloc_(const char *func, const char *file, int line, size_t nbytes)
     {
-      void *ptr = nullptr;
-      if (pinned_memory_pool) {
-	std::multimap<size_t, void *>::iterator it;
-
-	if (pinnedCache.empty()) {
-	  ptr = quda::pinned_malloc_(func, file, line, nbytes);
-	} else {
-	  it = pinnedCache.lower_bound(nbytes);
-	  if (it != pinnedCache.end()) { // sufficiently large allocation found
-	    nbytes = it->first;
-	    ptr = it->second;
-	    pinnedCache.erase(it);
-	  } else { // sacrifice the smallest cached allocation
-	    it = pinnedCache.begin();
-	    ptr = it->second;
-	    pinnedCache.erase(it);
-	    host_free(ptr);
-	    ptr = quda::pinned_malloc_(func, file, line, nbytes);
-	  }
-	}
-	pinnedSize[ptr] = nbytes;
-      } else {
-	ptr = quda::pinned_malloc_(func, file, line, nbytes);
-      }
-      return ptr;
+      return pinned_memory_pool ? pinnedPool.malloc(func, file, line, nbytes) : quda::pinned_malloc_(func, file, line, nbytes);
     }
 
     void pinned_free_(const char *func, const char *file, int line, void *ptr)
     {
-      if (pinned_memory_pool) {
-	if (!pinnedSize.count(ptr)) {
-	  errorQuda("Attempt to free invalid pointer");
-	}
-	pinnedCache.insert(std::make_pair(pinnedSize[ptr], ptr));
-	pinnedSize.erase(ptr);
-      } else {
-	quda::host_free_(func, file, line, ptr);
-      }
+      if (pinned_memory_pool) pinnedPool.free(ptr);
+      else quda::host_free_(func, file, line, ptr);
     }
 
     void* device_malloc_(const char *func, const char *file, int line, size_t nbytes)
     {
-      void *ptr = nullptr;
-      if (device_memory_pool) {
-	std::multimap<size_t, void *>::iterator it;
-
-	if (deviceCache.empty()) {
-	  ptr = quda::device_malloc_(func, file, line, nbytes);
-	} else {
-	  it = deviceCache.lower_bound(nbytes);
-	  if (it != deviceCache.end()) { // sufficiently large allocation found
-	    nbytes = it->first;
-	    ptr = it->second;
-	    deviceCache.erase(it);
-	  } else { // sacrifice the smallest cached allocation
-	    it = deviceCache.begin();
-	    ptr = it->second;
-	    deviceCache.erase(it);
-	    quda::device_free_(func, file, line, ptr);
-	    ptr = quda::device_malloc_(func, file, line, nbytes);
-	  }
-	}
-	deviceSize[ptr] = nbytes;
-      } else {
-	ptr = quda::device_malloc_(func, file, line, nbytes);
-      }
-      return ptr;
+      return device_memory_pool ? devicePool.malloc(func, file, line, nbytes) : quda::device_malloc_(func, file, line, nbytes);
     }
 
     void device_free_(const char *func, const char *file, int line, void *ptr)
     {
-      if (device_memory_pool) {
-	if (!deviceSize.count(ptr)) {
-	  errorQuda("Attempt to free invalid pointer");
-	}
-	deviceCache.insert(std::make_pair(deviceSize[ptr], ptr));
-	deviceSize.erase(ptr);
-      } else {
-	quda::device_free_(func, file, line, ptr);
-      }
+      if (device_memory_pool) devicePool.free(ptr);
+      else quda::device_free_(func, file, line, ptr);
+    }
+
+    void* host_malloc_(const char *func, const char *file, int line, size_t nbytes)
+    {
+      return host_memory_pool ? hostPool.malloc(func, file, line, nbytes) : quda::safe_malloc_(func, file, line, nbytes);
+    }
+
+    void host_free_(const char *func, const char *file, int line, void *ptr)
+    {
+      if (host_memory_pool) hostPool.free(ptr);
+      else quda::host_free_(func, file, line, ptr);
     }
 
     void flush_pinned()
     {
-      if (pinned_memory_pool) {
-	std::multimap<size_t, void *>::iterator it;
-	for (it = pinnedCache.begin(); it != pinnedCache.end(); it++) {
-	  void *ptr = it->second;
-	  host_free(ptr);
-	}
-	pinnedCache.clear();
-      }
+      if (pinned_memory_pool) pinnedPool.flush();
     }
 
     void flush_device()
     {
-      if (device_memory_pool) {
-	std::multimap<size_t, void *>::iterator it;
-	for (it = deviceCache.begin(); it != deviceCache.end(); it++) {
-	  void *ptr = it->second;
-	  device_free(ptr);
-	}
-	deviceCache.clear();
-      }
+      if (device_memory_pool) devicePool.flush();
+    }
+
+    void flush_host()
+    {
+      if (host_memory_pool) hostPool.flush();
+    }
+
+    static void printStatistics()
+    {
+      devicePool.printStatistics();
+      pinnedPool.printStatistics();
+      hostPool.printStatistics();
     }
 
   } // namespace pool
@@ -9,6 +9,7 @@
 #include <unitarization_links.h>
 #include <ks_improved_force.h>
 #include <dslash_quda.h>
+#include <comm_quda.h>
 
 #define MAX(a,b) ((a)>(b)?(a):(b))
 
@@ -59,6 +60,136 @@ static void *df_preconditioner = nullptr;
 using namespace quda;
 using namespace quda::fermion_force;
 
+/**
+   Fingerprint of the links resident on the device for one link type
+   (fat or long).  The solvers compare this against the host links
+   they are passed and skip the upload if neither the content nor the
+   parameters they would be loaded with have changed.
+ */
+struct ResidentLinks {
+  bool valid;
+  uint64_t hash;
+  QudaGaugeParam param;
+};
+
+static ResidentLinks resident_links[2]; // fat, long
+
+static long link_loads = 0;
+static long link_loads_skipped = 0;
+static size_t link_bytes_saved = 0;
+
+/**
+   The link cache is opt-in, enabled by setting QUDA_MILC_GAUGE_CACHE=1.
+   It keeps the fat and long links on the device between solves, so
+   the device memory they occupy is not available to MILC or to other
+   QUDA calls in the meantime.  By default the links are freed after
+   each solve.
+ */
+static bool linkCacheEnabled()
+{
+  static bool init = false;
+  static bool enabled = false;
+  if (!init) {
+    char *cache_env = getenv("QUDA_MILC_GAUGE_CACHE");
+    if (cache_env && strcmp(cache_env, "1") == 0) enabled = true;
+    init = true;
+  }
+  return enabled;
+}
+
+static void forgetResidentLinks()
+{
+  resident_links[0].valid = false;
+  resident_links[1].valid = false;
+}
+
+static inline uint64_t mix64(uint64_t z)
+{
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+/**
+   Hash of the full host link field.  Each 64-bit word is mixed with
+   its position, so unlike the XOR used by Checksum() this changes
+   when a link is negated (e.g., boundary conditions or staggered
+   phases being toggled) or when words are permuted.
+ */
+static uint64_t hashLinks(const void *links, size_t bytes)
+{
+  const uint64_t *word = static_cast<const uint64_t*>(links);
+  const long n = bytes / sizeof(uint64_t);
+  uint64_t hash = 0;
+
+#pragma omp parallel num_threads(getOmpThreads())
+  {
+    uint64_t local = 0;
+#pragma omp for schedule(static) nowait
+    for (long i=0; i<n; i++) local += mix64(word[i] ^ ((uint64_t)i * 0x9e3779b97f4a7c15ull));
+#pragma omp critical
+    hash += local;
+  }
+
+  return hash;
+}
+
+static bool sameLinkParam(const QudaGaugeParam &a, const QudaGaugeParam &b)
+{
+  for (int d=0; d<4; d++) if (a.X[d] != b.X[d]) return false;
+  return a.type == b.type && a.gauge_order == b.gauge_order && a.t_boundary == b.t_boundary &&
+    a.cpu_prec == b.cpu_prec && a.cuda_prec == b.cuda_prec &&
+    a.cuda_prec_sloppy == b.cuda_prec_sloppy && a.cuda_prec_precondition == b.cuda_prec_precondition &&
+    a.reconstruct == b.reconstruct && a.reconstruct_sloppy == b.reconstruct_sloppy &&
+    a.reconstruct_precondition == b.reconstruct_precondition && a.ga_pad == b.ga_pad &&
+    a.anisotropy == b.anisotropy && a.tadpole_coeff == b.tadpole_coeff &&
+    a.staggered_phase_applied == b.staggered_phase_applied &&
+    a.staggered_phase_type == b.staggered_phase_type;
+}
+
+/**
+   Load the fat (QUDA_GENERAL_LINKS) or long (QUDA_THREE_LINKS) links
+   unless the device already holds identical links loaded with the
+   same parameters.  Since loadGaugeQuda is collective, the decision
+   is reduced across ranks so that either all ranks load or none do.
+ */
+static void loadLinksQuda(const void *links, QudaGaugeParam &param)
+{
+  if (!linkCacheEnabled()) {
+    loadGaugeQuda(const_cast<void*>(links), &param);
+    return;
+  }
+
+  ResidentLinks &resident = resident_links[param.type == QUDA_THREE_LINKS ? 1 : 0];
+  const size_t bytes = 4ul * param.X[0] * param.X[1] * param.X[2] * param.X[3] * 18 * param.cpu_prec;
+  const uint64_t hash = hashLinks(links, bytes);
+
+  double stale = (resident.valid && resident.hash == hash && sameLinkParam(resident.param, param)) ? 0.0 : 1.0;
+  comm_allreduce_max(&stale);
+
+  link_loads++;
+  if (stale == 0.0) {
+    link_loads_skipped++;
+    link_bytes_saved += bytes;
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+      printfQuda("Reusing resident %s links\n", param.type == QUDA_THREE_LINKS ? "long" : "fat");
+    return;
+  }
+
+  loadGaugeQuda(const_cast<void*>(links), &param);
+  resident.valid = true;
+  resident.hash = hash;
+  resident.param = param;
+}
+
+static void printLinkCacheSummary()
+{
+  if (link_loads == 0 || getVerbosity() < QUDA_SUMMARIZE) return;
+  printfQuda("MILC interface: skipped %ld of %ld link uploads (%.1f%% hit rate), saving %.3f GiB per rank\n",
+             link_loads_skipped, link_loads, 100.0 * link_loads_skipped / link_loads,
+             link_bytes_saved / (double)(1ul << 30));
+}
+
 
 #define QUDAMILC_VERBOSE 1
 template <bool start>
@@ -98,6 +229,7 @@ void qudaInit(QudaInitArgs_t input)
 void qudaFinalize()
 {
   qudamilc_called<true>(__func__);
+  printLinkCacheSummary();
   endQuda();
   qudamilc_called<false>(__func__);
 }
@@ -219,6 +351,7 @@ static QudaGaugeParam newMILCGaugeParam(const int* dim, QudaPrecision prec, Quda
 
 static  void invalidateGaugeQuda() {
   freeGaugeQuda();
+  forgetResidentLinks();
   invalidate_quda_gauge = true;
 }
 
@@ -870,13 +1003,13 @@ void qudaMultishiftInvert(int external_precision,
     gaugeParam.type = QUDA_GENERAL_LINKS;
     gaugeParam.ga_pad = fat_pad;  // don't know if this is correct
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+    loadLinksQuda(fatlink, gaugeParam);
 
     const int long_pad = 3*fat_pad;
     gaugeParam.type = QUDA_THREE_LINKS;
     gaugeParam.ga_pad = long_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = long_reconstruct;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+    loadLinksQuda(longlink, gaugeParam);
     invalidate_quda_gauge = false;
   }
 
@@ -896,7 +1029,7 @@ void qudaMultishiftInvert(int external_precision,
     final_fermilab_residual[i] = invertParam.true_res_hq_offset[i];
   } // end loop over number of offsets
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
+  if(!create_quda_gauge && !linkCacheEnabled()) invalidateGaugeQuda();
 
   qudamilc_called<false>(__func__, verbosity);
   return;
@@ -975,12 +1108,12 @@ void qudaInvert(int external_precision,
     gaugeParam.type = QUDA_GENERAL_LINKS;
     gaugeParam.ga_pad = fat_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+    loadLinksQuda(fatlink, gaugeParam);
     if(longlink != nullptr) {
       gaugeParam.type = QUDA_THREE_LINKS;
       gaugeParam.ga_pad = long_pad;
       gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-      loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+      loadLinksQuda(longlink, gaugeParam);
     }
     invalidate_quda_gauge = false;
   }
@@ -999,7 +1132,7 @@ void qudaInvert(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
+  if(!create_quda_gauge && !linkCacheEnabled()) invalidateGaugeQuda();
 
   qudamilc_called<false>(__func__, verbosity);
   return;
@@ -1051,12 +1184,12 @@ void qudaDslash(int external_precision,
     gaugeParam.type = QUDA_GENERAL_LINKS;
     gaugeParam.ga_pad = fat_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+    loadLinksQuda(fatlink, gaugeParam);
 
     gaugeParam.type = QUDA_THREE_LINKS;
     gaugeParam.ga_pad = long_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+    loadLinksQuda(longlink, gaugeParam);
 
     invalidate_quda_gauge = false;
   }
@@ -1068,7 +1201,7 @@ void qudaDslash(int external_precision,
 	     static_cast<char*>(src) + src_offset*host_precision,
 	     &invertParam, local_parity);
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
+  if(!create_quda_gauge && !linkCacheEnabled()) invalidateGaugeQuda();
 
   qudamilc_called<false>(__func__, verbosity);
   return;
@@ -1150,12 +1283,12 @@ void qudaInvertMsrc(int external_precision,
     gaugeParam.type = QUDA_GENERAL_LINKS;
     gaugeParam.ga_pad = fat_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+    loadLinksQuda(fatlink, gaugeParam);
 
     gaugeParam.type = QUDA_THREE_LINKS;
     gaugeParam.ga_pad = long_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+    loadLinksQuda(longlink, gaugeParam);
 
     invalidate_quda_gauge = false;
   }
@@ -1177,7 +1310,7 @@ void qudaInvertMsrc(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge) invalidateGaugeQuda();
+  if(!create_quda_gauge && !linkCacheEnabled()) invalidateGaugeQuda();
 
   qudamilc_called<false>(__func__, verbosity);
   return;
@@ -1276,12 +1409,12 @@ void qudaEigCGInvert(int external_precision,
     gaugeParam.type = QUDA_GENERAL_LINKS;
     gaugeParam.ga_pad = fat_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(fatlink), &gaugeParam);
+    loadLinksQuda(fatlink, gaugeParam);
 
     gaugeParam.type = QUDA_THREE_LINKS;
     gaugeParam.ga_pad = long_pad;
     gaugeParam.reconstruct = gaugeParam.reconstruct_sloppy = QUDA_RECONSTRUCT_NO;
-    loadGaugeQuda(const_cast<void*>(longlink), &gaugeParam);
+    loadLinksQuda(longlink, gaugeParam);
 
     invalidate_quda_gauge = false;
   }
@@ -1303,7 +1436,7 @@ void qudaEigCGInvert(int external_precision,
   *final_residual = invertParam.true_res;
   *final_fermilab_residual = invertParam.true_res_hq;
 
-  if(!create_quda_gauge && last_rhs_flag) invalidateGaugeQuda();
+  if(!create_quda_gauge && last_rhs_flag && !linkCacheEnabled()) invalidateGaugeQuda();
 
   qudamilc_called<false>(__func__, verbosity);
 
@@ -1479,6 +1612,7 @@ void qudaLoadGaugeField(int external_precision,
   setGaugeParams(gaugeParam, localDim,  inv_args, external_precision, quda_precision);
 
   loadGaugeQuda(const_cast<void*>(milc_link), &gaugeParam);
+  forgetResidentLinks(); // overwrites the resident fat links
     qudamilc_called<false>(__func__);
 } // qudaLoadGaugeField
 
@@ -1486,6 +1620,7 @@ void qudaLoadGaugeField(int external_precision,
 void qudaFreeGaugeField() {
     qudamilc_called<true>(__func__);
   freeGaugeQuda();
+  forgetResidentLinks();
     qudamilc_called<false>(__func__);
 } // qudaFreeGaugeField
 
@@ -339,94 +339,131 @@ void multiblasCuda(const coeff_array<T> &a, const coeff_array<T> &b, const coeff
 }
 
 
+// host copies of the coefficient matrices, stored in the compute precision
+static signed char Amatrix_host[MAX_MATRIX_SIZE];
+static signed char Bmatrix_host[MAX_MATRIX_SIZE];
+static signed char Cmatrix_host[MAX_MATRIX_SIZE];
+
 /**
-   Generic blas kernel with four loads and up to four stores.
-   FIXME - this is hacky due to the lack of std::complex support in
-   CUDA.  The functors are defined in terms of FloatN vectors, whereas
-   the operator() accessor returns std::complex<Float>
-  */
-template <typename Float2, typename write,
-  typename SpinorX, typename SpinorY, typename SpinorZ, typename SpinorW,
-  typename Functor>
-void genericMultiBlas(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, Functor f) {
-
-  for (int parity=0; parity<X.Nparity(); parity++) {
-    for (int x=0; x<X.VolumeCB(); x++) {
-      for (int s=0; s<X.Nspin(); s++) {
-	for (int c=0; c<X.Ncolor(); c++) {
-	  Float2 X2 = make_Float2<Float2>( X(parity, x, s, c) );
-	  Float2 Y2 = make_Float2<Float2>( Y(parity, x, s, c) );
-	  Float2 Z2 = make_Float2<Float2>( Z(parity, x, s, c) );
-	  Float2 W2 = make_Float2<Float2>( W(parity, x, s, c) );
-    f(X2, Y2, Z2, W2, 1 , 1);
-    // if (writeX) X(parity, x, s, c) = make_Complex(X2);
-    if (write::X) errorQuda("writeX not supported in multiblas.");
-    if (write::Y) Y(parity, x, s, c) = make_Complex(Y2);
-    if (write::Z) errorQuda("writeZ not supported in multiblas.");
-	  if (write::W) W(parity, x, s, c) = make_Complex(W2);
+   Number of complex elements per cache tile used by the host
+   multi-blas engine.
+*/
+static constexpr long host_tile_length = 256;
+
+/**
+   @brief Convert a coefficient matrix into the compute precision
+   for use by the host functors.  Unlike the device copy, the matrix
+   is not padded, so element (i,j) is found at NYW*i + j.
+ */
+template <typename Float2, typename T>
+void setHostCoeff(signed char *&matrix_h, signed char *host, const coeff_array<T> &a, int NXZ, int NYW)
+{
+  if (!a.data || !a.use_const) return;
+  if (NXZ*NYW*sizeof(Float2) > MAX_MATRIX_SIZE)
+    errorQuda("Matrix exceeds max size (%lu > %d)", NXZ*NYW*sizeof(Float2), MAX_MATRIX_SIZE);
+  Float2 *A = reinterpret_cast<Float2*>(host);
+  for (int i=0; i<NXZ; i++) for (int j=0; j<NYW; j++)
+    A[NYW * i + j] = make_Float2<Float2>(Complex(a.data[NYW * i + j]));
+  matrix_h = host;
+}
+
+/**
+   @brief Host multi-blas engine.  The multi-blas functors act
+   element-wise, so as long as all fields share the same field order
+   we can treat each host field as a flat array of complex numbers.
+   These are processed in cache-sized tiles: a tile of the NXZ input
+   vectors is loaded once and then reused while we sweep over the
+   NYW output vectors, and the tiles are distributed over threads.
+   @tparam NXZ Number of input vectors x and z
+   @tparam xFloat Storage precision of x and z
+   @tparam yFloat Storage precision of y and w, also the compute precision
+*/
+template <int NXZ, typename xFloat, typename yFloat, typename write, typename Functor>
+void genericMultiBlas(std::vector<ColorSpinorField*> &x, std::vector<ColorSpinorField*> &y,
+		      std::vector<ColorSpinorField*> &z, std::vector<ColorSpinorField*> &w, Functor f)
+{
+  typedef typename vector<yFloat,2>::type Float2;
+  if (write::X) errorQuda("writeX not supported in multiblas.");
+  if (write::Z) errorQuda("writeZ not supported in multiblas.");
+
+  const int NYW = y.size();
+  const long length = x[0]->Length() / 2; // number of complex elements per field
+
+  const complex<xFloat> *X[NXZ], *Z[NXZ];
+  complex<yFloat> *Y[MAX_MULTI_BLAS_N], *W[MAX_MULTI_BLAS_N];
+  for (int l=0; l<NXZ; l++) {
+    X[l] = static_cast<const complex<xFloat>*>(x[l]->V());
+    Z[l] = static_cast<const complex<xFloat>*>(z[l]->V());
+  }
+  for (int k=0; k<NYW; k++) {
+    Y[k] = static_cast<complex<yFloat>*>(y[k]->V());
+    W[k] = static_cast<complex<yFloat>*>(w[k]->V());
+  }
+
+  const long nTile = (length + host_tile_length - 1) / host_tile_length;
+
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
+  for (long t=0; t<nTile; t++) {
+    Functor f_(f);
+    f_.init();
+
+    const long begin = t * host_tile_length;
+    const long end = std::min(begin + host_tile_length, length);
+
+    for (int k=0; k<NYW; k++) {
+      for (long i=begin; i<end; i++) {
+	Float2 y_ = make_Float2<Float2>(Y[k][i]);
+	Float2 w_ = make_Float2<Float2>(W[k][i]);
+	for (int l=0; l<NXZ; l++) {
+	  Float2 x_ = make_Float2<Float2>(X[l][i]);
+	  Float2 z_ = make_Float2<Float2>(Z[l][i]);
+	  f_(x_, y_, z_, w_, k, l);
 	}
+	if (write::Y) Y[k][i] = make_Complex(y_);
+	if (write::W) W[k][i] = make_Complex(w_);
       }
     }
   }
 }
 
-template <typename Float, typename yFloat, int nSpin, int nColor, QudaFieldOrder order,
-  typename write, typename Functor>
-  void genericMultiBlas(ColorSpinorField &x, ColorSpinorField &y, ColorSpinorField &z,
-		   ColorSpinorField &w, Functor f) {
-  colorspinor::FieldOrderCB<Float,nSpin,nColor,1,order> X(x), Z(z), W(w);
-  colorspinor::FieldOrderCB<yFloat,nSpin,nColor,1,order> Y(y);
+/**
+   @brief Driver for the host multi-blas: checks the fields are
+   compatible with the flat element-wise traversal, stages the
+   coefficients and instantiates the functor.
+*/
+template <int NXZ, typename xFloat, typename yFloat,
+	  template <int,typename,typename> class Functor, typename write, typename T>
+void genericMultiBlas(const coeff_array<T> &a, const coeff_array<T> &b, const coeff_array<T> &c,
+		      std::vector<ColorSpinorField*> &x, std::vector<ColorSpinorField*> &y,
+		      std::vector<ColorSpinorField*> &z, std::vector<ColorSpinorField*> &w)
+{
   typedef typename vector<yFloat,2>::type Float2;
-  genericMultiBlas<Float2,write>(X, Y, Z, W, f);
-}
+  const int NYW = y.size();
 
-template <typename Float, typename yFloat, int nSpin, QudaFieldOrder order,
-	  typename write, typename Functor>
-  void genericMultiBlas(ColorSpinorField &x, ColorSpinorField &y, ColorSpinorField &z, ColorSpinorField &w, Functor f) {
-  if (x.Ncolor() == 2) {
-    genericMultiBlas<Float,yFloat,nSpin,2,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 3) {
-    genericMultiBlas<Float,yFloat,nSpin,3,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 4) {
-    genericMultiBlas<Float,yFloat,nSpin,4,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 8) {
-    genericMultiBlas<Float,yFloat,nSpin,8,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 12) {
-    genericMultiBlas<Float,yFloat,nSpin,12,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 16) {
-    genericMultiBlas<Float,yFloat,nSpin,16,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 20) {
-    genericMultiBlas<Float,yFloat,nSpin,20,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 24) {
-    genericMultiBlas<Float,yFloat,nSpin,24,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Ncolor() == 32) {
-    genericMultiBlas<Float,yFloat,nSpin,32,order,write,Functor>(x, y, z, w, f);
-  } else {
-    errorQuda("nColor = %d not implemeneted",x.Ncolor());
-  }
-}
+  const int N = NXZ > NYW ? NXZ : NYW;
+  if (N > MAX_MULTI_BLAS_N) errorQuda("Spinor vector length exceeds max size (%d > %d)", N, MAX_MULTI_BLAS_N);
 
-template <typename Float, typename yFloat, QudaFieldOrder order, typename write, typename Functor>
-  void genericMultiBlas(ColorSpinorField &x, ColorSpinorField &y, ColorSpinorField &z, ColorSpinorField &w, Functor f) {
-  if (x.Nspin() == 4) {
-    genericMultiBlas<Float,yFloat,4,order,write,Functor>(x, y, z, w, f);
-  } else if (x.Nspin() == 2) {
-    genericMultiBlas<Float,yFloat,2,order,write,Functor>(x, y, z, w, f);
-#ifdef GPU_STAGGERED_DIRAC
-  } else if (x.Nspin() == 1) {
-    genericMultiBlas<Float,yFloat,1,order,write,Functor>(x, y, z, w, f);
-#endif
-  } else {
-    errorQuda("nSpin = %d not implemeneted",x.Nspin());
+  const QudaFieldOrder order = x[0]->FieldOrder();
+  for (int l=0; l<NXZ; l++) {
+    if (x[l]->Length() != x[0]->Length() || z[l]->Length() != x[0]->Length())
+      errorQuda("lengths do not match: %lu %lu", x[0]->Length(), x[l]->Length());
+    if (x[l]->FieldOrder() != order || z[l]->FieldOrder() != order)
+      errorQuda("field orders do not match: %d %d", order, x[l]->FieldOrder());
   }
-}
-
-template <typename Float, typename yFloat, typename write, typename Functor>
-  void genericMultiBlas(ColorSpinorField &x, ColorSpinorField &y, ColorSpinorField &z, ColorSpinorField &w, Functor f) {
-  if (x.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
-    genericMultiBlas<Float,yFloat,QUDA_SPACE_SPIN_COLOR_FIELD_ORDER,write,Functor>
-      (x, y, z, w, f);
-  } else {
-    errorQuda("Not implemeneted");
+  for (int k=0; k<NYW; k++) {
+    if (y[k]->Length() != x[0]->Length() || w[k]->Length() != x[0]->Length())
+      errorQuda("lengths do not match: %lu %lu", x[0]->Length(), y[k]->Length());
+    if (y[k]->FieldOrder() != order || w[k]->FieldOrder() != order)
+      errorQuda("field orders do not match: %d %d", order, y[k]->FieldOrder());
   }
+
+  setHostCoeff<Float2>(Amatrix_h, Amatrix_host, a, NXZ, NYW);
+  setHostCoeff<Float2>(Bmatrix_h, Bmatrix_host, b, NXZ, NYW);
+  setHostCoeff<Float2>(Cmatrix_h, Cmatrix_host, c, NXZ, NYW);
+
+  Functor<NXZ,Float2,Float2> f(a, b, c, NYW);
+  genericMultiBlas<NXZ,xFloat,yFloat,write>(x, y, z, w, f);
+
+  blas::bytes += (long long)f.streams() * x[0]->Length() * x[0]->Precision();
+  blas::flops += (long long)f.flops() * x[0]->Length();
 }
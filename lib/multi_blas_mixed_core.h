@@ -71,16 +71,13 @@ namespace mixed {
 	errorQuda("Precision combination x=%d y=%d not supported\n", x[0]->Precision(), y[0]->Precision());
       }
     } else { // fields on the cpu
-      // using namespace quda::colorspinor;
-      // if (x[0]->Precision() == QUDA_DOUBLE_PRECISION) {
-      //   Functor<NXZ, NYW, double2, double2> f(a, b, c);
-      //   genericMultBlas<double, double, writeX, writeY, writeZ, writeW>(x, y, z, w, f);
-      // } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION) {
-      //   Functor<NXZ, NYW, float2, float2> f(a, make_float2(b.x,b.y), make_float2(c.x,c.y) );
-      //   genericMultBlas<float, float, writeX, writeY, writeZ, writeW>(x, y, z, w, f);
-      // } else {
-      errorQuda("Not implemented");
-      // }
+
+      if (y[0]->Precision() == QUDA_DOUBLE_PRECISION && x[0]->Precision() == QUDA_SINGLE_PRECISION) {
+	genericMultiBlas<NXZ,float,double,Functor,write>(a, b, c, x, y, z, w);
+      } else {
+	errorQuda("Precision combination x=%d y=%d not supported\n", x[0]->Precision(), y[0]->Precision());
+      }
+
     }
 
   }
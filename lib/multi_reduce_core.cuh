@@ -486,3 +486,126 @@ template <typename doubleN, typename ReduceType, typename RegType, typename Stor
 
   return;
 }
+
+/**
+   Number of fixed partitions used by the host multi-reduce.  Each
+   partition is reduced by a single thread and the partials are then
+   summed in partition order, so the result does not depend on the
+   number of threads.
+*/
+static constexpr int host_reduce_blocks = 256;
+
+/**
+   Number of complex elements per cache tile used by the host
+   multi-reduce engine.
+*/
+static constexpr long host_tile_length = 256;
+
+/**
+   @brief Host multi-reduce engine.  The multi-reduce functors act
+   element-wise, so as long as all fields share the same field order
+   we can treat each host field as a flat array of complex numbers.
+   The arrays are split into cache-sized tiles: a tile of the NXZ
+   input vectors is loaded once and reused while we sweep over the
+   NYW output vectors, accumulating the full NXZ x NYW matrix of
+   reductions for each partition.
+   @param[out] result Reduction matrix, element (i,j) is at i*NYW + j
+   @tparam xFloat Storage precision of x and z
+   @tparam yFloat Storage precision of y and w, also the compute precision
+*/
+template <int NXZ, typename doubleN, typename xFloat, typename yFloat, typename write, typename Reducer>
+void genericMultiReduce(doubleN result[], std::vector<ColorSpinorField*> &x, std::vector<ColorSpinorField*> &y,
+			std::vector<ColorSpinorField*> &z, std::vector<ColorSpinorField*> &w, Reducer r)
+{
+  typedef typename vector<yFloat,2>::type Float2;
+  if (write::X) errorQuda("writeX not supported in multi-reduce.");
+  if (write::Z) errorQuda("writeZ not supported in multi-reduce.");
+
+  const int NYW = y.size();
+  const long length = x[0]->Length() / 2; // number of complex elements per field
+
+  const complex<xFloat> *X[NXZ], *Z[NXZ];
+  complex<yFloat> *Y[MAX_MULTI_BLAS_N], *W[MAX_MULTI_BLAS_N];
+  for (int l=0; l<NXZ; l++) {
+    X[l] = static_cast<const complex<xFloat>*>(x[l]->V());
+    Z[l] = static_cast<const complex<xFloat>*>(z[l]->V());
+  }
+  for (int k=0; k<NYW; k++) {
+    Y[k] = static_cast<complex<yFloat>*>(y[k]->V());
+    W[k] = static_cast<complex<yFloat>*>(w[k]->V());
+  }
+
+  const long nTile = (length + host_tile_length - 1) / host_tile_length;
+  const int nBlock = std::max(1l, std::min(nTile, static_cast<long>(host_reduce_blocks)));
+  std::vector<doubleN> partial(nBlock*NXZ*NYW);
+
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
+  for (int b=0; b<nBlock; b++) {
+    Reducer r_(r);
+    doubleN *sum = &partial[b*NXZ*NYW];
+    for (int i=0; i<NXZ*NYW; i++) ::quda::zero(sum[i]);
+
+    for (long t=(nTile*b)/nBlock; t<(nTile*(b+1))/nBlock; t++) {
+      const long begin = t * host_tile_length;
+      const long end = std::min(begin + host_tile_length, length);
+
+      for (int k=0; k<NYW; k++) {
+	for (int l=0; l<NXZ; l++) {
+	  doubleN &s = sum[l*NYW + k];
+	  for (long i=begin; i<end; i++) {
+	    Float2 x_ = make_Float2<Float2>(X[l][i]);
+	    Float2 y_ = make_Float2<Float2>(Y[k][i]);
+	    Float2 z_ = make_Float2<Float2>(Z[l][i]);
+	    Float2 w_ = make_Float2<Float2>(W[k][i]);
+	    r_.pre();
+	    r_(s, x_, y_, z_, w_, k, l);
+	    r_.post(s);
+	    if (write::Y) Y[k][i] = make_Complex(y_);
+	    if (write::W) W[k][i] = make_Complex(w_);
+	  }
+	}
+      }
+    }
+  }
+
+  for (int i=0; i<NXZ*NYW; i++) {
+    ::quda::zero(result[i]);
+    for (int b=0; b<nBlock; b++) result[i] += partial[b*NXZ*NYW + i];
+  }
+}
+
+/**
+   @brief Driver for the host multi-reduce: checks the fields are
+   compatible with the flat element-wise traversal and instantiates
+   the reducer.  The reduction is accumulated directly in doubleN.
+*/
+template <int NXZ, typename doubleN, typename xFloat, typename yFloat,
+	  template <int MXZ, typename ReducerType, typename Float, typename FloatN> class Reducer, typename write, typename T>
+void genericMultiReduce(doubleN result[], const reduce::coeff_array<T> &a, const reduce::coeff_array<T> &b,
+			const reduce::coeff_array<T> &c, std::vector<ColorSpinorField*> &x, std::vector<ColorSpinorField*> &y,
+			std::vector<ColorSpinorField*> &z, std::vector<ColorSpinorField*> &w)
+{
+  typedef typename vector<yFloat,2>::type Float2;
+  const int NYW = y.size();
+
+  const int N = NXZ > NYW ? NXZ : NYW;
+  if (N > MAX_MULTI_BLAS_N) errorQuda("Spinor vector length exceeds max size (%d > %d)", N, MAX_MULTI_BLAS_N);
+
+  const QudaFieldOrder order = x[0]->FieldOrder();
+  for (int l=0; l<NXZ; l++) {
+    checkSpinor(*x[0], *x[l]); checkSpinor(*x[0], *z[l]);
+    if (x[l]->FieldOrder() != order || z[l]->FieldOrder() != order)
+      errorQuda("field orders do not match: %d %d", order, x[l]->FieldOrder());
+  }
+  for (int k=0; k<NYW; k++) {
+    checkSpinor(*x[0], *y[k]); checkSpinor(*x[0], *w[k]);
+    if (y[k]->FieldOrder() != order || w[k]->FieldOrder() != order)
+      errorQuda("field orders do not match: %d %d", order, y[k]->FieldOrder());
+  }
+
+  Reducer<NXZ, doubleN, Float2, Float2> r(a, b, c, NYW);
+  genericMultiReduce<NXZ,doubleN,xFloat,yFloat,write>(result, x, y, z, w, r);
+
+  blas::bytes += (long long)NYW*NXZ*r.streams()*x[0]->Length()*x[0]->Precision();
+  blas::flops += (long long)NYW*NXZ*r.flops()*x[0]->Length();
+}
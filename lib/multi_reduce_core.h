@@ -10,6 +10,17 @@ template<int NXZ, typename doubleN, typename ReduceType,
 		       CompositeColorSpinorField& z, CompositeColorSpinorField& w){
   const int NYW = y.size();
 
+  if (checkLocation(*x[0], *y[0], *z[0], *w[0]) == QUDA_CPU_FIELD_LOCATION) { // fields on the cpu
+    if (x[0]->Precision() == QUDA_DOUBLE_PRECISION) {
+      genericMultiReduce<NXZ,doubleN,double,double,Reducer,write>(result, a, b, c, x, y, z, w);
+    } else if (x[0]->Precision() == QUDA_SINGLE_PRECISION) {
+      genericMultiReduce<NXZ,doubleN,float,float,Reducer,write>(result, a, b, c, x, y, z, w);
+    } else {
+      errorQuda("Precision %d not supported\n", x[0]->Precision());
+    }
+    return;
+  }
+
   int reduce_length = siteUnroll ? x[0]->RealLength() : x[0]->Length();
 
   if (x[0]->Precision() == QUDA_DOUBLE_PRECISION) {
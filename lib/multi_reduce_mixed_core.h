@@ -10,6 +10,15 @@ namespace mixed {
 			 CompositeColorSpinorField& z, CompositeColorSpinorField& w){
     const int NYW = y.size();
 
+    if (checkLocation(*x[0], *y[0], *z[0], *w[0]) == QUDA_CPU_FIELD_LOCATION) { // fields on the cpu
+      if (y[0]->Precision() == QUDA_DOUBLE_PRECISION && x[0]->Precision() == QUDA_SINGLE_PRECISION) {
+	genericMultiReduce<NXZ,doubleN,float,double,Reducer,write>(result, a, b, c, x, y, z, w);
+      } else {
+	errorQuda("Precision combination x=%d y=%d not supported\n", x[0]->Precision(), y[0]->Precision());
+      }
+      return;
+    }
+
     assert(siteUnroll==true);
     int reduce_length = siteUnroll ? x[0]->RealLength() : x[0]->Length();
 
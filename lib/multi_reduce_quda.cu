@@ -55,9 +55,6 @@ static struct {
 namespace quda {
 
   // hooks into tune.cpp variables for policy tuning
-  typedef std::map<TuneKey, TuneParam> map;
-  const map& getTuneCache();
-
   void disableProfileCount();
   void enableProfileCount();
 
@@ -486,13 +483,26 @@ namespace quda {
       	// before we do policy tuning we must ensure the kernel
       	// constituents have been tuned since we can't do nested tuning
       	// FIXME this will break if the kernels are destructive - which they aren't here
-	if (getTuning() && getTuneCache().find(tuneKey()) == getTuneCache().end()) {
+	if ( x.size()==1 || y.size()==1 ) { // 1-d reduction
+	  max_tile_size = std::min(MAX_MULTI_BLAS_N, (int)std::max(x.size(), y.size()));
+	} else { // 2-d reduction
+	  // max_tile_size should be set to the largest power of 2 less than
+	  // MAX_MULTI_BLAS_N, since we have a requirement that the
+	  // tile size is a power of 2.
+	  unsigned int max_count = 0;
+	  unsigned int tile_size_tmp = MAX_MULTI_BLAS_N;
+	  while (tile_size_tmp != 1) { tile_size_tmp = tile_size_tmp >> 1; max_count++; }
+	  tile_size_tmp = 1;
+	  for (unsigned int i = 0; i < max_count; i++) { tile_size_tmp = tile_size_tmp << 1; }
+	  max_tile_size = tile_size_tmp;
+	}
+
+	// host fields are not tuned: the host engine always uses the largest tile
+	if (x[0]->Location() == QUDA_CUDA_FIELD_LOCATION && getTuning() && !tuneCacheHit(tuneKey())) {
 	  disableProfileCount(); // purely for profiling reasons, don't want to profile tunings.
 
 	  if ( x.size()==1 || y.size()==1 ) { // 1-d reduction
 
-	    max_tile_size = std::min(MAX_MULTI_BLAS_N, (int)std::max(x.size(), y.size()));
-
 	    // Make sure constituents are tuned.
 	    for ( unsigned int tile_size=1; tile_size <= max_tile_size; tile_size++) {
 	      multiReduce_recurse<ReducerDiagonal,writeDiagonal,ReducerOffDiagonal,writeOffDiagonal>
@@ -501,16 +511,6 @@ namespace quda {
 
 	  } else { // 2-d reduction
 
-	    // max_tile_size should be set to the largest power of 2 less than
-	    // MAX_MULTI_BLAS_N, since we have a requirement that the
-	    // tile size is a power of 2.
-	    unsigned int max_count = 0;
-	    unsigned int tile_size_tmp = MAX_MULTI_BLAS_N;
-	    while (tile_size_tmp != 1) { tile_size_tmp = tile_size_tmp >> 1; max_count++; }
-	    tile_size_tmp = 1;
-	    for (unsigned int i = 0; i < max_count; i++) { tile_size_tmp = tile_size_tmp << 1; }
-	    max_tile_size = tile_size_tmp;
-
 	    // Make sure constituents are tuned.
 	    for ( unsigned int tile_size=1; tile_size <= max_tile_size && tile_size <= x.size() &&
 		    (tile_size <= y.size() || y.size()==1) ; tile_size*=2) {
@@ -528,6 +528,12 @@ namespace quda {
       virtual ~TileSizeTune() { setPolicyTuning(false); }
 
       void apply(const cudaStream_t &stream) {
+        if (x[0]->Location() == QUDA_CPU_FIELD_LOCATION) {
+          multiReduce_recurse<ReducerDiagonal,writeDiagonal,ReducerOffDiagonal,writeOffDiagonal>
+            (result, x, y, z, w, 0, 0, hermitian, max_tile_size);
+          return;
+        }
+
         TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
 
         // tp.aux.x is where the tile size is stored. "tp" is the tuning struct.
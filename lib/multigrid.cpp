@@ -1,6 +1,8 @@
 #include <multigrid.h>
 #include <qio_field.h>
+#include <field_io.h>
 #include <string.h>
+#include <comm_quda.h>
 
 #include <quda_arpack_interface.h>
 
@@ -25,7 +27,11 @@ namespace quda {
 
     printfQuda("Creating level %d of %d levels\n", param.level+1, param.Nlevel);
 
-    if (param.level < param.Nlevel-1) {
+    // restoring from a checkpoint bypasses the null-space generation, the
+    // block orthogonalization and the coarse-operator construction
+    const bool restore = param.level < param.Nlevel-1 && strcmp(param.mg_global.checkpoint_infile,"")!=0;
+
+    if (param.level < param.Nlevel-1 && !restore) {
       if (param.mg_global.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_YES) {
 	if (param.mg_global.generate_all_levels == QUDA_BOOLEAN_YES || param.level == 0) generateNullVectors(param.B);
       } else if (strcmp(param.mg_global.vec_infile,"")!=0) { // only load if infile is defined and not computing
@@ -70,7 +76,7 @@ namespace quda {
       // create transfer operator
       printfQuda("start creating transfer operator\n");
       transfer = new Transfer(param.B, param.Nvec, param.geoBlockSize, param.spinBlockSize,
-			      param.location == QUDA_CUDA_FIELD_LOCATION ? true : false, profile);
+			      param.location == QUDA_CUDA_FIELD_LOCATION ? true : false, profile, !restore);
       for (int i=0; i<QUDA_MAX_MG_LEVEL; i++) param.mg_global.geo_block_size[param.level][i] = param.geoBlockSize[i];
 
       //transfer->setTransferGPU(false); // use this to force location of transfer
@@ -101,7 +107,7 @@ namespace quda {
       diracParam.matpcType = matpc_type;
       diracParam.tmp1 = tmp_coarse;
       // use even-odd preconditioning for the coarse grid solver
-      diracCoarseResidual = new DiracCoarse(diracParam);
+      diracCoarseResidual = new DiracCoarse(diracParam, true, !restore);
       matCoarseResidual = new DiracM(*diracCoarseResidual);
 
       // create smoothing operators
@@ -116,6 +122,8 @@ namespace quda {
       matCoarseSmoother = new DiracM(*diracCoarseSmoother);
       matCoarseSmootherSloppy = new DiracM(*diracCoarseSmootherSloppy);
 
+      if (restore) loadCheckpoint();
+
       printfQuda("Creating coarse null-space vectors\n");
       B_coarse = new std::vector<ColorSpinorField*>();
       int nVec_coarse = std::max(param.Nvec, param.mg_global.n_vec[param.level+1]);
@@ -187,6 +195,8 @@ namespace quda {
 
     printfQuda("setup completed\n");
 
+    if (param.level < param.Nlevel-1 && strcmp(param.mg_global.checkpoint_outfile,"")!=0) saveCheckpoint();
+
     // now we can run through the verification if requested
     if (param.level == 0 && param.mg_global.run_verify) verify();
 
@@ -209,6 +219,51 @@ namespace quda {
     if (param.level < param.Nlevel-2) coarse->reset();
   }
 
+  void MG::refresh() {
+    setOutputPrefix(prefix);
+
+    if (param.level < param.Nlevel-1) {
+      printfQuda("Refreshing level %d of %d levels\n", param.level+1, param.Nlevel);
+
+      // adapt the null-space vectors to the new operator
+      if (param.mg_global.setup_refresh_iter[param.level] > 0 &&
+	  (param.mg_global.generate_all_levels == QUDA_BOOLEAN_YES || param.level == 0))
+	generateNullVectors(param.B, true);
+
+      // the coarse operator is built from the full-field prolongator
+      QudaMatPCType matpc_type = param.mg_global.invert_param->matpc_type;
+      QudaParity parity = (matpc_type == QUDA_MATPC_EVEN_EVEN || matpc_type == QUDA_MATPC_EVEN_EVEN_ASYMMETRIC) ? QUDA_EVEN_PARITY : QUDA_ODD_PARITY;
+      transfer->setSiteSubset(QUDA_FULL_SITE_SUBSET, parity);
+      transfer->reset();
+
+      // if we're not generating on all levels then we need to propagate the vectors down
+      if (param.mg_global.generate_all_levels == QUDA_BOOLEAN_NO) {
+	for (int i=0; i<param.Nvec; i++) {
+	  zero(*(*B_coarse)[i]);
+	  transfer->R(*(*B_coarse)[i], *(param.B[i]));
+	}
+      }
+
+      // recompute the coarse links in place; the smoothing operators share them
+      bool preconditioned_coarsen = (param.coarse_grid_solution_type == QUDA_MATPC_SOLUTION && param.smoother_solve_type == QUDA_DIRECT_PC_SOLVE);
+      const Dirac *dirac = preconditioned_coarsen ? param.matSmooth->Expose() : param.matResidual->Expose();
+      static_cast<DiracCoarse*>(diracCoarseResidual)->updateCoarse(*dirac);
+
+      coarse->refresh();
+      setOutputPrefix(prefix); // restore since we just popped back from coarse grid
+    }
+
+    if (param.level == 0) {
+      if (param.mg_global.run_verify) verify();
+      reset();
+    }
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) profile.Print();
+    profile.TPRESET();
+
+    setOutputPrefix("");
+  }
+
 
   void MG::createSmoother() {
     // create the smoother for this level
@@ -664,7 +719,9 @@ namespace quda {
       }
     }
 
-    if (strcmp(vec_infile.c_str(),"")!=0) {
+    if (strcmp(vec_infile.c_str(),"")!=0 && isFieldFile(vec_infile.c_str())) {
+      loadColorSpinorFields(vec_infile.c_str(), B);
+    } else if (strcmp(vec_infile.c_str(),"")!=0) {
 #ifdef HAVE_QIO
       read_spinor_field(vec_infile.c_str(), &V[0], B[0]->Precision(), B[0]->X(),
 			B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
@@ -706,17 +763,28 @@ namespace quda {
   }
 
   void MG::saveVectors(std::vector<ColorSpinorField*> &B) {
-#ifdef HAVE_QIO
+    if (strcmp(param.mg_global.vec_outfile,"")==0) return;
+
     profile_global.TPSTOP(QUDA_PROFILE_INIT);
     profile_global.TPSTART(QUDA_PROFILE_IO);
     std::string vec_outfile(param.mg_global.vec_outfile);
     vec_outfile += "_level_";
     vec_outfile += std::to_string(param.level);
 
-    if (strcmp(param.mg_global.vec_outfile,"")!=0) {
-      const int Nvec = B.size();
-      printfQuda("Start saving %d vectors to %s\n", Nvec, vec_outfile.c_str());
+    const int Nvec = B.size();
+    printfQuda("Start saving %d vectors to %s\n", Nvec, vec_outfile.c_str());
+
+#ifdef HAVE_QIO
+    const bool native = (param.mg_global.vec_native_io == QUDA_BOOLEAN_YES);
+#else
+    const bool native = true;
+#endif
 
+    if (native) {
+      // the vectors are staged and written behind the rest of the setup
+      saveColorSpinorFields(vec_outfile.c_str(), B, B[0]->Precision(), true);
+    } else {
+#ifdef HAVE_QIO
       void **V = static_cast<void**>(safe_malloc(Nvec*sizeof(void*)));
       for (int i=0; i<Nvec; i++) {
 	V[i] = B[i]->V();
@@ -729,20 +797,333 @@ namespace quda {
 			 B[0]->Ncolor(), B[0]->Nspin(), Nvec, 0,  (char**)0);
 
       host_free(V);
-      printfQuda("Done saving vectors\n");
+#endif
     }
+    printfQuda("Done saving vectors\n");
 
     profile_global.TPSTOP(QUDA_PROFILE_IO);
     profile_global.TPSTART(QUDA_PROFILE_INIT);
-#else
-    if (strcmp(param.mg_global.vec_outfile,"")!=0) {
-      errorQuda("\nQIO library was not built.\n");
+  }
+
+  /**
+     Multigrid checkpoints are native binary files, one per level (bar
+     the coarsest) and rank.  Each holds an MGCheckpointHeader followed
+     by a sequence of sections, each of which is its length in bytes,
+     a checksum of its contents and then the raw contents.  The
+     sections are, in order, the null-space vectors, the
+     block-orthogonal prolongator V, the fine-to-coarse site map and
+     the coarse Y, X, Xinv and Yhat fields.
+   */
+  struct MGCheckpointHeader {
+    char magic[8];
+    int version;
+    int level;
+    int n_level;
+    int n_rank;
+    int nvec;
+    int spin_bs;
+    int geo_bs[QUDA_MAX_DIM];
+    int x[QUDA_MAX_DIM];      // local dimensions of the null-space vectors
+    int nspin;
+    int ncolor;
+    int precision;
+    int site_subset;
+    int matpc_type;
+    int preconditioned_coarsen;
+    double kappa;
+    double mu;
+    double mu_factor;
+  };
+
+  static const char mg_checkpoint_magic[8] = "QUDAMG";
+  static const int mg_checkpoint_version = 1;
+
+  /** A section of a checkpoint file, possibly spread over several host allocations */
+  typedef std::vector<std::pair<char*, size_t> > CheckpointSection;
+
+  static CheckpointSection checkpointSection(const ColorSpinorField &f)
+  {
+    if (f.Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Only host fields can be checkpointed");
+    CheckpointSection section;
+    section.push_back(std::make_pair((char*)const_cast<void*>(f.V()), f.Bytes()));
+    if (f.NormBytes()) section.push_back(std::make_pair((char*)const_cast<void*>(f.Norm()), f.NormBytes()));
+    return section;
+  }
+
+  static CheckpointSection checkpointSection(cpuGaugeField &f)
+  {
+    CheckpointSection section;
+    if (f.Order() == QUDA_QDP_GAUGE_ORDER) {
+      // one allocation per direction (Geometry() is the number of directions in 4-d)
+      const int n_dir = f.Geometry();
+      for (int d=0; d<n_dir; d++)
+	section.push_back(std::make_pair(static_cast<char*>(static_cast<void**>(f.Gauge_p())[d]), f.Bytes()/n_dir));
+    } else {
+      section.push_back(std::make_pair(static_cast<char*>(f.Gauge_p()), f.Bytes()));
     }
-#endif
+    return section;
+  }
+
+  /**
+     FNV-1a over 64-bit words, with the high half folded back in after
+     each step so that every bit of the input affects the low bits.
+   */
+  static uint64_t checkpointChecksum(uint64_t sum, const char *data, size_t bytes)
+  {
+    const uint64_t prime = 0x100000001b3ull;
+    const size_t n = bytes / sizeof(uint64_t);
+    for (size_t i=0; i<n; i++) {
+      uint64_t w;
+      memcpy(&w, data + i*sizeof(uint64_t), sizeof(uint64_t));
+      sum = (sum ^ w) * prime;
+      sum ^= sum >> 32;
+    }
+    for (size_t i=n*sizeof(uint64_t); i<bytes; i++) sum = (sum ^ (unsigned char)data[i]) * prime;
+    return sum;
+  }
+
+  static void writeCheckpointSection(FILE *fp, const CheckpointSection &section, const std::string &filename)
+  {
+    uint64_t bytes = 0, sum = 0xcbf29ce484222325ull;
+    for (auto &s : section) {
+      bytes += s.second;
+      sum = checkpointChecksum(sum, s.first, s.second);
+    }
+
+    bool ok = fwrite(&bytes, sizeof(bytes), 1, fp) == 1 && fwrite(&sum, sizeof(sum), 1, fp) == 1;
+    for (auto &s : section) ok = ok && fwrite(s.first, 1, s.second, fp) == s.second;
+    if (!ok) errorQuda("Failed to write multigrid checkpoint %s", filename.c_str());
+  }
+
+  static void readCheckpointSection(FILE *fp, const CheckpointSection &section, const std::string &filename, const char *label)
+  {
+    uint64_t bytes = 0, expected_bytes = 0, stored_sum = 0, sum = 0xcbf29ce484222325ull;
+    for (auto &s : section) expected_bytes += s.second;
+
+    if (fread(&bytes, sizeof(bytes), 1, fp) != 1 || fread(&stored_sum, sizeof(stored_sum), 1, fp) != 1)
+      errorQuda("Multigrid checkpoint %s is truncated before %s", filename.c_str(), label);
+    if (bytes != expected_bytes)
+      errorQuda("Multigrid checkpoint %s has %lu bytes of %s, expected %lu", filename.c_str(), bytes, label, expected_bytes);
+
+    for (auto &s : section) {
+      if (fread(s.first, 1, s.second, fp) != s.second)
+	errorQuda("Multigrid checkpoint %s is truncated in %s", filename.c_str(), label);
+      sum = checkpointChecksum(sum, s.first, s.second);
+    }
+    if (sum != stored_sum)
+      errorQuda("Multigrid checkpoint %s: checksum mismatch in %s (%lx != %lx)", filename.c_str(), label, sum, stored_sum);
   }
 
-  void MG::generateNullVectors(std::vector<ColorSpinorField*> B) {
-    printfQuda("\nGenerate null vectors\n");
+  /**
+     @return The header describing this level of the hierarchy as it is currently set up
+   */
+  static MGCheckpointHeader checkpointHeader(const MGParam &param, const Transfer &transfer, const DiracCoarse &dirac,
+					     bool preconditioned_coarsen)
+  {
+    MGCheckpointHeader header;
+    memset(&header, 0, sizeof(header)); // so the padding is deterministic
+    memcpy(header.magic, mg_checkpoint_magic, sizeof(header.magic));
+    header.version = mg_checkpoint_version;
+    header.level = param.level;
+    header.n_level = param.Nlevel;
+    header.n_rank = comm_size();
+    header.nvec = param.Nvec;
+    header.spin_bs = transfer.Spin_bs();
+
+    const ColorSpinorField &b = *param.B[0];
+    for (int d=0; d<b.Ndim(); d++) {
+      header.geo_bs[d] = transfer.Geo_bs()[d];
+      header.x[d] = b.X(d);
+    }
+    header.nspin = b.Nspin();
+    header.ncolor = b.Ncolor();
+    header.precision = b.Precision();
+    header.site_subset = b.SiteSubset();
+    header.matpc_type = param.mg_global.invert_param->matpc_type;
+    header.preconditioned_coarsen = preconditioned_coarsen;
+    header.kappa = dirac.Kappa();
+    header.mu = dirac.Mu();
+    header.mu_factor = dirac.MuFactor();
+    return header;
+  }
+
+  static std::string checkpointFilename(const char *prefix, int level)
+  {
+    return std::string(prefix) + "_level_" + std::to_string(level) + "_rank_" + std::to_string(comm_rank()) + ".mg";
+  }
+
+  void MG::saveCheckpoint() {
+    profile_global.TPSTOP(QUDA_PROFILE_INIT);
+    profile_global.TPSTART(QUDA_PROFILE_IO);
+
+    std::string filename = checkpointFilename(param.mg_global.checkpoint_outfile, param.level);
+    printfQuda("Saving level %d to checkpoint %s (one file per rank)\n", param.level+1, filename.c_str());
+
+    FILE *fp = fopen(filename.c_str(), "wb");
+    if (!fp) errorQuda("Unable to open multigrid checkpoint %s for writing", filename.c_str());
+
+    bool preconditioned_coarsen = (param.coarse_grid_solution_type == QUDA_MATPC_SOLUTION && param.smoother_solve_type == QUDA_DIRECT_PC_SOLVE);
+    DiracCoarse &dirac = static_cast<DiracCoarse&>(*diracCoarseResidual);
+    MGCheckpointHeader header = checkpointHeader(param, *transfer, dirac, preconditioned_coarsen);
+    if (fwrite(&header, sizeof(header), 1, fp) != 1) errorQuda("Failed to write multigrid checkpoint %s", filename.c_str());
+
+    for (int i=0; i<param.Nvec; i++) writeCheckpointSection(fp, checkpointSection(*param.B[i]), filename);
+    writeCheckpointSection(fp, checkpointSection(transfer->Vectors()), filename);
+
+    const size_t map_bytes = transfer->Vectors().Volume() * sizeof(int);
+    writeCheckpointSection(fp, CheckpointSection(1, std::make_pair((char*)const_cast<int*>(transfer->FineToCoarse()), map_bytes)), filename);
+
+    for (auto f : dirac.HostFields()) writeCheckpointSection(fp, checkpointSection(*f), filename);
+
+    if (fclose(fp) != 0) errorQuda("Failed to write multigrid checkpoint %s", filename.c_str());
+
+    profile_global.TPSTOP(QUDA_PROFILE_IO);
+    profile_global.TPSTART(QUDA_PROFILE_INIT);
+  }
+
+  void MG::loadCheckpoint() {
+    profile_global.TPSTOP(QUDA_PROFILE_INIT);
+    profile_global.TPSTART(QUDA_PROFILE_IO);
+
+    std::string filename = checkpointFilename(param.mg_global.checkpoint_infile, param.level);
+    printfQuda("Restoring level %d from checkpoint %s (one file per rank)\n", param.level+1, filename.c_str());
+
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (!fp) errorQuda("Unable to open multigrid checkpoint %s", filename.c_str());
+
+    bool preconditioned_coarsen = (param.coarse_grid_solution_type == QUDA_MATPC_SOLUTION && param.smoother_solve_type == QUDA_DIRECT_PC_SOLVE);
+    DiracCoarse &dirac = static_cast<DiracCoarse&>(*diracCoarseResidual);
+    MGCheckpointHeader expected = checkpointHeader(param, *transfer, dirac, preconditioned_coarsen);
+
+    MGCheckpointHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1) errorQuda("Multigrid checkpoint %s is truncated", filename.c_str());
+    if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0)
+      errorQuda("%s is not a multigrid checkpoint", filename.c_str());
+    if (header.version != expected.version)
+      errorQuda("Multigrid checkpoint %s has version %d, expected %d", filename.c_str(), header.version, expected.version);
+    if (memcmp(&header, &expected, sizeof(header)) != 0)
+      errorQuda("Multigrid checkpoint %s was written for a different setup (level %d of %d on %d ranks, Nvec = %d, precision = %d)",
+		filename.c_str(), header.level+1, header.n_level, header.n_rank, header.nvec, header.precision);
+
+    for (int i=0; i<param.Nvec; i++) readCheckpointSection(fp, checkpointSection(*param.B[i]), filename, "null-space vectors");
+
+    ColorSpinorParam csParam(transfer->Vectors());
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    ColorSpinorField *V = ColorSpinorField::Create(csParam);
+    readCheckpointSection(fp, checkpointSection(*V), filename, "prolongator");
+    transfer->setVectors(*V);
+    delete V;
+
+    // the site map is cheap to recompute, so it is only used to check the blocking is the same
+    const int volume = transfer->Vectors().Volume();
+    std::vector<int> fine_to_coarse(volume);
+    readCheckpointSection(fp, CheckpointSection(1, std::make_pair((char*)fine_to_coarse.data(), volume*sizeof(int))),
+			  filename, "site map");
+    if (memcmp(fine_to_coarse.data(), transfer->FineToCoarse(), volume*sizeof(int)) != 0)
+      errorQuda("Multigrid checkpoint %s has a different fine-to-coarse site map", filename.c_str());
+
+    const char *labels[] = {"coarse links", "coarse clover", "coarse clover inverse", "preconditioned coarse links"};
+    std::vector<cpuGaugeField*> fields = dirac.HostFields();
+    for (unsigned int i=0; i<fields.size(); i++) readCheckpointSection(fp, checkpointSection(*fields[i]), filename, labels[i]);
+    dirac.uploadCoarse();
+
+    char extra;
+    if (fread(&extra, 1, 1, fp) != 0) errorQuda("Multigrid checkpoint %s has trailing data", filename.c_str());
+    fclose(fp);
+
+    profile_global.TPSTOP(QUDA_PROFILE_IO);
+    profile_global.TPSTART(QUDA_PROFILE_INIT);
+  }
+
+  /**
+     @brief Orthonormalize V[i] against V[0], ..., V[i-1], which must
+     already be orthonormal.  Classical Gram-Schmidt is applied twice
+     (CGS2), so each pass is a single block dot product followed by a
+     single block caxpy, with the loss of orthogonality comparable to
+     modified Gram-Schmidt.
+   */
+  static void orthonormalizeAgainst(std::vector<ColorSpinorField*> &V, unsigned int i)
+  {
+    ColorSpinorField &x = *V[i];
+
+    if (i > 0) {
+      std::vector<ColorSpinorField*> prev(V.begin(), V.begin()+i);
+      std::vector<ColorSpinorField*> cur(1, &x);
+      std::vector<Complex> alpha(i);
+
+      for (int pass=0; pass<2; pass++) {
+	cDotProduct(alpha.data(), prev, cur); // alpha_j = <V_j, x>
+	for (auto &a : alpha) a = -a;
+	caxpy(alpha.data(), prev, cur);       // x -= sum_j alpha_j V_j
+      }
+    }
+
+    double nrm2 = norm2(x);
+    if (nrm2 > 1e-16) ax(1.0 /sqrt(nrm2), x);
+    else errorQuda("\nCannot orthogonalize %u vector\n", i);
+  }
+
+  /**
+     @brief Orthonormalize a set of vectors in place with Cholesky QR,
+     applied twice for stability (CholQR2).  Each pass forms the Gram
+     matrix G = V^dagger V = R^dagger R with a single block reduction
+     and then applies V <- V R^{-1} with one block caxpy per vector,
+     so the number of global reductions does not grow with the size
+     of the set.
+     @return false if G is not numerically positive definite; V
+     still spans the same space, but is not orthonormal
+   */
+  static bool choleskyQR2(std::vector<ColorSpinorField*> &V)
+  {
+    const int n = V.size();
+    std::vector<Complex> G(n*n), R(n*n), S(n*n), a(n);
+
+    for (int pass=0; pass<2; pass++) {
+      hDotProduct(G.data(), V, V); // G[i*n+j] = <V_i, V_j>
+
+      // Cholesky factorization G = R^dagger R, with R upper triangular
+      for (int i=0; i<n; i++) {
+	for (int j=i; j<n; j++) {
+	  Complex sum = G[i*n+j];
+	  for (int k=0; k<i; k++) sum -= conj(R[k*n+i]) * R[k*n+j];
+	  if (j == i) {
+	    // relative threshold catches a Gram matrix that has lost definiteness to rounding
+	    if (sum.real() <= 1e-14 * G[i*n+i].real()) return false;
+	    R[i*n+i] = sqrt(sum.real());
+	  } else {
+	    R[i*n+j] = sum / R[i*n+i].real();
+	  }
+	}
+      }
+
+      // S = R^{-1}, also upper triangular
+      for (int j=0; j<n; j++) {
+	S[j*n+j] = 1.0 / R[j*n+j].real();
+	for (int i=j-1; i>=0; i--) {
+	  Complex sum = 0.0;
+	  for (int k=i+1; k<=j; k++) sum += R[i*n+k] * S[k*n+j];
+	  S[i*n+j] = -sum / R[i*n+i].real();
+	}
+      }
+
+      // V_j <- sum_{i<=j} V_i S_ij, working down from the last column
+      // so that every V_i read still holds its original value
+      for (int j=n-1; j>=0; j--) {
+	ax(S[j*n+j].real(), *V[j]);
+	if (j > 0) {
+	  std::vector<ColorSpinorField*> prev(V.begin(), V.begin()+j);
+	  std::vector<ColorSpinorField*> cur(1, V[j]);
+	  for (int i=0; i<j; i++) a[i] = S[i*n+j];
+	  caxpy(a.data(), prev, cur);
+	}
+      }
+    }
+
+    return true;
+  }
+
+  void MG::generateNullVectors(std::vector<ColorSpinorField*> B, bool refresh) {
+    printfQuda(refresh ? "\nRefresh null vectors\n" : "\nGenerate null vectors\n");
 
     SolverParam solverParam(param);  // Set solver field parameters:
 
@@ -796,35 +1177,61 @@ namespace quda {
       solve = Solver::create(solverParam, *param.matSmooth, *param.matSmoothSloppy, *param.matSmoothSloppy, profile);
     }
 
-    // Generate sources and launch solver for each source:
+    // Generate the random initial guesses (or start from the current
+    // vectors if refreshing) and copy them to the GPU
     for(unsigned int i=0; i<B.size(); i++) {
-      B[i]->Source(QUDA_RANDOM_SOURCE); //random initial guess
-
+      if (!refresh) B[i]->Source(QUDA_RANDOM_SOURCE); //random initial guess
       B_gpu.push_back(ColorSpinorField::Create(csParam));
-      ColorSpinorField *x = B_gpu[i];
-      *x = *B[i]; // copy initial guess to GPU:
+      *B_gpu[i] = *B[i];
+    }
 
+    // relax a vector towards the null space by solving A x = 0 with x as the initial guess
+    auto relax = [&](ColorSpinorField &x) {
       zero(*b); // need zero rhs
 
-      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Initial guess = %g\n", norm2(*x));
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Initial guess = %g\n", norm2(x));
 
       ColorSpinorField *out=nullptr, *in=nullptr;
-      dirac.prepare(in, out, *x, *b, QUDA_MAT_SOLUTION);
+      dirac.prepare(in, out, x, *b, QUDA_MAT_SOLUTION);
       (*solve)(*out, *in);
-      dirac.reconstruct(*x, *b, QUDA_MAT_SOLUTION);
-
-      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Solution = %g\n", norm2(*x));
+      dirac.reconstruct(x, *b, QUDA_MAT_SOLUTION);
+
+      if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Solution = %g\n", norm2(x));
+    };
+
+    // a refresh is a single short round of block relaxation
+    if (refresh) solverParam.maxiter = param.mg_global.setup_refresh_iter[param.level];
+    const int rounds = refresh ? 1 : param.mg_global.setup_block_rounds[param.level];
+
+    if (rounds > 0) {
+      // Block setup: relax the whole set for a share of the iteration
+      // budget, then orthonormalize it together.  Separating the
+      // vectors between rounds stops them all collapsing onto the
+      // lowest mode, and the orthonormalization costs a couple of
+      // block reductions per round rather than one per pair.
+      const int maxiter = solverParam.maxiter;
+      solverParam.maxiter = (maxiter + rounds - 1) / rounds; // the solver holds a reference to solverParam
+
+      for (int round=0; round<rounds; round++) {
+	for (auto x : B_gpu) relax(*x);
+
+	if (!choleskyQR2(B_gpu)) {
+	  if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Cholesky QR failed, falling back to block Gram-Schmidt\n");
+	  for (unsigned int i=0; i<B_gpu.size(); i++) orthonormalizeAgainst(B_gpu, i);
+	}
 
-      // global orthonormalization of the generated null-space vectors
-      for (int i=0; B_gpu[i] != x; ++i) {
-	Complex alpha = cDotProduct(*B_gpu[i], *x);//<j,i>
-	caxpy(-alpha, *B_gpu[i], *x); //i-<j,i>j
+	if (getVerbosity() >= QUDA_SUMMARIZE)
+	  printfQuda("Null-space setup round %d of %d complete\n", round+1, rounds);
       }
 
-      double nrm2 = norm2(*x);
-      if (nrm2 > 1e-16) ax(1.0 /sqrt(nrm2), *x);
-      else errorQuda("\nCannot orthogonalize %u vector\n", i);
-
+      solverParam.maxiter = maxiter;
+    } else {
+      // Sequential setup: relax each vector in turn and orthonormalize
+      // it against the ones already generated
+      for (unsigned int i=0; i<B_gpu.size(); i++) {
+	relax(*B_gpu[i]);
+	orthonormalizeAgainst(B_gpu, i);
+      }
     }
 
     delete solve;
@@ -835,7 +1242,7 @@ namespace quda {
       delete B_gpu[i];
     }
 
-    if (strcmp(param.mg_global.vec_outfile,"")!=0) { // only save if outfile is defined
+    if (!refresh && strcmp(param.mg_global.vec_outfile,"")!=0) { // only save if outfile is defined
       saveVectors(B);
     }
 
@@ -257,6 +257,14 @@ doubleN reduceCuda(const double2 &a, const double2 &b,
   return value;
 }
 
+/**
+   Number of fixed site partitions used by the host reduction.  Each
+   partition is reduced by a single thread and the partials are then
+   summed in partition order, so the result does not depend on the
+   number of threads.
+*/
+static constexpr int host_reduce_blocks = 256;
+
 /**
    Generic reduce kernel with four loads and up to four stores.
    FIXME - this is hacky due to the lack of std::complex support in
@@ -268,12 +276,23 @@ template <typename ReduceType, typename Float2, int writeX, int writeY, int writ
   typename SpinorW, typename SpinorV, typename Reducer>
 ReduceType genericReduce(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV &V, Reducer r) {
 
-  ReduceType sum;
-  ::quda::zero(sum);
-
-  for (int parity=0; parity<X.Nparity(); parity++) {
-    for (int x=0; x<X.VolumeCB(); x++) {
-      r.pre();
+  const int volumeCB = X.VolumeCB();
+  const int nSite = X.Nparity() * volumeCB;
+  const int nBlock = std::max(1, std::min(nSite, host_reduce_blocks));
+  std::vector<ReduceType> partial(nBlock);
+
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
+  for (int b=0; b<nBlock; b++) {
+    Reducer r_(r); // the reducer may carry per-site state between pre() and post()
+    ReduceType sum;
+    ::quda::zero(sum);
+
+    const int begin = (static_cast<long>(nSite) * b) / nBlock;
+    const int end = (static_cast<long>(nSite) * (b+1)) / nBlock;
+    for (int i=begin; i<end; i++) {
+      const int parity = i / volumeCB;
+      const int x = i - parity * volumeCB;
+      r_.pre();
       for (int s=0; s<X.Nspin(); s++) {
 	for (int c=0; c<X.Ncolor(); c++) {
 	  Float2 X2 = make_Float2<Float2>( X(parity, x, s, c) );
@@ -281,7 +300,7 @@ ReduceType genericReduce(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV
 	  Float2 Z2 = make_Float2<Float2>( Z(parity, x, s, c) );
 	  Float2 W2 = make_Float2<Float2>( W(parity, x, s, c) );
 	  Float2 V2 = make_Float2<Float2>( V(parity, x, s, c) );
-	  r(sum, X2, Y2, Z2, W2, V2);
+	  r_(sum, X2, Y2, Z2, W2, V2);
 	  if (writeX) X(parity, x, s, c) = make_Complex(X2);
 	  if (writeY) Y(parity, x, s, c) = make_Complex(Y2);
 	  if (writeZ) Z(parity, x, s, c) = make_Complex(Z2);
@@ -289,11 +308,16 @@ ReduceType genericReduce(SpinorX &X, SpinorY &Y, SpinorZ &Z, SpinorW &W, SpinorV
 	  if (writeV) V(parity, x, s, c) = make_Complex(V2);
 	}
       }
-      r.post(sum);
+      r_.post(sum);
     }
+    partial[b] = sum;
   }
 
-  return sum;
+  ReduceType value;
+  ::quda::zero(value);
+  for (int b=0; b<nBlock; b++) value += partial[b];
+
+  return value;
 }
 
 template<typename, int N> struct vector { };
@@ -17,7 +17,13 @@ namespace quda {
   void RitzMat::operator()(cudaColorSpinorField &out, const cudaColorSpinorField &in) const
   {
     using namespace blas;
-    
+
+    // no polynomial acceleration
+    if (N_Poly < 2) {
+      dirac_mat(out, in);
+      return;
+    }
+
     const double alpha = pow(cheby_param[0], 2);
     const double beta  = pow(cheby_param[1]+fabs(shift), 2);
 
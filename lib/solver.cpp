@@ -103,6 +103,18 @@ namespace quda {
       report("CGNR");
       solver = new CGNR(mat, matSloppy, param, profile);
       break;
+    case QUDA_PIPELINED_CG_INVERTER:
+      report("PipelinedCG");
+      solver = new PipelinedCG(mat, matSloppy, param, profile);
+      break;
+    case QUDA_CA_CG_INVERTER:
+      report("CACG");
+      solver = new CACG(mat, matSloppy, param, profile);
+      break;
+    case QUDA_CA_BICGSTAB_INVERTER:
+      report("CABiCGstab");
+      solver = new CABiCGstab(mat, matSloppy, param, profile);
+      break;
     default:
       errorQuda("Invalid solver type %d", param.inv_type);
     }
@@ -0,0 +1,94 @@
+#include <mutex>
+#include <quda_internal.h>
+#include <util_quda.h>
+#include <index_helper.cuh>
+#include <stencil_index.h>
+
+namespace quda {
+
+  StencilIndex::StencilIndex(const int *X_, int nDim, QudaDWFPCType pc_type, int hop, int nFace,
+			     const int *commDim_)
+    : nDim(nDim), pc_type(pc_type), hop(hop), nFace(nFace)
+  {
+    if (nDim != 4 && nDim != 5) errorQuda("Unsupported number of dimensions %d", nDim);
+
+    int volume = 1;
+    for (int d=0; d<5; d++) {
+      X[d] = d < nDim ? X_[d] : 1;
+      if (X[d] <= 0) errorQuda("Invalid lattice dimension X[%d] = %d", d, X[d]);
+      volume *= X[d];
+    }
+    for (int d=0; d<4; d++) {
+      commDim[d] = commDim_[d];
+      if (hop > X[d]) errorQuda("Neighbor distance %d exceeds lattice dimension X[%d] = %d", hop, d, X[d]);
+      if (commDim[d] && hop > nFace) errorQuda("Neighbor distance %d exceeds ghost depth %d", hop, nFace);
+    }
+    if (X[0] % 2) errorQuda("X[0] = %d must be even", X[0]);
+    volumeCB = volume / 2;
+
+    index.resize(2 * 2*nDim * (size_t)volumeCB);
+
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
+    for (int parity=0; parity<2; parity++) {
+      for (int x_cb=0; x_cb<volumeCB; x_cb++) {
+	int x[5];
+	getCoords5(x, x_cb, X, parity, pc_type);
+
+	for (int d=0; d<nDim; d++) {
+	  for (int back=0; back<2; back++) {
+	    int &nbr = index[(parity*2*nDim + 2*d + back)*(size_t)volumeCB + x_cb];
+
+	    if (d < 4 && commDim[d] && (back ? x[d] - hop < 0 : x[d] + hop >= X[d])) {
+	      // shift the coordinate so that ghostFaceIndex() lands on
+	      // the right slice of the ghost zone when hop < nFace
+	      int y[5] = {x[0], x[1], x[2], x[3], x[4]};
+	      y[d] = back ? x[d] - hop + nFace : x[d] + hop - nFace;
+	      int ghost_idx = back ? ghostFaceIndex<0>(y, X, d, nFace) : ghostFaceIndex<1>(y, X, d, nFace);
+	      nbr = -(ghost_idx + 1);
+	    } else {
+	      int y[5] = {x[0], x[1], x[2], x[3], x[4]};
+	      y[d] = (x[d] + (back ? -hop : hop) + X[d]) % X[d];
+	      nbr = ((((y[4] * X[3] + y[3]) * X[2] + y[2]) * X[1] + y[1]) * X[0] + y[0]) >> 1;
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  bool StencilIndex::Match(const int *X_, int nDim_, QudaDWFPCType pc_type_, int hop_, int nFace_,
+			   const int *commDim_) const
+  {
+    if (nDim != nDim_ || hop != hop_ || nFace != nFace_) return false;
+    if (nDim == 5 && pc_type != pc_type_) return false;
+    for (int d=0; d<nDim; d++) if (X[d] != X_[d]) return false;
+    for (int d=0; d<4; d++) if ((commDim[d] != 0) != (commDim_[d] != 0)) return false;
+    return true;
+  }
+
+  static std::vector<StencilIndex*> stencil_cache;
+  static std::mutex stencil_cache_mutex;
+
+  const StencilIndex& getStencilIndex(const int *X, int nDim, QudaDWFPCType pc_type, int hop, int nFace,
+				      const int *commDim)
+  {
+    std::lock_guard<std::mutex> lock(stencil_cache_mutex);
+
+    for (auto s : stencil_cache) if (s->Match(X, nDim, pc_type, hop, nFace, commDim)) return *s;
+
+    StencilIndex *stencil = new StencilIndex(X, nDim, pc_type, hop, nFace, commDim);
+    if (getVerbosity() >= QUDA_DEBUG_VERBOSE)
+      printfQuda("Created %d-d neighbor table (hop = %d, nFace = %d) of %lu bytes\n",
+		 nDim, hop, nFace, stencil->Bytes());
+    stencil_cache.push_back(stencil);
+    return *stencil;
+  }
+
+  void flushStencilIndex()
+  {
+    std::lock_guard<std::mutex> lock(stencil_cache_mutex);
+    for (auto s : stencil_cache) delete s;
+    stencil_cache.clear();
+  }
+
+} // namespace quda
@@ -18,7 +18,8 @@ namespace quda {
   * however we do even-odd to preserve chirality (that is straightforward)
   */
 
-  Transfer::Transfer(const std::vector<ColorSpinorField*> &B, int Nvec, int *geo_bs, int spin_bs, bool enable_gpu, TimeProfile &profile)
+  Transfer::Transfer(const std::vector<ColorSpinorField*> &B, int Nvec, int *geo_bs, int spin_bs, bool enable_gpu, TimeProfile &profile,
+		     bool build_V)
     : B(B), Nvec(Nvec), V_h(0), V_d(0), fine_tmp_h(0), fine_tmp_d(0), coarse_tmp_h(0), coarse_tmp_d(0), geo_bs(0),
       fine_to_coarse_h(0), coarse_to_fine_h(0), 
       fine_to_coarse_d(0), coarse_to_fine_d(0), 
@@ -83,8 +84,10 @@ namespace quda {
 
     V_d = enable_gpu ? ColorSpinorField::Create(param) : 0;
 
-    printfQuda("Transfer: filling V field with zero\n");
-    fillV(*V_h); // copy the null space vectors into V
+    if (build_V) {
+      printfQuda("Transfer: filling V field with zero\n");
+      fillV(*V_h); // copy the null space vectors into V
+    }
 
     param = ColorSpinorParam(*B[0]);
 
@@ -124,13 +127,15 @@ namespace quda {
       createSpinMap(spin_bs);
     }
 
-    // orthogonalize the blocks
-    printfQuda("Transfer: block orthogonalizing\n");
-    BlockOrthogonalize(*V_h, Nvec, geo_bs, fine_to_coarse_h, spin_bs);
+    if (build_V) {
+      // orthogonalize the blocks
+      printfQuda("Transfer: block orthogonalizing\n");
+      BlockOrthogonalize(*V_h, Nvec, geo_bs, fine_to_coarse_h, spin_bs);
 
-    if (enable_gpu) {
-      *V_d = *V_h;
-      printfQuda("Transferred prolongator to GPU\n");
+      if (enable_gpu) {
+	*V_d = *V_h;
+	printfQuda("Transferred prolongator to GPU\n");
+      }
     }
   }
 
@@ -194,6 +199,23 @@ namespace quda {
 
   }
 
+  void Transfer::reset() {
+    fillV(*V_h);
+    BlockOrthogonalize(*V_h, Nvec, geo_bs, fine_to_coarse_h, spin_bs);
+    uploadV();
+  }
+
+  void Transfer::setVectors(const ColorSpinorField &V) {
+    *V_h = V;
+    uploadV();
+  }
+
+  void Transfer::uploadV() {
+    if (!enable_gpu) return;
+    if (site_subset == QUDA_PARITY_SITE_SUBSET) *V_d = parity == QUDA_EVEN_PARITY ? V_h->Even() : V_h->Odd();
+    else *V_d = *V_h;
+  }
+
   void Transfer::fillV(ColorSpinorField &V) { 
     FillV(V, B, Nvec);  //printfQuda("V fill check %e\n", norm2(*V));
   }
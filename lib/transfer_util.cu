@@ -1,6 +1,7 @@
 #include <color_spinor_field.h>
 #include <color_spinor_field_order.h>
 #include <tune_quda.h>
+#include <util_quda.h>
 #include <typeinfo>
 #include <vector>
 #include <assert.h>
@@ -190,378 +191,139 @@ namespace quda {
 
 #ifdef GPU_MULTIGRID
 
-  // Creates a block-ordered version of a ColorSpinorField
-  // N.B.: Only works for the V field, as we need to block spin.
-  template <bool toBlock, int nVec, class Complex, class FieldOrder>
-  void blockOrderV(Complex *out, FieldOrder &in,
-		   const int *geo_map, const int *geo_bs, int spin_bs,
-		   const cpuColorSpinorField &V) {
-    //printfQuda("in.Ncolor = %d\n", in.Ncolor());
-    int nSpin_coarse = in.Nspin() / spin_bs; // this is number of chiral blocks
-
-    //Compute the size of each block
-    int geoBlockSize = 1;
-    for (int d=0; d<in.Ndim(); d++) geoBlockSize *= geo_bs[d];
-    int blockSize = geoBlockSize * in.Ncolor() * spin_bs; // blockSize includes internal dof
-
-    int x[QUDA_MAX_DIM]; // global coordinates
-    int y[QUDA_MAX_DIM]; // local coordinates within a block (full site ordering)
-
-    int checkLength = in.Nparity() * in.VolumeCB() * in.Ncolor() * in.Nspin() * in.Nvec();
-    int *check = new int[checkLength];
-    int count = 0;
-
-    // Run through the fine grid and do the block ordering
-    for (int parity = 0; parity<in.Nparity(); parity++) {
-      for (int x_cb=0; x_cb<in.VolumeCB(); x_cb++) {
-	int i = parity*in.VolumeCB() + x_cb;
-
-	// Get fine grid coordinates
-	V.LatticeIndex(x, i);
-	
-	//Compute the geometric offset within a block 
-	// (x fastest direction, t is slowest direction, non-parity ordered)
-	int blockOffset = 0;
-	for (int d=in.Ndim()-1; d>=0; d--) {
-	  y[d] = x[d]%geo_bs[d];
-	  blockOffset *= geo_bs[d];
-	  blockOffset += y[d];
-	}
-	
-	//Take the block-ordered offset from the coarse grid offset (geo_map) 
-	int offset = geo_map[i]*nSpin_coarse*nVec*geoBlockSize*in.Ncolor()*spin_bs;
-	
-	for (int v=0; v<in.Nvec(); v++) {
-	  for (int s=0; s<in.Nspin(); s++) {
-	    for (int c=0; c<in.Ncolor(); c++) {
-	      
-	      int chirality = s / spin_bs; // chirality is the coarse spin
-	      int blockSpin = s % spin_bs; // the remaining spin dof left in each block
-	      
-	      int index = offset +                                              // geo block
-		chirality * nVec * geoBlockSize * spin_bs * in.Ncolor() + // chiral block
-	                       v * geoBlockSize * spin_bs * in.Ncolor() + // vector
-	                            blockOffset * spin_bs * in.Ncolor() + // local geometry
-	                                          blockSpin*in.Ncolor() + // block spin
-	                                                                   c;   // color
-
-	      if (toBlock) out[index] = in(parity, x_cb, s, c, v); // going to block order
-	      else in(parity, x_cb, s, c, v) = out[index]; // coming from block order
-	    
-	      check[count++] = index;
-	    }
-	  }
-	}
-      }
-
-      //printf("blockOrderV done %d / %d\n", i, in.Volume());
+  /**
+     Orthonormalize the prolongator in place, one block at a time.  A
+     block is the set of fine-grid degrees of freedom that map onto a
+     given coarse-grid site and chirality (for staggered fields the
+     chirality is the fine-grid parity).  The blocks are independent,
+     so these are distributed over the host threads, with each thread
+     gathering its block from the field accessor into a contiguous
+     buffer, orthonormalizing it there and scattering it back.
+
+     The orthogonalization is classical Gram-Schmidt with
+     reorthogonalization (CGS2): all projections onto the previous
+     vectors are formed before any are subtracted, and this is done
+     twice, which recovers the stability of modified Gram-Schmidt
+     while giving a dense, cache-friendly inner loop.  All
+     accumulation is done in double precision.  A vector that is
+     numerically zero on a block is left zero.
+   */
+  template <typename Float, int nSpin, int nColor, int nVec, typename Order>
+  void BlockOrthoCPU(Order &vOrder, const int *geo_map, int spin_bs, int nCoarse, int geo_blocksize) {
+    const int volumeCB = vOrder.VolumeCB();
+    const int volume = vOrder.Nparity() * volumeCB;
+    const int chiralBlocks = (nSpin == 1) ? 2 : nSpin / spin_bs;
+    const int spinBlock = (nSpin == 1) ? 1 : spin_bs;
+    const int maxBlockSize = geo_blocksize * spinBlock * nColor;
+
+    // list the fine-grid sites of each coarse-grid site (counting sort on geo_map)
+    std::vector<int> offset(nCoarse+1, 0);
+    std::vector<int> sites(volume);
+    for (int i=0; i<volume; i++) {
+      if (geo_map[i] < 0 || geo_map[i] >= nCoarse) errorQuda("Invalid coarse index %d for fine site %d", geo_map[i], i);
+      offset[geo_map[i]+1]++;
     }
-    
-    if (count != checkLength) {
-      errorQuda("Number of elements packed %d does not match expected value %d nvec=%d nspin=%d ncolor=%d", 
-		count, checkLength, in.Nvec(), in.Nspin(), in.Ncolor());
+    for (int k=0; k<nCoarse; k++) {
+      if (offset[k+1] != geo_blocksize)
+	errorQuda("Coarse site %d has %d fine sites, expected %d", k, offset[k+1], geo_blocksize);
+      offset[k+1] += offset[k];
     }
-
-    /*
-    // need non-quadratic check
-    for (int i=0; i<checkLength; i++) {
-      for (int j=0; j<i; j++) {
-      if (check[i] == check[j]) errorQuda("Collision detected in block ordering\n");
-      }
+    {
+      std::vector<int> next(offset.begin(), offset.end()-1);
+      for (int i=0; i<volume; i++) sites[next[geo_map[i]]++] = i;
     }
-    */
-    delete []check;
-  }
-
 
-  // Creates a block-ordered version of a ColorSpinorField, with parity blocking (for staggered fields)
-  // N.B.: same as above but parity are separated.
-  template <bool toBlock, int nVec, class Complex, class FieldOrder>
-  void blockCBOrderV(Complex *out, FieldOrder &in,
-		     const int *geo_map, const int *geo_bs, int spin_bs,
-		     const cpuColorSpinorField &V) {
-    //Compute the size of each block
-    int geoBlockSize = 1;
-    for (int d=0; d<in.Ndim(); d++) geoBlockSize *= geo_bs[d];
-    int blockSize = geoBlockSize * in.Ncolor(); // blockSize includes internal dof
-
-    int x[QUDA_MAX_DIM]; // global coordinates
-    int y[QUDA_MAX_DIM]; // local coordinates within a block (full site ordering)
-
-    int checkLength = in.Nparity() * in.VolumeCB() * in.Ncolor() * in.Nvec();
-    int *check = new int[checkLength];
-    int count = 0;
-
-    // Run through the fine grid and do the block ordering
-    for (int parity = 0; parity<in.Nparity(); parity++) {
-      for (int x_cb=0; x_cb<in.VolumeCB(); x_cb++) {
-	int i = parity*in.VolumeCB() + x_cb;
-
-	// Get fine grid coordinates
-	V.LatticeIndex(x, i);
-
-	//Compute the geometric offset within a block 
-	// (x fastest direction, t is slowest direction, non-parity ordered)
-	int blockOffset = 0;
-	for (int d=in.Ndim()-1; d>=0; d--) {
-	  y[d] = x[d]%geo_bs[d];
-	  blockOffset *= geo_bs[d];
-	  blockOffset += y[d];
+    const int nBlock = nCoarse * chiralBlocks;
+
+#pragma omp parallel num_threads(getOmpThreads())
+    {
+      // v-th vector of the current block is v_[v*blockSize + i]
+      std::vector<complex<double> > v_(nVec * maxBlockSize);
+      complex<double> dot[nVec];
+
+#pragma omp for schedule(static)
+      for (int b=0; b<nBlock; b++) {
+	const int k = b / chiralBlocks;
+	const int chirality = b % chiralBlocks;
+
+	// count the block length (staggered blocks only hold one parity)
+	int blockSize = 0;
+	for (int j=offset[k]; j<offset[k+1]; j++) {
+	  const int parity = sites[j] / volumeCB;
+	  if (nSpin == 1 && parity != chirality) continue;
+	  blockSize += spinBlock * nColor;
 	}
 
-	//Take the block-ordered offset from the coarse grid offset (geo_map) 
-	//A.S.: geo_map introduced for the full site ordering, so ok to use it for the offset
-	int offset = geo_map[i]*nVec*geoBlockSize*in.Ncolor();
-
-	const int s = 0;
-
-	for (int v=0; v<in.Nvec(); v++) {
-	  for (int c=0; c<in.Ncolor(); c++) {
-
-	    int chirality = (x[0]+x[1]+x[2]+x[3])%2; // chirality is the fine-grid parity flag
-
-	    int index = offset +                                // geo block
-	      chirality * nVec * geoBlockSize * in.Ncolor() + // chiral block
-	                     v * geoBlockSize * in.Ncolor() + // vector
-	                          blockOffset * in.Ncolor() + // local geometry
-	                                                       c;   // color
-
-	    if (toBlock) out[index] = in(parity, x_cb, s, c, v); // going to block order
-	    else in(parity, x_cb, s, c, v) = out[index]; // coming from block order
-
-	    check[count++] = index;
+	// gather
+	int i = 0;
+	for (int j=offset[k]; j<offset[k+1]; j++) {
+	  const int parity = sites[j] / volumeCB;
+	  const int x_cb = sites[j] - parity * volumeCB;
+	  if (nSpin == 1 && parity != chirality) continue;
+	  for (int s=chirality*spinBlock; s<(chirality+1)*spinBlock; s++) {
+	    const int s_ = (nSpin == 1) ? 0 : s;
+	    for (int c=0; c<nColor; c++, i++) {
+	      for (int v=0; v<nVec; v++) {
+		const complex<Float> z = vOrder(parity, x_cb, s_, c, v);
+		v_[v*blockSize + i] = complex<double>(z.real(), z.imag());
+	      }
+	    }
 	  }
 	}
 
-	//printf("blockOrderV done %d / %d\n", i, in.Volume());
-      } // x_cb
-    } // parity
-
-    if (count != checkLength) {
-      errorQuda("Number of elements packed %d does not match expected value %d nvec=%d ncolor=%d", 
-		count, checkLength, in.Nvec(), in.Ncolor());
-    }
-
-    delete []check;
-  }
-
-
-
-
-  // Orthogonalise the nc vectors v[] of length n
-  // this assumes the ordering v[(b * Nvec + v) * blocksize + i]
-
-  template <typename sumFloat, typename Float, int N>
-  void blockGramSchmidt(complex<Float> *v, int nBlocks, int blockSize) {
-    
-    for (int b=0; b<nBlocks; b++) {
-      for (int jc=0; jc<N; jc++) {
-      
-	for (int ic=0; ic<jc; ic++) {
-	  // Calculate dot product.
-	  complex<Float> dot = 0.0;
-	  for (int i=0; i<blockSize; i++) 
-	    dot += conj(v[(b*N+ic)*blockSize+i]) * v[(b*N+jc)*blockSize+i];
-	  
-	  // Subtract the blocks to orthogonalise
-	  for (int i=0; i<blockSize; i++) 
-	    v[(b*N+jc)*blockSize+i] -= dot * v[(b*N+ic)*blockSize+i];
-	}
-	
-	// Normalize the block
-	// nrm2 is pure real, but need to use Complex because of template.
-        sumFloat nrm2 = 0.0;
-	for (int i=0; i<blockSize; i++) nrm2 += norm(v[(b*N+jc)*blockSize+i]);
-	sumFloat scale = nrm2 > 0.0 ? 1.0/sqrt(nrm2) : 0.0;
-	for (int i=0; i<blockSize; i++) v[(b*N+jc)*blockSize+i] *= scale;
-      }
-
-      /*      
-      for (int jc=0; jc<N; jc++) {
-        complex<sumFloat> nrm2 = 0.0;
-        for(int i=0; i<blockSize; i++) nrm2 += norm(v[(b*N+jc)*blockSize+i]);
-	//printfQuda("block = %d jc = %d nrm2 = %f\n", b, jc, nrm2.real());
-      }
-      */
-
-      //printf("blockGramSchmidt done %d / %d\n", b, nBlocks);
-    }
-
-  }
-
-  template <typename sumType, typename real, int N>
-  class BlockGramSchmidt : public Tunable {
-
-    complex<real> *v;
-    int nBlock;
-    int blockSize;
-    const ColorSpinorField &meta;
-
-    unsigned int sharedBytesPerThread() const { return 0; }
-    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
-
-  public:
-    BlockGramSchmidt(complex<real> *v, int nBlock, int blockSize, const ColorSpinorField &meta)
-      : v(v), nBlock(nBlock), blockSize(blockSize), meta(meta) {
-      if (meta.Location() == QUDA_CPU_FIELD_LOCATION) sprintf(aux, "nBlock=%d,blockSize=%d,CPU", nBlock, blockSize);
-      else sprintf(aux, "nBlock=%d,blockSize=%d,GPU", nBlock, blockSize);
-    }
-
-    virtual ~BlockGramSchmidt() { }
-
-    void apply(const cudaStream_t &stream) {
-      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      if (meta.Location() == QUDA_CPU_FIELD_LOCATION) {
-	blockGramSchmidt<sumType, real, N>(v, nBlock, blockSize);
-      } else {
-	errorQuda("Not implemented for GPU");
-      }
-    }
-
-    bool advanceTuneParam(TuneParam &param) const { return false; }
-
-    TuneKey tuneKey() const { return TuneKey(meta.VolString(), typeid(*this).name(), aux); }
-
-    long long flops() const { return nBlock * N * ((N-1) * (8l + 8l) + 2l) * blockSize; }
-    long long bytes() const { return 2*meta.Bytes(); }
-  };
-
-  template <bool toBlock, int N, typename real, typename Order>
-  class BlockOrderV : public Tunable {
-
-    complex<real> *vBlock;
-    Order &vOrder;
-    const int *geo_map;
-    const int *geo_bs;
-    int spin_bs;
-    const ColorSpinorField &V;
-
-    unsigned int sharedBytesPerThread() const { return 0; }
-    unsigned int sharedBytesPerBlock(const TuneParam &param) const { return 0; }
-
-  public:
-    BlockOrderV(complex<real> *vBlock, Order &vOrder, const int *geo_map, const int *geo_bs, int spin_bs, const ColorSpinorField &V)
-      : vBlock(vBlock), vOrder(vOrder), geo_map(geo_map), geo_bs(geo_bs), spin_bs(spin_bs), V(V) {
-      (V.Location() == QUDA_CPU_FIELD_LOCATION) ? strcpy(aux, "CPU") : strcpy(aux,"GPU");
-    }
-
-    virtual ~BlockOrderV() { }
-
-    void apply(const cudaStream_t &stream) {
-      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      if (V.Location() == QUDA_CPU_FIELD_LOCATION) {
-	blockOrderV<toBlock,N,complex<real>,Order>(vBlock,vOrder,geo_map,geo_bs,spin_bs,V);
-      } else {
-	errorQuda("Not implemented for GPU");
-      }
-    }
-
-    bool advanceTuneParam(TuneParam &param) const { return false; }
-
-    TuneKey tuneKey() const { return TuneKey(V.VolString(), typeid(*this).name(), aux); }
-
-    long long flops() const { return 0; }
-    long long bytes() const { return 2*V.Bytes(); }
-  };
-
-#if 0
-  using namespace quda::colorspinor;
-
-  /**
-      Kernel argument struct
-  */
-  template <typename Out, typename In, typename Rotator, int fineSpin, int coarseSpin>
-  struct BlockOrthoArg {
-    const Rotator V;
-    const int *fine_to_coarse;
-    const int *coarse_to_fine;
-    const spin_mapper<fineSpin,coarseSpin> spin_map;
-    const int parity; // the parity of the input field (if single parity)
-    const int nParity; // number of parities of input fine field
-    int swizzle; // swizzle factor for transposing blockIdx.x mapping to coarse grid coordinate
-
-    BlockOrthoArg(Rotator &V, const int *fine_to_coarse, const int *coarse_to_fine,
-		  int parity, const ColorSpinorField &meta) :
-      out(out), in(in), V(V), fine_to_coarse(fine_to_coarse), coarse_to_fine(coarse_to_fine),
-      spin_map(), parity(parity), nParity(meta.SiteSubset()), swizzle(1)
-    { }
-
-    BlockOrthoArg(const BlockOrthoArg<Out,In,Rotator,fineSpin,coarseSpin> &arg) :
-      out(arg.out), in(arg.in), V(arg.V),
-      fine_to_coarse(arg.fine_to_coarse), coarse_to_fine(arg.coarse_to_fine), spin_map(),
-      parity(arg.parity), nParity(arg.nParity), swizzle(arg.swizzle)
-    { }
-  };
-
-  template <typename Float, int nVec, int fineSpin, int coarseSpin, typename Arg>
-  void BlockOrtho(Arg &arg) {
-
-    constexpr spinBlocks = fineSpin / coarseSpin;
-
-    for (int b=0; b<nBlocks; b++) {
-      for (int s=0; s<spinBlocks; s++) {
-
-	for (int k=0; k<nVec; k++) {
-
-	  for (int l=0; l<k; l++) {
-	    complex<Float> dot = 0.0;
-
-	    for (int i=0; i<blockSize; i++) {
-
-	      dot += conj(v(parity, x_cb, s, c, l)) * v(parity, x_cb, s, c, k);
+	// orthonormalize
+	for (int jv=0; jv<nVec; jv++) {
+	  complex<double> *w = &v_[jv*blockSize];
 
+	  for (int pass=0; pass<2; pass++) {
+	    for (int iv=0; iv<jv; iv++) {
+	      const complex<double> *u = &v_[iv*blockSize];
+	      complex<double> sum = 0.0;
+	      for (int l=0; l<blockSize; l++) sum += conj(u[l]) * w[l];
+	      dot[iv] = sum;
+	    }
+	    for (int iv=0; iv<jv; iv++) {
+	      const complex<double> *u = &v_[iv*blockSize];
+	      for (int l=0; l<blockSize; l++) w[l] -= dot[iv] * u[l];
 	    }
+	  }
 
+	  double nrm2 = 0.0;
+	  for (int l=0; l<blockSize; l++) nrm2 += norm(w[l]);
+	  const double scale = nrm2 > 0.0 ? 1.0/sqrt(nrm2) : 0.0;
+	  for (int l=0; l<blockSize; l++) w[l] *= scale;
 	}
 
-      }
-    }
-
-    for (int parity_coarse=0; parity_coarse<2; parity_coarse++)
-      for (int x_coarse_cb=0; x_coarse_cb<arg.out.VolumeCB(); x_coarse_cb++)
-	for (int s=0; s<coarseSpin; s++)
-	  for (int c=0; c<coarseColor; c++)
-	    arg.out(parity_coarse, x_coarse_cb, s, c) = 0.0;
-
-    // loop over fine degrees of freedom
-    for (int parity=0; parity<arg.nParity; parity++) {
-      parity = (arg.nParity == 2) ? parity : arg.parity;
-
-      for (int x_cb=0; x_cb<arg.in.VolumeCB(); x_cb++) {
-
-	int x = parity*arg.in.VolumeCB() + x_cb;
-	int x_coarse = arg.fine_to_coarse[x];
-	int parity_coarse = (x_coarse >= arg.out.VolumeCB()) ? 1 : 0;
-	int x_coarse_cb = x_coarse - parity_coarse*arg.out.VolumeCB();
-
-	for (int coarse_color_block=0; coarse_color_block<coarseColor; coarse_color_block+=coarse_colors_per_thread) {
-	  complex<Float> tmp[fineSpin*coarse_colors_per_thread];
-	  rotateCoarseColor<Float,fineSpin,fineColor,coarseColor,coarse_colors_per_thread>
-	    (tmp, arg.in, arg.V, parity, arg.nParity, x_cb, coarse_color_block);
-
-	  for (int s=0; s<fineSpin; s++) {
-	    for (int coarse_color_local=0; coarse_color_local<coarse_colors_per_thread; coarse_color_local++) {
-	      int c = coarse_color_block + coarse_color_local;
-	      arg.out(parity_coarse,x_coarse_cb,arg.spin_map(s),c) += tmp[s*coarse_colors_per_thread+coarse_color_local];
+	// scatter
+	i = 0;
+	for (int j=offset[k]; j<offset[k+1]; j++) {
+	  const int parity = sites[j] / volumeCB;
+	  const int x_cb = sites[j] - parity * volumeCB;
+	  if (nSpin == 1 && parity != chirality) continue;
+	  for (int s=chirality*spinBlock; s<(chirality+1)*spinBlock; s++) {
+	    const int s_ = (nSpin == 1) ? 0 : s;
+	    for (int c=0; c<nColor; c++, i++) {
+	      for (int v=0; v<nVec; v++) {
+		const complex<double> &z = v_[v*blockSize + i];
+		vOrder(parity, x_cb, s_, c, v) = complex<Float>(z.real(), z.imag());
+	      }
 	    }
 	  }
-
 	}
       }
     }
 
   }
-#endif
 
-    template<typename Float, int nSpin, int nColor, int nVec>
+  template<typename Float, int nSpin, int nColor, int nVec>
   void BlockOrthogonalize(ColorSpinorField &V, const int *geo_bs, const int *geo_map, int spin_bs) {
-    complex<Float> *Vblock = new complex<Float>[V.Volume()*V.Nspin()*V.Ncolor()];
+    if (V.Location() != QUDA_CPU_FIELD_LOCATION) errorQuda("Block orthogonalization is only supported on the host");
 
     if (V.FieldOrder() == QUDA_SPACE_SPIN_COLOR_FIELD_ORDER) {
       constexpr QudaFieldOrder order = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
 
       typedef FieldOrderCB<Float,nSpin,nColor,nVec,order> VectorField;
-      VectorField vOrder(const_cast<ColorSpinorField&>(V));
+      VectorField vOrder(V);
 
       int geo_blocksize = 1;
       for (int d = 0; d < V.Ndim(); d++) geo_blocksize *= geo_bs[d];
@@ -570,25 +332,10 @@ namespace quda {
       int chiralBlocks = (V.Nspin() == 1) ? 2 : vOrder.Nspin() / spin_bs; //always 2 for staggered.
       int numblocks = (V.Volume()/geo_blocksize) * chiralBlocks;
       if (V.Nspin() == 1) blocksize /= chiralBlocks; //for staggered chiral block size is a parity block size
-    
-      printfQuda("Block Orthogonalizing %d blocks of %d length and width %d\n", numblocks, blocksize, nVec);
-
-#if 0
-      BlockOrthoArg<> arg(V);
-      BlockOrtho ortho();
-      otho.apply(0);
-#endif
 
-      BlockOrderV<true,nVec,Float,VectorField> reorder(Vblock, vOrder, geo_map, geo_bs, spin_bs, V);
-      reorder.apply(0);
-
-      BlockGramSchmidt<double,Float,nVec> ortho(Vblock, numblocks, blocksize, V);
-      ortho.apply(0);
-
-      BlockOrderV<false,nVec,Float,VectorField> reset(Vblock, vOrder, geo_map, geo_bs, spin_bs, V);
-      reset.apply(0);
+      printfQuda("Block Orthogonalizing %d blocks of %d length and width %d\n", numblocks, blocksize, nVec);
 
-      delete []Vblock;
+      BlockOrthoCPU<Float,nSpin,nColor,nVec>(vOrder, geo_map, spin_bs, V.Volume()/geo_blocksize, geo_blocksize);
 
     } else {
       errorQuda("Unsupported field order %d\n", V.FieldOrder());
@@ -8,6 +8,7 @@
 #include <fstream>
 #include <typeinfo>
 #include <map>
+#include <vector>
 #include <list>
 #include <unistd.h>
 
@@ -85,12 +86,120 @@ namespace quda {
     return enable_trace;
   }
 
+  /**
+     Flat open-addressing (linear probing) index into the tunecache,
+     keyed on the 64-bit TuneKey digest.  The map remains the
+     authoritative store and defines the serialization order, while
+     this index gives constant-time lookup on the launch path without
+     any string comparisons.  Since std::map never relocates its
+     elements, the index can simply store pointers to the parameters.
+   */
+  class TuneCacheIndex {
+
+    struct Slot {
+      uint64_t hash; // zero denotes an empty slot
+      TuneParam *param;
+      Slot() : hash(0), param(nullptr) { }
+    };
+
+    std::vector<Slot> slots;
+    size_t n_entries;
+    size_t mask;
+
+    // statistics for the launch timer report
+    mutable size_t n_lookups;
+    mutable size_t n_probes;
+    mutable size_t n_misses;
+
+    void resize(size_t capacity) {
+      std::vector<Slot> old(capacity);
+      old.swap(slots);
+      mask = capacity - 1;
+      n_entries = 0;
+      for (auto &slot : old) if (slot.hash) insert(slot.hash, slot.param);
+    }
+
+  public:
+    TuneCacheIndex() : slots(1024), n_entries(0), mask(1023), n_lookups(0), n_probes(0), n_misses(0) { }
+
+    /**
+       @brief Return the parameters associated with a given digest, or
+       nullptr if it is not present
+     */
+    inline TuneParam* find(uint64_t hash) const {
+      n_lookups++;
+      for (size_t i = hash & mask; ; i = (i+1) & mask) {
+	n_probes++;
+	if (slots[i].hash == hash) return slots[i].param;
+	if (slots[i].hash == 0) { n_misses++; return nullptr; }
+      }
+    }
+
+    /**
+       @brief Insert a digest into the index, keeping the load factor
+       below one half.  Returns false if the digest is already present
+       with a different parameter set, i.e., two distinct keys collide.
+     */
+    bool insert(uint64_t hash, TuneParam *param) {
+      if (2*(n_entries+1) > slots.size()) resize(2*slots.size());
+      for (size_t i = hash & mask; ; i = (i+1) & mask) {
+	if (slots[i].hash == hash) return slots[i].param == param;
+	if (slots[i].hash == 0) {
+	  slots[i].hash = hash;
+	  slots[i].param = param;
+	  n_entries++;
+	  return true;
+	}
+      }
+    }
+
+    size_t size() const { return n_entries; }
+    size_t lookups() const { return n_lookups; }
+    size_t misses() const { return n_misses; }
+    double probeLength() const { return n_lookups ? static_cast<double>(n_probes) / n_lookups : 0.0; }
+  };
+
   static const std::string quda_hash = QUDA_HASH; // defined in lib/Makefile
   static std::string resource_path;
   static map tunecache;
-  static map::iterator it;
+  static TuneCacheIndex tunecache_index;
   static size_t initial_cache_size = 0;
 
+  /**
+     @brief Insert (or overwrite) an entry in the tunecache, keeping the
+     hashed index in sync.
+     @return Reference to the parameters stored in the tunecache
+   */
+  static TuneParam& insertTuneCache(const TuneKey &key, const TuneParam &param)
+  {
+    TuneParam &entry = tunecache[key];
+    entry = param;
+    if (!tunecache_index.insert(key.hash, &entry))
+      errorQuda("TuneKey digest collision for (%s:%s:%s)", key.name, key.volume, key.aux);
+    return entry;
+  }
+
+  /**
+     @brief Return the tunecache entry for a given key, or nullptr if
+     it is not present.  This only compares digests; in debug builds
+     we also check that the digest is not stale and resolves to the
+     expected key.
+   */
+  static inline TuneParam* findTuneCache(const TuneKey &key)
+  {
+#ifdef HOST_DEBUG
+    if (key.hash != key.digest())
+      errorQuda("Stale TuneKey digest for (%s:%s:%s): missing call to TuneKey::rehash()?", key.name, key.volume, key.aux);
+    TuneParam *param = tunecache_index.find(key.hash);
+    map::iterator it = tunecache.find(key);
+    if (param != (it == tunecache.end() ? nullptr : &it->second))
+      errorQuda("Tunecache index mismatch for (%s:%s:%s)", key.name, key.volume, key.aux);
+    return param;
+#else
+    return tunecache_index.find(key.hash);
+#endif
+  }
+
 #define STR_(x) #x
 #define STR(x) STR_(x)
   static const std::string quda_version = STR(QUDA_VERSION_MAJOR) "." STR(QUDA_VERSION_MINOR) "." STR(QUDA_VERSION_SUBMINOR);
@@ -109,6 +218,8 @@ namespace quda {
 
   const map& getTuneCache() { return tunecache; }
 
+  bool tuneCacheHit(const TuneKey &key) { return findTuneCache(key) != nullptr; }
+
 
   /**
    * Deserialize tunecache from an istream, useful for reading a file or receiving from other nodes.
@@ -143,7 +254,8 @@ namespace quda {
       ls.ignore(1); // throw away tab before comment
       getline(ls, param.comment); // assume anything remaining on the line is a comment
       param.comment += "\n"; // our convention is to include the newline, since ctime() likes to do this
-      tunecache[key] = param;
+      key.rehash();
+      insertTuneCache(key, param);
     }
   }
 
@@ -264,6 +376,304 @@ namespace quda {
   }
 
 
+  /**
+     Fixed-size binary tunecache record.  This is the layout used for
+     the records of both tunecache.bin and tunecache.journal, as well
+     as for distributing the tunecache between ranks, so it must
+     remain POD.  Any change to this struct requires bumping
+     tunecache_format.
+   */
+  struct TuneRecord {
+    static const int comment_n = 128;
+    uint64_t hash;
+    char volume[TuneKey::volume_n];
+    char name[TuneKey::name_n];
+    char aux[TuneKey::aux_n];
+    int32_t block[3];
+    int32_t grid[3];
+    int32_t shared_bytes;
+    int32_t aux_param[4];
+    float time;
+    char comment[comment_n];
+  };
+
+  /**
+     Header at the start of tunecache.bin and tunecache.journal.  For
+     the journal n_records is left at zero and the number of records
+     is implied by the file size, since we only ever append to it.
+   */
+  struct TuneCacheHeader {
+    char magic[8];
+    uint32_t format;
+    uint32_t record_size;
+    uint64_t n_records;
+    char version[32];
+    char gitversion[128];
+    char hash[256];
+  };
+
+  static const char tunecache_magic[8] = { 'Q', 'U', 'D', 'A', 'T', 'U', 'N', 'E' };
+  static const uint32_t tunecache_format = 1;
+
+  /** keys tuned since the tunecache was last written to disk */
+  static std::vector<TuneKey> tunecache_pending;
+
+  /** number of records in tunecache.bin and tunecache.journal */
+  static size_t tunecache_base_records = 0;
+  static size_t tunecache_journal_records = 0;
+
+  /** set if the binary tunecache must be rewritten in full (e.g., after a TSV import) */
+  static bool tunecache_compact = false;
+
+  static std::string buildVersion()
+  {
+#ifdef GITVERSION
+    return gitversion;
+#else
+    return quda_version;
+#endif
+  }
+
+  static void toRecord(TuneRecord &record, const TuneKey &key, const TuneParam &param)
+  {
+    memset(&record, 0, sizeof(TuneRecord));
+    record.hash = key.hash;
+    strcpy(record.volume, key.volume);
+    strcpy(record.name, key.name);
+    strcpy(record.aux, key.aux);
+    record.block[0] = param.block.x; record.block[1] = param.block.y; record.block[2] = param.block.z;
+    record.grid[0] = param.grid.x; record.grid[1] = param.grid.y; record.grid[2] = param.grid.z;
+    record.shared_bytes = param.shared_bytes;
+    record.aux_param[0] = param.aux.x; record.aux_param[1] = param.aux.y;
+    record.aux_param[2] = param.aux.z; record.aux_param[3] = param.aux.w;
+    record.time = param.time;
+    strncpy(record.comment, param.comment.c_str(), TuneRecord::comment_n-1);
+    // the comment is only informational, but ensure a truncated comment still ends with a newline
+    if (param.comment.length() >= (size_t)TuneRecord::comment_n-1) record.comment[TuneRecord::comment_n-2] = '\n';
+  }
+
+  static void fromRecord(const TuneRecord &record)
+  {
+    TuneKey key(record.volume, record.name, record.aux);
+    if (key.hash != record.hash) errorQuda("Corrupt tunecache record (%s:%s:%s)", key.name, key.volume, key.aux);
+
+    TuneParam param;
+    param.block = dim3(record.block[0], record.block[1], record.block[2]);
+    param.grid = dim3(record.grid[0], record.grid[1], record.grid[2]);
+    param.shared_bytes = record.shared_bytes;
+    param.aux = make_int4(record.aux_param[0], record.aux_param[1], record.aux_param[2], record.aux_param[3]);
+    param.time = record.time;
+    param.comment = record.comment;
+    insertTuneCache(key, param);
+  }
+
+  static void initHeader(TuneCacheHeader &header, size_t n_records)
+  {
+    memset(&header, 0, sizeof(TuneCacheHeader));
+    memcpy(header.magic, tunecache_magic, sizeof(tunecache_magic));
+    header.format = tunecache_format;
+    header.record_size = sizeof(TuneRecord);
+    header.n_records = n_records;
+    strncpy(header.version, quda_version.c_str(), sizeof(header.version)-1);
+    strncpy(header.gitversion, buildVersion().c_str(), sizeof(header.gitversion)-1);
+    strncpy(header.hash, quda_hash.c_str(), sizeof(header.hash)-1);
+  }
+
+  static void checkHeader(const TuneCacheHeader &header, const std::string &path)
+  {
+    if (memcmp(header.magic, tunecache_magic, sizeof(tunecache_magic)) || header.format != tunecache_format ||
+	header.record_size != sizeof(TuneRecord))
+      errorQuda("Bad format in %s", path.c_str());
+    if (quda_version.compare(0, sizeof(header.version), header.version) ||
+	buildVersion().compare(0, sizeof(header.gitversion), header.gitversion))
+      errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", path.c_str());
+    if (quda_hash.compare(0, sizeof(header.hash), header.hash))
+      errorQuda("Cache file %s does not match current QUDA build. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", path.c_str());
+  }
+
+  /**
+     @brief Read a binary tunecache file (or journal) and insert its
+     records into the tunecache.  Since every record is copied into
+     the tunecache anyway, the file is read into a buffer with a
+     single read() rather than mapped.
+     @param[in] path The file to load
+     @param[in] journal Whether this is a journal, in which case the
+     number of records is given by the file size and a trailing
+     partial record (e.g., from an interrupted append) is ignored
+     @return The number of records loaded
+   */
+  static size_t loadBinaryTuneCache(const std::string &path, bool journal)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) errorQuda("Unable to open %s", path.c_str());
+
+    struct stat fstat_;
+    if (fstat(fd, &fstat_)) errorQuda("Unable to stat %s", path.c_str());
+    size_t bytes = fstat_.st_size;
+    if (bytes < sizeof(TuneCacheHeader)) errorQuda("Bad format in %s", path.c_str());
+
+    std::vector<char> buffer(bytes);
+    for (size_t offset = 0; offset < bytes; ) {
+      ssize_t n = read(fd, buffer.data() + offset, bytes - offset);
+      if (n <= 0) errorQuda("Unable to read %s", path.c_str());
+      offset += n;
+    }
+    close(fd);
+
+    TuneCacheHeader header;
+    memcpy(&header, buffer.data(), sizeof(TuneCacheHeader));
+    checkHeader(header, path);
+
+    size_t n_records = (bytes - sizeof(TuneCacheHeader)) / sizeof(TuneRecord);
+    if (journal) {
+      if ((bytes - sizeof(TuneCacheHeader)) % sizeof(TuneRecord))
+	warningQuda("Ignoring truncated trailing record in %s", path.c_str());
+    } else {
+      if (n_records < header.n_records) errorQuda("Bad format in %s", path.c_str());
+      n_records = header.n_records;
+    }
+
+    TuneRecord record;
+    for (size_t i=0; i<n_records; i++) {
+      memcpy(&record, buffer.data() + sizeof(TuneCacheHeader) + i*sizeof(TuneRecord), sizeof(TuneRecord));
+      fromRecord(record);
+    }
+
+    return n_records;
+  }
+
+  /**
+     @brief Write the complete tunecache in binary form.  We write to a
+     temporary file and rename it into place, so readers never see a
+     partially written file.
+   */
+  static void writeBinaryTuneCache(const std::string &path)
+  {
+    std::string tmp_path = path + ".tmp";
+    FILE *file = fopen(tmp_path.c_str(), "wb");
+    if (!file) { warningQuda("Unable to open %s for writing", tmp_path.c_str()); return; }
+
+    TuneCacheHeader header;
+    initHeader(header, tunecache.size());
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    TuneRecord record;
+    for (map::iterator entry = tunecache.begin(); entry != tunecache.end() && ok; entry++) {
+      toRecord(record, entry->first, entry->second);
+      ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok || rename(tmp_path.c_str(), path.c_str())) {
+      warningQuda("Unable to write %s", path.c_str());
+      remove(tmp_path.c_str());
+      return;
+    }
+    tunecache_base_records = tunecache.size();
+  }
+
+  /**
+     @brief Append the entries tuned since the last save to the journal
+   */
+  static void appendTuneCacheJournal(const std::string &path)
+  {
+    FILE *file = fopen(path.c_str(), "ab");
+    if (!file) { warningQuda("Unable to open %s for writing", path.c_str()); return; }
+
+    bool ok = true;
+    if (ftell(file) == 0) { // new journal so write the header first
+      TuneCacheHeader header;
+      initHeader(header, 0);
+      ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    TuneRecord record;
+    for (auto key = tunecache_pending.begin(); key != tunecache_pending.end() && ok; key++) {
+      toRecord(record, *key, tunecache[*key]);
+      ok = fwrite(&record, sizeof(record), 1, file) == 1;
+    }
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok) warningQuda("Unable to append to %s", path.c_str());
+    else tunecache_journal_records += tunecache_pending.size();
+  }
+
+  /**
+     @brief Import a tunecache from the TSV format, returning the
+     number of entries read.
+   */
+  static size_t importTuneCacheTSV(const std::string &cache_path)
+  {
+    std::string line, token;
+    std::ifstream cache_file;
+    std::stringstream ls;
+
+    cache_file.open(cache_path.c_str());
+    if (!cache_file) return 0;
+
+    if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
+    getline(cache_file, line);
+    ls.str(line);
+    ls >> token;
+    if (token.compare("tunecache")) errorQuda("Bad format in %s", cache_path.c_str());
+    ls >> token;
+    if (token.compare(quda_version)) errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
+    ls >> token;
+    if (token.compare(buildVersion())) errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
+    ls >> token;
+    if (token.compare(quda_hash)) errorQuda("Cache file %s does not match current QUDA build. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
+
+    if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
+    getline(cache_file, line); // eat the blank line
+
+    if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
+    getline(cache_file, line); // eat the description line
+
+    size_t size = tunecache.size();
+    deserializeTuneCache(cache_file);
+    cache_file.close();
+
+    return tunecache.size() - size;
+  }
+
+  /**
+     @brief Export the tunecache in the TSV format
+   */
+  static void exportTuneCacheTSV(const std::string &cache_path)
+  {
+    time_t now;
+    std::ofstream cache_file;
+    cache_file.open(cache_path.c_str());
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("Exporting %d sets of cached parameters to %s\n", static_cast<int>(tunecache.size()), cache_path.c_str());
+    }
+
+    time(&now);
+    cache_file << "tunecache\t" << quda_version << "\t" << buildVersion();
+    cache_file << "\t" << quda_hash << "\t# Last updated " << ctime(&now) << std::endl;
+    cache_file << std::setw(16) << "volume" << "\tname\taux\tblock.x\tblock.y\tblock.z\tgrid.x\tgrid.y\tgrid.z\tshared_bytes\taux.x\taux.y\taux.z\taux.w\ttime\tcomment" << std::endl;
+    serializeTuneCache(cache_file);
+    cache_file.close();
+  }
+
+  /**
+     @brief Whether the tunecache should also be exported in the TSV
+     format when saved.  Default is disabled but can be enabled by
+     setting QUDA_TUNECACHE_TSV=1.
+   */
+  static bool exportTSV()
+  {
+    static bool init = false;
+    static bool export_tsv = false;
+    if (!init) {
+      char *export_tsv_env = getenv("QUDA_TUNECACHE_TSV");
+      if (export_tsv_env && strcmp(export_tsv_env, "1") == 0) export_tsv = true;
+      init = true;
+    }
+    return export_tsv;
+  }
+
   /**
    * Distribute the tunecache from node 0 to all other nodes.
    */
@@ -271,33 +681,31 @@ namespace quda {
   {
 #ifdef MULTI_GPU
 
-    std::stringstream serialized;
+    std::vector<TuneRecord> records;
     size_t size;
 
     if (comm_rank() == 0) {
-      serializeTuneCache(serialized);
-      size = serialized.str().length();
+      records.resize(tunecache.size());
+      size_t i = 0;
+      for (map::iterator entry = tunecache.begin(); entry != tunecache.end(); entry++)
+	toRecord(records[i++], entry->first, entry->second);
+      size = records.size();
     }
     comm_broadcast(&size, sizeof(size_t));
 
     if (size > 0) {
-      if (comm_rank() == 0) {
-	comm_broadcast(const_cast<char *>(serialized.str().c_str()), size);
-      } else {
-	char *serstr = new char[size+1];
-	comm_broadcast(serstr, size);
-	serstr[size] ='\0'; // null-terminate
-	serialized.str(serstr);
-	deserializeTuneCache(serialized);
-	delete[] serstr;
-      }
+      if (comm_rank() != 0) records.resize(size);
+      comm_broadcast(records.data(), size * sizeof(TuneRecord));
+      if (comm_rank() != 0) for (auto &record : records) fromRecord(record);
     }
 #endif
   }
 
 
   /*
-   * Read tunecache from disk.
+   * Read tunecache from disk.  We prefer the binary tunecache
+   * (tunecache.bin together with its journal), and fall back to
+   * importing tunecache.tsv if no binary tunecache is present.
    */
   void loadTuneCache()
   {
@@ -308,9 +716,6 @@ namespace quda {
 
     char *path;
     struct stat pstat;
-    std::string cache_path, line, token;
-    std::ifstream cache_file;
-    std::stringstream ls;
 
     path = getenv("QUDA_RESOURCE_PATH");
 
@@ -330,45 +735,30 @@ namespace quda {
     if (comm_rank() == 0) {
 #endif
 
-      cache_path = resource_path;
-      cache_path += "/tunecache.tsv";
-      cache_file.open(cache_path.c_str());
+      std::string bin_path = resource_path + "/tunecache.bin";
+      std::string journal_path = resource_path + "/tunecache.journal";
+      std::string tsv_path = resource_path + "/tunecache.tsv";
 
-      if (cache_file) {
+      if (stat(bin_path.c_str(), &pstat) == 0) {
 
-	if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
-	getline(cache_file, line);
-	ls.str(line);
-	ls >> token;
-	if (token.compare("tunecache")) errorQuda("Bad format in %s", cache_path.c_str());
-	ls >> token;
-	if (token.compare(quda_version)) errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
-	ls >> token;
-#ifdef GITVERSION
-	if (token.compare(gitversion)) errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
-#else
-	if (token.compare(quda_version)) errorQuda("Cache file %s does not match current QUDA version. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
-#endif
-	ls >> token;
-	if (token.compare(quda_hash)) errorQuda("Cache file %s does not match current QUDA build. \nPlease delete this file or set the QUDA_RESOURCE_PATH environment variable to point to a new path.", cache_path.c_str());
-
-
-	if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
-	getline(cache_file, line); // eat the blank line
+	tunecache_base_records = loadBinaryTuneCache(bin_path, false);
+	tunecache_journal_records = stat(journal_path.c_str(), &pstat) == 0 ? loadBinaryTuneCache(journal_path, true) : 0;
+	initial_cache_size = tunecache.size();
 
-	if (!cache_file.good()) errorQuda("Bad format in %s", cache_path.c_str());
-	getline(cache_file, line); // eat the description line
+	if (getVerbosity() >= QUDA_SUMMARIZE) {
+	  printfQuda("Loaded %d sets of cached parameters from %s (%d journal entries)\n", static_cast<int>(initial_cache_size),
+		     bin_path.c_str(), static_cast<int>(tunecache_journal_records));
+	}
 
-	deserializeTuneCache(cache_file);
+      } else if (stat(tsv_path.c_str(), &pstat) == 0) {
 
-	cache_file.close();
-	initial_cache_size = tunecache.size();
+	initial_cache_size = importTuneCacheTSV(tsv_path);
+	tunecache_compact = true; // write out the binary tunecache on the next save
 
 	if (getVerbosity() >= QUDA_SUMMARIZE) {
-	  printfQuda("Loaded %d sets of cached parameters from %s\n", static_cast<int>(initial_cache_size), cache_path.c_str());
+	  printfQuda("Imported %d sets of cached parameters from %s\n", static_cast<int>(initial_cache_size), tsv_path.c_str());
 	}
 
-
       } else {
 	warningQuda("Cache file not found.  All kernels will be re-tuned (if tuning is enabled).");
       }
@@ -383,14 +773,14 @@ namespace quda {
 
 
   /**
-   * Write tunecache to disk.
+   * Write tunecache to disk.  Newly tuned entries are appended to the
+   * journal, and the binary tunecache is only rewritten (compacted)
+   * once the journal grows larger than it.
    */
   void saveTuneCache()
   {
-    time_t now;
     int lock_handle;
-    std::string lock_path, cache_path;
-    std::ofstream cache_file;
+    std::string lock_path, bin_path, journal_path;
 
     if (resource_path.empty()) return;
 
@@ -402,7 +792,7 @@ namespace quda {
     if (comm_rank() == 0) {
 #endif
 
-      if (tunecache.size() == initial_cache_size) return;
+      if (tunecache.size() == initial_cache_size && !tunecache_compact) return;
 
       // Acquire lock.  Note that this is only robust if the filesystem supports flock() semantics, which is true for
       // NFS on recent versions of linux but not Lustre by default (unless the filesystem was mounted with "-o flock").
@@ -416,32 +806,36 @@ namespace quda {
       }
       char msg[] = "If no instances of applications using QUDA are running,\n"
 	"this lock file shouldn't be here and is safe to delete.";
-      int stat = write(lock_handle, msg, sizeof(msg)); // check status to avoid compiler warning
-      if (stat == -1) warningQuda("Unable to write to lock file for some bizarre reason");
+      int stat_ = write(lock_handle, msg, sizeof(msg)); // check status to avoid compiler warning
+      if (stat_ == -1) warningQuda("Unable to write to lock file for some bizarre reason");
 
-      cache_path = resource_path + "/tunecache.tsv";
-      cache_file.open(cache_path.c_str());
+      bin_path = resource_path + "/tunecache.bin";
+      journal_path = resource_path + "/tunecache.journal";
 
-      if (getVerbosity() >= QUDA_SUMMARIZE) {
-	printfQuda("Saving %d sets of cached parameters to %s\n", static_cast<int>(tunecache.size()), cache_path.c_str());
+      struct stat pstat;
+      if (tunecache_compact || stat(bin_path.c_str(), &pstat) ||
+	  tunecache_journal_records + tunecache_pending.size() > tunecache_base_records) {
+	if (getVerbosity() >= QUDA_SUMMARIZE) {
+	  printfQuda("Saving %d sets of cached parameters to %s\n", static_cast<int>(tunecache.size()), bin_path.c_str());
+	}
+	writeBinaryTuneCache(bin_path);
+	remove(journal_path.c_str());
+	tunecache_journal_records = 0;
+	tunecache_compact = false;
+      } else {
+	if (getVerbosity() >= QUDA_SUMMARIZE) {
+	  printfQuda("Appending %d sets of cached parameters to %s\n", static_cast<int>(tunecache_pending.size()), journal_path.c_str());
+	}
+	appendTuneCacheJournal(journal_path);
       }
 
-      time(&now);
-      cache_file << "tunecache\t" << quda_version;
-#ifdef GITVERSION
-       cache_file << "\t" << gitversion;
-#else
-       cache_file << "\t" << quda_version;
-#endif
-      cache_file << "\t" << quda_hash << "\t# Last updated " << ctime(&now) << std::endl;
-      cache_file << std::setw(16) << "volume" << "\tname\taux\tblock.x\tblock.y\tblock.z\tgrid.x\tgrid.y\tgrid.z\tshared_bytes\taux.x\taux.y\taux.z\taux.w\ttime\tcomment" << std::endl;
-      serializeTuneCache(cache_file);
-      cache_file.close();
+      if (exportTSV()) exportTuneCacheTSV(resource_path + "/tunecache.tsv");
 
       // Release lock.
       close(lock_handle);
       remove(lock_path.c_str());
 
+      tunecache_pending.clear();
       initial_cache_size = tunecache.size();
 
 #ifdef MULTI_GPU
@@ -624,17 +1018,16 @@ namespace quda {
     static const Tunable *active_tunable; // for error checking
 
     // first check if we have the tuned value and return if we have it
-    //if (enabled == QUDA_TUNE_YES && tunecache.count(key)) {
-
-    it = tunecache.find(key);
-    if (enabled == QUDA_TUNE_YES && it != tunecache.end()) {
+    // (the preamble timer measures the cost of this hashed lookup)
+    TuneParam *cached = enabled == QUDA_TUNE_YES ? findTuneCache(key) : nullptr;
+    if (cached) {
 
 #ifdef LAUNCH_TIMER
       launchTimer.TPSTOP(QUDA_PROFILE_PREAMBLE);
       launchTimer.TPSTART(QUDA_PROFILE_COMPUTE);
 #endif
 
-      TuneParam &param = it->second;
+      TuneParam &param = *cached;
 
 #ifdef LAUNCH_TIMER
       launchTimer.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -763,16 +1156,18 @@ namespace quda {
 	if (verbosity >= QUDA_DEBUG_VERBOSE) printfQuda("PostTune %s\n", key.name);
 	tunable.postTune();
 	param = best_param;
-	tunecache[key] = best_param;
+	insertTuneCache(key, best_param);
+	if (comm_rank() == 0) tunecache_pending.push_back(key); // only node 0 writes to disk
 
       }
       if (commGlobalReduction() || policyTuning()) broadcastTuneCache();
 
       // check this process is getting the key that is expected
-      if (tunecache.find(key) == tunecache.end()) {
+      TuneParam *entry = findTuneCache(key);
+      if (!entry) {
 	errorQuda("Failed to find key entry (%s:%s:%s)", key.name, key.volume, key.aux);
       }
-      param = tunecache[key]; // read this now for all processes
+      param = *entry; // read this now for all processes
 
       if (traceEnabled()) {
         TraceKey trace_entry(key, param.time);
@@ -797,6 +1192,8 @@ namespace quda {
   void printLaunchTimer() {
 #ifdef LAUNCH_TIMER
     launchTimer.Print();
+    printfQuda("tunecache index: %lu entries, %lu lookups, %lu misses, mean probe length = %.3f\n",
+	       tunecache_index.size(), tunecache_index.lookups(), tunecache_index.misses(), tunecache_index.probeLength());
 #endif
   }
 } // namespace quda
@@ -2,6 +2,7 @@
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <cuda.h>
 #include <gauge_field.h>
 #include <gauge_field_order.h>
@@ -289,54 +290,256 @@ namespace{
     return true;
   }   
 
-  void unitarizeLinksCPU(cpuGaugeField &outfield, const cpuGaugeField& infield)
+  /**
+     Number of links the host unitarization works on at once.  A
+     batch is held structure-of-arrays with the link index innermost,
+     so that the per-link arithmetic vectorizes across the batch.
+   */
+  static constexpr int link_batch = 16;
+
+  struct LinkBatch {
+    double re[9][link_batch];
+    double im[9][link_batch];
+  };
+
+  /**
+     @brief Load n <= link_batch consecutive links into a batch,
+     padding the unused lanes with the identity
+   */
+  template <typename Float>
+  static inline void loadLinkBatch(LinkBatch &b, const Float *links, int n)
+  {
+    for (int k=0; k<9; k++) {
+#pragma omp simd
+      for (int l=0; l<link_batch; l++) {
+	b.re[k][l] = l < n ? static_cast<double>(links[l*18 + 2*k + 0]) : (k % 4 == 0 ? 1.0 : 0.0);
+	b.im[k][l] = l < n ? static_cast<double>(links[l*18 + 2*k + 1]) : 0.0;
+      }
+    }
+  }
+
+  template <typename Float>
+  static inline void saveLinkBatch(Float *links, const LinkBatch &b, int n)
+  {
+    for (int l=0; l<n; l++) {
+      for (int k=0; k<9; k++) {
+	links[l*18 + 2*k + 0] = static_cast<Float>(b.re[k][l]);
+	links[l*18 + 2*k + 1] = static_cast<Float>(b.im[k][l]);
+      }
+    }
+  }
+
+  /**
+     @brief One Newton iteration u <- (u + u^{-dagger})/2 on every link
+     of the batch, with the inverse formed from the cofactors
+   */
+  static inline void newtonStepBatch(LinkBatch &u)
+  {
+#pragma omp simd
+    for (int l=0; l<link_batch; l++) {
+      double ar[9], ai[9], cr[9], ci[9];
+      for (int k=0; k<9; k++) { ar[k] = u.re[k][l]; ai[k] = u.im[k][l]; }
+
+      // cofactors c(i,j)
+      for (int i=0; i<3; i++) {
+	for (int j=0; j<3; j++) {
+	  const int i1 = (i+1)%3, i2 = (i+2)%3, j1 = (j+1)%3, j2 = (j+2)%3;
+	  const int a = 3*i1+j1, b = 3*i2+j2, c = 3*i1+j2, d = 3*i2+j1;
+	  cr[3*i+j] = (ar[a]*ar[b] - ai[a]*ai[b]) - (ar[c]*ar[d] - ai[c]*ai[d]);
+	  ci[3*i+j] = (ar[a]*ai[b] + ai[a]*ar[b]) - (ar[c]*ai[d] + ai[c]*ar[d]);
+	}
+      }
+
+      double det_r = 0.0, det_i = 0.0;
+      for (int j=0; j<3; j++) {
+	det_r += ar[j]*cr[j] - ai[j]*ci[j];
+	det_i += ar[j]*ci[j] + ai[j]*cr[j];
+      }
+      const double norm_inv = 1.0 / (det_r*det_r + det_i*det_i);
+      const double inv_r = det_r * norm_inv, inv_i = -det_i * norm_inv;
+
+      // u^{-dagger}(i,j) = conj(c(i,j) / det)
+      for (int k=0; k<9; k++) {
+	const double tr = cr[k]*inv_r - ci[k]*inv_i;
+	const double ti = cr[k]*inv_i + ci[k]*inv_r;
+	u.re[k][l] = 0.5 * (ar[k] + tr);
+	u.im[k][l] = 0.5 * (ai[k] - ti);
+      }
+    }
+  }
+
+  /**
+     @brief Per-lane check that the unitarized link u is consistent
+     with the input link w, i.e., that (w^dagger u)^2 = w^dagger w
+     (the batched equivalent of isUnitarizedLinkConsistent)
+   */
+  static inline void consistentBatch(bool *ok, const LinkBatch &w, const LinkBatch &u, double max_error)
+  {
+#pragma omp simd
+    for (int l=0; l<link_batch; l++) {
+      double tr[9], ti[9], sr[9], si[9];
+      for (int i=0; i<3; i++) {
+	for (int j=0; j<3; j++) {
+	  double t_r = 0.0, t_i = 0.0, s_r = 0.0, s_i = 0.0;
+	  for (int k=0; k<3; k++) {
+	    // conj(w(k,i)) * u(k,j) and conj(w(k,i)) * w(k,j)
+	    const double wr = w.re[3*k+i][l], wi = w.im[3*k+i][l];
+	    t_r += wr*u.re[3*k+j][l] + wi*u.im[3*k+j][l];
+	    t_i += wr*u.im[3*k+j][l] - wi*u.re[3*k+j][l];
+	    s_r += wr*w.re[3*k+j][l] + wi*w.im[3*k+j][l];
+	    s_i += wr*w.im[3*k+j][l] - wi*w.re[3*k+j][l];
+	  }
+	  tr[3*i+j] = t_r; ti[3*i+j] = t_i; sr[3*i+j] = s_r; si[3*i+j] = s_i;
+	}
+      }
+
+      bool pass = true;
+      for (int i=0; i<3; i++) {
+	for (int j=0; j<3; j++) {
+	  double d_r = -sr[3*i+j], d_i = -si[3*i+j];
+	  for (int k=0; k<3; k++) {
+	    d_r += tr[3*i+k]*tr[3*k+j] - ti[3*i+k]*ti[3*k+j];
+	    d_i += tr[3*i+k]*ti[3*k+j] + ti[3*i+k]*tr[3*k+j];
+	  }
+	  pass = pass && fabs(d_r) <= max_error && fabs(d_i) <= max_error;
+	}
+      }
+      ok[l] = pass;
+    }
+  }
+
+  /**
+     @brief Per-lane check that u^dagger u is the identity to within
+     max_error and that u is free of NaNs (the batched equivalent of
+     isUnitary on a single link)
+   */
+  static inline void unitaryBatch(bool *ok, const LinkBatch &u, double max_error)
+  {
+#pragma omp simd
+    for (int l=0; l<link_batch; l++) {
+      bool pass = true;
+      for (int i=0; i<3; i++) {
+	for (int j=0; j<3; j++) {
+	  double d_r = i == j ? -1.0 : 0.0, d_i = 0.0;
+	  for (int k=0; k<3; k++) {
+	    d_r += u.re[3*k+i][l]*u.re[3*k+j][l] + u.im[3*k+i][l]*u.im[3*k+j][l];
+	    d_i += u.re[3*k+i][l]*u.im[3*k+j][l] - u.im[3*k+i][l]*u.re[3*k+j][l];
+	  }
+	  // written so that a NaN fails the check
+	  pass = pass && fabs(d_r) <= max_error && fabs(d_i) <= max_error;
+	}
+      }
+      ok[l] = pass;
+    }
+  }
+
+  template <typename Float>
+  static int unitarizeLinksCPU(Float *out, const Float *in, int num_links)
+  {
+    const int num_batches = (num_links + link_batch - 1) / link_batch;
+    int num_failures = 0;
+
+#pragma omp parallel num_threads(getOmpThreads())
+    {
+      int local_failures = 0;
+      LinkBatch w, u;
+      bool ok[link_batch];
+
+#pragma omp for schedule(static) nowait
+      for (int b=0; b<num_batches; b++) {
+	const int n = std::min(link_batch, num_links - b*link_batch);
+	loadLinkBatch(w, in + b*link_batch*18, n);
+	u = w;
+	for (int i=0; i<max_iter_newton; i++) newtonStepBatch(u);
+
+	consistentBatch(ok, w, u, 0.0000001);
+	for (int l=0; l<n; l++) if (!ok[l]) local_failures++;
+	saveLinkBatch(out + b*link_batch*18, u, n);
+      }
+
+#pragma omp critical
+      num_failures += local_failures;
+    }
+
+    return num_failures;
+  }
+
+  int unitarizeLinksCPU(cpuGaugeField &outfield, const cpuGaugeField& infield)
   {
     if (infield.Precision() != outfield.Precision())
       errorQuda("Precisions must match (out=%d != in=%d)", outfield.Precision(), infield.Precision());
-    
+    if (infield.Order() != QUDA_MILC_GAUGE_ORDER || outfield.Order() != QUDA_MILC_GAUGE_ORDER)
+      errorQuda("Only MILC gauge order supported (out=%d, in=%d)", outfield.Order(), infield.Order());
+
+    const int num_links = 4*infield.Volume();
     int num_failures = 0;
-    Matrix<complex<double>,3> inlink, outlink;
-      
-    for (int i=0; i<infield.Volume(); ++i){
-      for (int dir=0; dir<4; ++dir){
-	if (infield.Precision() == QUDA_SINGLE_PRECISION){
-	  copyArrayToLink(&inlink, ((float*)(infield.Gauge_p()) + (i*4 + dir)*18)); // order of arguments?
-	  if( unitarizeLinkNewton<double>(inlink, &outlink, max_iter_newton) == false ) num_failures++;
-	  copyLinkToArray(((float*)(outfield.Gauge_p()) + (i*4 + dir)*18), outlink); 
-	} else if (infield.Precision() == QUDA_DOUBLE_PRECISION){
-	  copyArrayToLink(&inlink, ((double*)(infield.Gauge_p()) + (i*4 + dir)*18)); // order of arguments?
-	  if( unitarizeLinkNewton<double>(inlink, &outlink, max_iter_newton) == false ) num_failures++;
-	  copyLinkToArray(((double*)(outfield.Gauge_p()) + (i*4 + dir)*18), outlink); 
-	} // precision?
-      } // dir
-    }  // loop over volume
-    return;
+    if (infield.Precision() == QUDA_SINGLE_PRECISION) {
+      num_failures = unitarizeLinksCPU((float*)outfield.Gauge_p(), (const float*)infield.Gauge_p(), num_links);
+    } else if (infield.Precision() == QUDA_DOUBLE_PRECISION) {
+      num_failures = unitarizeLinksCPU((double*)outfield.Gauge_p(), (const double*)infield.Gauge_p(), num_links);
+    } else {
+      errorQuda("Unsupported precision %d", infield.Precision());
+    }
+
+    if (num_failures) warningQuda("Unitarized links not consistent with incoming links at %d of %d links", num_failures, num_links);
+    return num_failures;
   }
-    
+
+  template <typename Float>
+  static int firstNonUnitary(const Float *links, int num_links, double max_error)
+  {
+    const int num_batches = (num_links + link_batch - 1) / link_batch;
+    int first = num_links;
+
+#pragma omp parallel num_threads(getOmpThreads())
+    {
+      int local_first = num_links;
+      LinkBatch u;
+      bool ok[link_batch];
+
+#pragma omp for schedule(static) nowait
+      for (int b=0; b<num_batches; b++) {
+	const int n = std::min(link_batch, num_links - b*link_batch);
+	if (b*link_batch >= local_first) continue; // already found an earlier failure
+	loadLinkBatch(u, links + b*link_batch*18, n);
+	unitaryBatch(ok, u, max_error);
+	for (int l=0; l<n; l++) if (!ok[l]) { local_first = std::min(local_first, b*link_batch + l); break; }
+      }
+
+#pragma omp critical
+      first = std::min(first, local_first);
+    }
+
+    return first;
+  }
+
   // CPU function which checks that the gauge field is unitary
   bool isUnitary(const cpuGaugeField& field, double max_error)
   {
+    if (field.Order() != QUDA_MILC_GAUGE_ORDER) errorQuda("Only MILC gauge order supported (order=%d)", field.Order());
+
+    const int num_links = 4*field.Volume();
+    int first = num_links;
     Matrix<complex<double>,3> link, identity;
-      
-    for(int i=0; i<field.Volume(); ++i){
-      for(int dir=0; dir<4; ++dir){
-	if(field.Precision() == QUDA_SINGLE_PRECISION){
-	  copyArrayToLink(&link, ((float*)(field.Gauge_p()) + (i*4 + dir)*18)); // order of arguments?
-	}else if(field.Precision() == QUDA_DOUBLE_PRECISION){     
-	  copyArrayToLink(&link, ((double*)(field.Gauge_p()) + (i*4 + dir)*18)); // order of arguments?
-	}else{
-	  errorQuda("Unsupported precision\n");
-	}
-	if(isUnitary(link,max_error) == false){ 
-	  printf("Unitarity failure\n");
-	  printf("site index = %d,\t direction = %d\n", i, dir);
-	  printLink(link);
-	  identity = conj(link)*link;
-	  printLink(identity);
-	  return false;
-	}
-      } // dir
-    } // i	  
+
+    if (field.Precision() == QUDA_SINGLE_PRECISION) {
+      first = firstNonUnitary((const float*)field.Gauge_p(), num_links, max_error);
+      if (first < num_links) copyArrayToLink(&link, ((const float*)(field.Gauge_p()) + first*18));
+    } else if (field.Precision() == QUDA_DOUBLE_PRECISION) {
+      first = firstNonUnitary((const double*)field.Gauge_p(), num_links, max_error);
+      if (first < num_links) copyArrayToLink(&link, ((const double*)(field.Gauge_p()) + first*18));
+    } else {
+      errorQuda("Unsupported precision\n");
+    }
+
+    if (first < num_links) {
+      printf("Unitarity failure\n");
+      printf("site index = %d,\t direction = %d\n", first / 4, first % 4);
+      printLink(link);
+      identity = conj(link)*link;
+      printLink(identity);
+      return false;
+    }
     return true;
   } // is unitary
 
@@ -8,6 +8,10 @@
 #include <util_quda.h>
 #include <sstream>
 
+#ifdef QUDA_OPENMP
+#include <omp.h>
+#endif
+
 static const size_t MAX_PREFIX_SIZE = 100;
 
 static QudaVerbosity verbosity_ = QUDA_SUMMARIZE;
@@ -65,6 +69,35 @@ QudaTune getTuning() {
   return tune;
 }
 
+static int omp_threads_ = 0;
+
+// default is the OpenMP runtime default but can be overridden with the QUDA_OMP_NUM_THREADS environment variable
+int getOmpThreads() {
+#ifdef QUDA_OPENMP
+  static bool init = false;
+
+  if (!init) {
+    char *omp_threads_env = getenv("QUDA_OMP_NUM_THREADS");
+    if (omp_threads_ == 0 && omp_threads_env) {
+      omp_threads_ = atoi(omp_threads_env);
+      if (omp_threads_ <= 0) errorQuda("Invalid QUDA_OMP_NUM_THREADS=%s", omp_threads_env);
+    }
+    if (omp_threads_ == 0) omp_threads_ = omp_get_max_threads();
+    init = true;
+  }
+
+  return omp_threads_;
+#else
+  return 1;
+#endif
+}
+
+void setOmpThreads(int nthreads)
+{
+  if (nthreads <= 0) errorQuda("Invalid number of host threads %d", nthreads);
+  omp_threads_ = nthreads;
+}
+
 void setOutputPrefix(const char *prefix)
 {
   strncpy(prefix_, prefix, MAX_PREFIX_SIZE);
@@ -23,6 +23,7 @@ void cloverReference(sFloat *out, cFloat *clover, sFloat *in, int parity) {
   int N = nColor * nSpin / 2;
   int chiralBlock = N + 2*(N-1)*N/2;
 
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
   for (int i=0; i<Vh; i++) {
     std::complex<sFloat> *In = reinterpret_cast<std::complex<sFloat>*>(&in[i*nSpin*nColor*2]);
     std::complex<sFloat> *Out = reinterpret_cast<std::complex<sFloat>*>(&out[i*nSpin*nColor*2]);
@@ -175,6 +176,7 @@ void clover_mat(void *out, void **gauge, void *clover, void *in, double kappa,
 void applyTwist(void *out, void *in, void *tmpH, double a, QudaPrecision precision) {
   switch (precision) {
   case QUDA_DOUBLE_PRECISION:
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
     for(int i = 0; i < Vh; i++)
       for(int s = 0; s < 4; s++) {
         double a5 = ((s / 2) ? -1.0 : +1.0) * a;
@@ -185,6 +187,7 @@ void applyTwist(void *out, void *in, void *tmpH, double a, QudaPrecision precisi
       }
     break;
   case QUDA_SINGLE_PRECISION:
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
     for(int i = 0; i < Vh; i++)
       for(int s = 0; s < 4; s++) {
         float a5 = ((s / 2) ? -1.0 : +1.0) * a;
@@ -55,13 +55,15 @@ void covdevReference(sFloat *res, gFloat **link, sFloat *spinorField,
     linkOdd[dir] = link[dir] + Vh*gaugeSiteSize;
   }
 
+  const int *nbr = neighborTable(1);
+
   for (int sid = 0; sid < Vh; sid++) {
     int offset = mySpinorSiteSize*sid;
 
     sFloat gaugedSpinor[mySpinorSiteSize];
 
-    gFloat *lnk    = gaugeLink(sid, mu, oddBit, linkEven, linkOdd, 1);
-    sFloat *spinor = spinorNeighbor(sid, mu, oddBit, spinorField, 1);
+    gFloat *lnk    = gaugeLink(sid, mu, oddBit, linkEven, linkOdd, nbr);
+    sFloat *spinor = spinorNeighbor(sid, mu, oddBit, spinorField, nbr);
 
     if (daggerBit) {
       for (int s = 0; s < 4; s++)
@@ -52,6 +52,8 @@ extern int niter;
 extern int nvec[];
 
 extern QudaInverterType inv_type;
+extern bool df_lanczos;
+extern bool verify_results;
 extern QudaInverterType precon_type;
 
 extern QudaMatPCType matpc_type;
@@ -277,6 +279,16 @@ void setDeflationParam(QudaEigParam &df_param) {
   df_param.import_vectors = QUDA_BOOLEAN_NO;
   df_param.run_verify     = QUDA_BOOLEAN_NO;
 
+  // compute the initial deflation space with the restarted Lanczos
+  // solver, checking the eigenpairs it returns
+  if (df_lanczos) {
+    df_param.eig_type     = QUDA_IMP_RST_LANCZOS;
+    df_param.run_verify   = verify_results ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
+    df_param.NPoly        = 0;
+    df_param.Stp_residual = 1e-8;
+    df_param.max_restarts = 100;
+  }
+
   df_param.nk             = df_param.invert_param->nev;
   df_param.np             = df_param.invert_param->nev*df_param.invert_param->deflation_grid;
   df_param.extlib_type    = deflation_ext_lib;
@@ -71,6 +71,7 @@ extern bool compute_clover;
 extern double clover_coeff;
 
 extern bool verify_results;
+extern bool cpu_bench;
 extern int niter;
 extern char latfile[];
 
@@ -640,11 +641,8 @@ DslashTime dslashCUDA(int niter) {
   return dslash_time;
 }
 
-void dslashRef() {
-
-  // compare to dslash reference implementation
-  printfQuda("Calculating reference implementation...");
-  fflush(stdout);
+// apply the host reference operator selected by dslash_type and test_type
+void applyRef() {
 
   if (dslash_type == QUDA_WILSON_DSLASH) {
     switch (test_type) {
@@ -938,9 +936,30 @@ void dslashRef() {
     exit(-1);
   }
 
+}
+
+void dslashRef() {
+
+  // compare to dslash reference implementation
+  printfQuda("Calculating reference implementation...");
+  fflush(stdout);
+
+  applyRef();
+
   printfQuda("done.\n");
 }
 
+// time niter applications of the host reference operator
+double dslashRefTime(int niter) {
+  timeval tstart, tstop;
+
+  gettimeofday(&tstart, NULL);
+  for (int i = 0; i < niter; i++) applyRef();
+  gettimeofday(&tstop, NULL);
+
+  return ((tstop.tv_sec - tstart.tv_sec) + 1e-6*(tstop.tv_usec - tstart.tv_usec));
+}
+
 
 void display_test_info()
 {
@@ -1018,6 +1037,14 @@ int main(int argc, char **argv)
     if (!transfer) flops = dirac->Flops();
     printfQuda("GFLOPS = %f\n", 1.0e-9*flops/dslash_time.event_time);
 
+    if (cpu_bench) {
+      printfQuda("Executing %d host reference loops...\n", niter);
+      double ref_time = dslashRefTime(niter);
+      printfQuda("%fus per host reference call\n", 1e6*ref_time / niter);
+      // the host reference does the same work as the device operator
+      if (flops > 0) printfQuda("Host reference GFLOPS = %f\n", 1.0e-9*flops/ref_time);
+    }
+
     printfQuda("Effective halo bi-directional bandwidth (GB/s) GPU = %f ( CPU = %f, min = %f , max = %f ) for aggregate message size %lu bytes\n",
 	       1.0e-9*2*cudaSpinor->GhostBytes()*niter/dslash_time.event_time, 1.0e-9*2*cudaSpinor->GhostBytes()*niter/dslash_time.cpu_time,
 	       1.0e-9*2*cudaSpinor->GhostBytes()/dslash_time.cpu_max, 1.0e-9*2*cudaSpinor->GhostBytes()/dslash_time.cpu_min,
@@ -100,23 +100,22 @@ static inline void su3Tmul(sFloat *res, gFloat *mat, sFloat *vec) {
 //
 
 
+// The neighbor table nbr passed to gaugeLink() and spinorNeighbor()
+// is the one returned by neighborTable() for the required neighbor
+// distance.  It should be looked up once per operator application,
+// outside of any parallel region.
+
 template <typename Float>
-static inline Float *gaugeLink(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd, int nbr_distance) {
+static inline Float *gaugeLink(int i, int dir, int oddBit, Float **gaugeEven, Float **gaugeOdd, const int *nbr) {
   Float **gaugeField;
   int j;
-  int d = nbr_distance;
   if (dir % 2 == 0) {
     j = i;
     gaugeField = (oddBit ? gaugeOdd : gaugeEven);
   }
   else {
-    switch (dir) {
-    case 1: j = neighborIndex(i, oddBit, 0, 0, 0, -d); break;
-    case 3: j = neighborIndex(i, oddBit, 0, 0, -d, 0); break;
-    case 5: j = neighborIndex(i, oddBit, 0, -d, 0, 0); break;
-    case 7: j = neighborIndex(i, oddBit, -d, 0, 0, 0); break;
-    default: j = -1; break;
-    }
+    // the backwards link is stored on the neighbor in the -dir direction
+    j = nbr[(oddBit*8 + dir)*Vh + i];
     gaugeField = (oddBit ? gaugeEven : gaugeOdd);
   }
   
@@ -124,22 +123,9 @@ static inline Float *gaugeLink(int i, int dir, int oddBit, Float **gaugeEven, Fl
 }
 
 template <typename Float>
-static inline Float *spinorNeighbor(int i, int dir, int oddBit, Float *spinorField, int neighbor_distance) 
+static inline Float *spinorNeighbor(int i, int dir, int oddBit, Float *spinorField, const int *nbr)
 {
-  int j;
-  int nb = neighbor_distance;
-  switch (dir) {
-  case 0: j = neighborIndex(i, oddBit, 0, 0, 0, +nb); break;
-  case 1: j = neighborIndex(i, oddBit, 0, 0, 0, -nb); break;
-  case 2: j = neighborIndex(i, oddBit, 0, 0, +nb, 0); break;
-  case 3: j = neighborIndex(i, oddBit, 0, 0, -nb, 0); break;
-  case 4: j = neighborIndex(i, oddBit, 0, +nb, 0, 0); break;
-  case 5: j = neighborIndex(i, oddBit, 0, -nb, 0, 0); break;
-  case 6: j = neighborIndex(i, oddBit, +nb, 0, 0, 0); break;
-  case 7: j = neighborIndex(i, oddBit, -nb, 0, 0, 0); break;
-  default: j = -1; break;
-  }
-    
+  int j = nbr[(oddBit*8 + dir)*Vh + i];
   return &spinorField[j*(mySpinorSiteSize)];
 }
 
@@ -180,23 +166,10 @@ int neighborIndex_5d(int i, int oddBit, int dxs, int dx4, int dx3, int dx2, int
 }
 
 
-template <QudaDWFPCType type, typename Float>
-  Float *spinorNeighbor_5d(int i, int dir, int oddBit, Float *spinorField, int neighbor_distance=1, int siteSize=24) {
-  int nb = neighbor_distance;
-  int j;
-  switch (dir) {
-  case 0: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, 0, +nb); break;
-  case 1: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, 0, -nb); break;
-  case 2: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, +nb, 0); break;
-  case 3: j = neighborIndex_5d<type>(i, oddBit, 0, 0, 0, -nb, 0); break;
-  case 4: j = neighborIndex_5d<type>(i, oddBit, 0, 0, +nb, 0, 0); break;
-  case 5: j = neighborIndex_5d<type>(i, oddBit, 0, 0, -nb, 0, 0); break;
-  case 6: j = neighborIndex_5d<type>(i, oddBit, 0, +nb, 0, 0, 0); break;
-  case 7: j = neighborIndex_5d<type>(i, oddBit, 0, -nb, 0, 0, 0); break;
-  case 8: j = neighborIndex_5d<type>(i, oddBit, +nb, 0, 0, 0, 0); break;
-  case 9: j = neighborIndex_5d<type>(i, oddBit, -nb, 0, 0, 0, 0); break;
-  default: j = -1; break;
-  }
+// nbr is the table returned by neighborTable_5d()
+template <typename Float>
+  Float *spinorNeighbor_5d(int i, int dir, int oddBit, Float *spinorField, const int *nbr, int siteSize=24) {
+  int j = nbr[(oddBit*10 + dir)*V5h + i];
   return &spinorField[j*siteSize];
 }
 
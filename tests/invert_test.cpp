@@ -61,6 +61,10 @@ extern bool compute_clover;
 extern int niter; // max solver iterations
 extern int gcrNkrylov; // number of inner iterations for GCR, or l for BiCGstab-l
 extern int pipeline; // length of pipeline for fused operations in GCR or BiCGstab-l
+extern int nsteps; // number of steps s in the s-step solvers
+extern QudaCABasis ca_basis; // polynomial basis for the s-step solvers
+extern double ca_lambda_min; // spectral interval for the s-step basis
+extern double ca_lambda_max;
 extern int solution_accumulator_pipeline; // length of pipeline for fused solution update from the direction vectors
 extern char latfile[];
 
@@ -211,7 +215,8 @@ int main(int argc, char **argv)
       dslash_type == QUDA_MOBIUS_DWF_DSLASH ||
       dslash_type == QUDA_TWISTED_MASS_DSLASH || 
       dslash_type == QUDA_TWISTED_CLOVER_DSLASH || 
-      multishift || inv_type == QUDA_CG_INVERTER) {
+      multishift || inv_type == QUDA_CG_INVERTER || inv_type == QUDA_PIPELINED_CG_INVERTER ||
+      inv_type == QUDA_CA_CG_INVERTER) {
     inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
   } else {
     inv_param.solve_type = QUDA_DIRECT_PC_SOLVE;
@@ -220,7 +225,10 @@ int main(int argc, char **argv)
 
   inv_param.pipeline = pipeline;
 
-  inv_param.Nsteps = 2;
+  inv_param.Nsteps = nsteps;
+  inv_param.ca_basis = ca_basis;
+  inv_param.ca_lambda_min = ca_lambda_min;
+  inv_param.ca_lambda_max = ca_lambda_max;
   inv_param.gcrNkrylov = gcrNkrylov;
   inv_param.tol = tol;
   inv_param.tol_restart = 1e-3; //now theoretical background for this parameter... 
@@ -833,6 +833,8 @@ int get_rank_order(char* s)
     ret = 0;
   } else if (strcmp(s, "row") == 0) {
     ret = 1;
+  } else if (strcmp(s, "node") == 0) {
+    ret = 2;
   } else {
     fprintf(stderr, "Error: invalid rank order type\n");
     exit(1);
@@ -1154,6 +1156,12 @@ get_solver_type(char* s)
     ret = QUDA_CGNE_INVERTER;
   } else if (strcmp(s, "cgnr") == 0){
     ret = QUDA_CGNR_INVERTER;
+  } else if (strcmp(s, "pipecg") == 0){
+    ret = QUDA_PIPELINED_CG_INVERTER;
+  } else if (strcmp(s, "ca-cg") == 0){
+    ret = QUDA_CA_CG_INVERTER;
+  } else if (strcmp(s, "ca-bicgstab") == 0){
+    ret = QUDA_CA_BICGSTAB_INVERTER;
   } else {
     fprintf(stderr, "Error: invalid solver type\n");	
     exit(1);
@@ -1216,6 +1224,21 @@ get_solver_str(QudaInverterType type)
   case QUDA_BICGSTABL_INVERTER:
     ret = "bicgstab-l";
     break;
+  case QUDA_CGNE_INVERTER:
+    ret = "cgne";
+    break;
+  case QUDA_CGNR_INVERTER:
+    ret = "cgnr";
+    break;
+  case QUDA_PIPELINED_CG_INVERTER:
+    ret = "pipecg";
+    break;
+  case QUDA_CA_CG_INVERTER:
+    ret = "ca-cg";
+    break;
+  case QUDA_CA_BICGSTAB_INVERTER:
+    ret = "ca-bicgstab";
+    break;
   default:
     ret = "unknown";
     errorQuda("Error: invalid solver type %d\n", type);
@@ -1257,6 +1280,25 @@ get_solve_ext_lib_type(char* s)
   return ret;
 }
 
+QudaCABasis
+get_ca_basis_type(char* s)
+{
+  QudaCABasis ret = QUDA_INVALID_BASIS;
+
+  if (strcmp(s, "power") == 0) {
+    ret = QUDA_POWER_BASIS;
+  } else if (strcmp(s, "newton") == 0) {
+    ret = QUDA_NEWTON_BASIS;
+  } else if (strcmp(s, "chebyshev") == 0) {
+    ret = QUDA_CHEBYSHEV_BASIS;
+  } else {
+    fprintf(stderr, "Error: invalid CA basis type %s\n", s);
+    exit(1);
+  }
+
+  return ret;
+}
+
 QudaFieldLocation
 get_df_location_ritz(char* s)
 {
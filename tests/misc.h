@@ -48,6 +48,8 @@ extern "C" {
 
   QudaExtLibType get_solve_ext_lib_type(char* s);
 
+  QudaCABasis get_ca_basis_type(char* s);
+
   QudaFieldLocation get_df_location_ritz(char* s);
 
   QudaMemoryType get_df_mem_type_ritz(char* s);
@@ -12,6 +12,7 @@
 #include <dslash_util.h>
 #include <dirac_quda.h>
 #include <algorithm>
+#include <cmath>
 
 extern QudaDslashType dslash_type;
 extern QudaInverterType inv_type;
@@ -117,7 +118,7 @@ void initFields(QudaPrecision prec)
   gParam.link_type = QUDA_COARSE_LINKS;
   gParam.t_boundary = QUDA_PERIODIC_T;
   gParam.create = QUDA_ZERO_FIELD_CREATE;
-  gParam.precision = param.precision;
+  gParam.precision = QUDA_DOUBLE_PRECISION; // host fields are double, like xH and yH
   gParam.nDim = 4;
   gParam.siteSubset = QUDA_FULL_SITE_SUBSET;
   gParam.ghostExchange = QUDA_GHOST_EXCHANGE_PAD;
@@ -133,6 +134,7 @@ void initFields(QudaPrecision prec)
   Xinv_h = new cpuGaugeField(gParam);
 
   gParam.order = QUDA_FLOAT2_GAUGE_ORDER;
+  gParam.precision = param.precision;
   gParam.geometry = QUDA_COARSE_GEOMETRY;
   gParam.nFace = 1;
   int pad = std::max( { (gParam.x[0]*gParam.x[1]*gParam.x[2])/2,
@@ -176,6 +178,65 @@ void freeFields()
 
 DiracCoarse *dirac;
 
+/**
+   Check the multi-source application of the host coarse operator:
+   apply M to the Nsrc-source field xH and compare each source against
+   applying M to that source alone.  With a partitioned dimension this
+   exercises the ghost zone of every source, not just the first.
+ */
+double verifyMultiSrc()
+{
+  // fill the links with random numbers and exchange their ghost zones
+  GaugeField *links[] = {Y_h, X_h};
+  for (auto U : links) {
+    void **gauge = static_cast<void**>(static_cast<cpuGaugeField*>(U)->Gauge_p());
+    size_t length = (size_t)U->Volume() * U->Ncolor() * U->Ncolor() * 2;
+    for (int d=0; d<U->Geometry(); d++) {
+      double *g = static_cast<double*>(gauge[d]);
+      for (size_t i=0; i<length; i++) g[i] = 2.0*rand()/(double)RAND_MAX - 1.0;
+    }
+  }
+  Y_h->exchangeGhost(QUDA_LINK_BIDIRECTIONAL);
+
+  static_cast<cpuColorSpinorField*>(xH)->Source(QUDA_RANDOM_SOURCE);
+  dirac->M(*yH, *xH);
+
+  ColorSpinorParam param(*xH);
+  param.nDim = 4;
+  param.x[4] = 1;
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  cpuColorSpinorField x4(param);
+  cpuColorSpinorField y4(param);
+
+  const size_t site_length = (size_t)xH->Nspin() * xH->Ncolor() * 2;
+  const size_t src_length = x4.VolumeCB() * site_length;
+
+  double max_dev = 0.0, max_norm = 0.0;
+  for (int s=0; s<Nsrc; s++) {
+    for (int p=0; p<2; p++) {
+      const double *src = static_cast<const double*>(p ? xH->Odd().V() : xH->Even().V()) + s*src_length;
+      double *dst = static_cast<double*>(p ? x4.Odd().V() : x4.Even().V());
+      std::copy(src, src + src_length, dst);
+    }
+
+    dirac->M(y4, x4);
+
+    for (int p=0; p<2; p++) {
+      const double *ref = static_cast<const double*>(p ? y4.Odd().V() : y4.Even().V());
+      const double *out = static_cast<const double*>(p ? yH->Odd().V() : yH->Even().V()) + s*src_length;
+      for (size_t i=0; i<src_length; i++) {
+	max_dev = std::max(max_dev, std::abs(out[i] - ref[i]));
+	max_norm = std::max(max_norm, std::abs(ref[i]));
+      }
+    }
+  }
+
+  comm_allreduce_max(&max_dev);
+  comm_allreduce_max(&max_norm);
+
+  return max_norm > 0.0 ? max_dev / max_norm : max_dev;
+}
+
 double benchmark(int test, const int niter) {
 
   cudaEvent_t start, end;
@@ -243,6 +304,12 @@ int main(int argc, char** argv)
     DiracParam param;
     dirac = new DiracCoarse(param, Y_h, X_h, Xinv_h, Yhat_h, Y_d, X_d, Xinv_d, Yhat_d);
 
+    if (verify_results) {
+      double dev = verifyMultiSrc();
+      printfQuda("Ncolor = %2d, multi-source (Nsrc = %d) host Mat relative deviation = %e\n", Ncolor, Nsrc, dev);
+      if (dev > 1e-12) errorQuda("Multi-source coarse operator disagrees with single-source application");
+    }
+
     // do the initial tune
     benchmark(test_type, 1);
 
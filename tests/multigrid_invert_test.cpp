@@ -19,6 +19,8 @@
 #endif
 
 #include <qio_field.h>
+#include <gauge_field.h>
+#include <field_io.h>
 
 #define MAX(a,b) ((a)>(b)?(a):(b))
 
@@ -63,6 +65,9 @@ extern QudaVerbosity mg_verbosity[QUDA_MAX_MG_LEVEL];
 
 extern QudaInverterType setup_inv[QUDA_MAX_MG_LEVEL];
 extern double setup_tol;
+extern int setup_block_rounds[QUDA_MAX_MG_LEVEL];
+extern int setup_refresh_iter[QUDA_MAX_MG_LEVEL];
+extern bool mg_refresh;
 extern double omega;
 extern QudaInverterType smoother_type;
 
@@ -71,6 +76,10 @@ extern QudaSolveType solve_type;
 
 extern char vec_infile[];
 extern char vec_outfile[];
+extern char mg_checkpoint_infile[];
+extern char mg_checkpoint_outfile[];
+extern bool mg_native_io;
+extern char gauge_outfile[];
 
 //Twisted mass flavor type
 extern QudaTwistFlavorType twist_flavor;
@@ -218,6 +227,8 @@ void setMultigridParam(QudaMultigridParam &mg_param) {
     mg_param.verbosity[i] = mg_verbosity[i];
     mg_param.setup_inv_type[i] = setup_inv[i];
     mg_param.setup_tol[i] = setup_tol;
+    mg_param.setup_block_rounds[i] = setup_block_rounds[i];
+    mg_param.setup_refresh_iter[i] = setup_refresh_iter[i];
     mg_param.spin_block_size[i] = 1;
     mg_param.n_vec[i] = nvec[i] == 0 ? 24 : nvec[i]; // default to 24 vectors if not set
     mg_param.nu_pre[i] = nu_pre;
@@ -265,6 +276,9 @@ void setMultigridParam(QudaMultigridParam &mg_param) {
   // set file i/o parameters
   strcpy(mg_param.vec_infile, vec_infile);
   strcpy(mg_param.vec_outfile, vec_outfile);
+  strcpy(mg_param.checkpoint_infile, mg_checkpoint_infile);
+  strcpy(mg_param.checkpoint_outfile, mg_checkpoint_outfile);
+  mg_param.vec_native_io = mg_native_io ? QUDA_BOOLEAN_YES : QUDA_BOOLEAN_NO;
 
   // these need to tbe set for now but are actually ignored by the MG setup
   // needed to make it pass the initialization test
@@ -434,7 +448,11 @@ int main(int argc, char **argv)
   }
 
   if (strcmp(latfile,"")) {  // load in the command line supplied gauge field
-    read_gauge_field(latfile, gauge, gauge_param.cpu_prec, gauge_param.X, argc, argv);
+    quda::GaugeFieldParam gParam(gauge, gauge_param);
+    quda::cpuGaugeField cpuGauge(gParam);
+    if (quda::isFieldFile(latfile)) quda::loadGaugeField(latfile, cpuGauge);
+    else read_gauge_field(latfile, gauge, gauge_param.cpu_prec, gauge_param.X, argc, argv);
+    if (strcmp(gauge_outfile,"")) quda::saveGaugeField(gauge_outfile, cpuGauge);
     construct_gauge_field(gauge, 2, gauge_param.cpu_prec, &gauge_param);
   } else { // else generate a random SU(3) field
     //generate a random SU(3) field
@@ -502,6 +520,42 @@ int main(int argc, char **argv)
     invertQuda(spinorOut, spinorIn, &inv_param);
   }
 
+  if (mg_refresh) {
+    // perturb the gauge field by a small random SU(3) step, then
+    // refresh the hierarchy in place and compare against a full
+    // rebuild on the same perturbed field
+    int setup_iter = inv_param.iter;
+    double setup_secs = mg_param.secs;
+
+    perturb_gauge_field(gauge, 0.1, gauge_param.cpu_prec);
+    loadGaugeQuda((void*)gauge, &gauge_param);
+    if (compute_clover && (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH)) {
+      if (mg_param.smoother_solve_type[0] == QUDA_DIRECT_PC_SOLVE || solve_type == QUDA_DIRECT_PC_SOLVE) inv_param.solve_type = QUDA_DIRECT_PC_SOLVE;
+      freeCloverQuda();
+      loadCloverQuda(clover, clover_inv, &inv_param);
+      inv_param.solve_type = solve_type;
+    }
+
+    mg_param.setup_refresh = QUDA_BOOLEAN_YES;
+    updateMultigridQuda(mg_preconditioner, &mg_param);
+    int refresh_iter, rebuild_iter;
+    double refresh_secs = mg_param.secs, rebuild_secs;
+    invertQuda(spinorOut, spinorIn, &inv_param);
+    refresh_iter = inv_param.iter;
+
+    mg_param.setup_refresh = QUDA_BOOLEAN_NO;
+    destroyMultigridQuda(mg_preconditioner);
+    mg_preconditioner = newMultigridQuda(&mg_param);
+    inv_param.preconditioner = mg_preconditioner;
+    rebuild_secs = mg_param.secs;
+    invertQuda(spinorOut, spinorIn, &inv_param);
+    rebuild_iter = inv_param.iter;
+
+    printfQuda("MG refresh: initial setup %g secs, %d iter\n", setup_secs, setup_iter);
+    printfQuda("MG refresh: perturbed field, refresh %g secs, %d iter; rebuild %g secs, %d iter\n",
+	       refresh_secs, refresh_iter, rebuild_secs, rebuild_iter);
+  }
+
   // free the multigrid solver
   destroyMultigridQuda(mg_preconditioner);
 
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
+#include <vector>
 
 #include <quda_internal.h>
 #include <gauge_field.h>
@@ -39,6 +41,10 @@ extern int gridsize_from_cmdline[];
     
 QudaPrecision prec_cpu = QUDA_DOUBLE_PRECISION;
 
+// benchmark the host reordering between every pair of host field orders
+bool bench_reorder = false;
+int niter_reorder = 10;
+
 void init() {
 
   param.cpu_prec = prec_cpu;
@@ -193,6 +199,74 @@ void packTest() {
 
 }
 
+/**
+   Time niter_reorder host reorderings of src into dst and report the
+   achieved bandwidth (bytes read plus bytes written)
+ */
+template <typename Field>
+void reorderBench(Field &dst, const Field &src, const char *dst_name, const char *src_name) {
+  dst.copy(src); // warm up, and first touch of the destination
+
+  stopwatchStart();
+  for (int i=0; i<niter_reorder; i++) dst.copy(src);
+  double secs = stopwatchReadSeconds();
+
+  double gbytes = (double)niter_reorder * (src.Bytes() + dst.Bytes()) / 1e9;
+  printf("%-16s -> %-16s: %8.3f GB/s (%e seconds per reorder)\n", src_name, dst_name, gbytes / secs, secs / niter_reorder);
+}
+
+void reorderTest() {
+
+  printf("\nHost reorder benchmark with %d thread(s), %d iterations\n", getOmpThreads(), niter_reorder);
+
+  std::vector<std::pair<QudaGaugeFieldOrder,const char*> > gauge_orders;
+#ifdef BUILD_QDP_INTERFACE
+  gauge_orders.push_back(std::make_pair(QUDA_QDP_GAUGE_ORDER, "QDP"));
+#endif
+#ifdef BUILD_MILC_INTERFACE
+  gauge_orders.push_back(std::make_pair(QUDA_MILC_GAUGE_ORDER, "MILC"));
+#endif
+#ifdef BUILD_CPS_INTERFACE
+  gauge_orders.push_back(std::make_pair(QUDA_CPS_WILSON_GAUGE_ORDER, "CPS"));
+#endif
+#ifdef BUILD_TIFR_INTERFACE
+  gauge_orders.push_back(std::make_pair(QUDA_TIFR_GAUGE_ORDER, "TIFR"));
+#endif
+
+  std::vector<cpuGaugeField*> gauge;
+  for (auto &order : gauge_orders) {
+    GaugeFieldParam gParam(0, param);
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    gParam.order = order.first;
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    gauge.push_back(new cpuGaugeField(gParam));
+  }
+
+  for (unsigned int i=0; i<gauge.size(); i++)
+    for (unsigned int j=0; j<gauge.size(); j++)
+      if (i != j) reorderBench(*gauge[j], *gauge[i], gauge_orders[j].second, gauge_orders[i].second);
+
+  for (auto g : gauge) delete g;
+
+  std::vector<std::pair<QudaFieldOrder,const char*> > spinor_orders;
+  spinor_orders.push_back(std::make_pair(QUDA_SPACE_SPIN_COLOR_FIELD_ORDER, "SpaceSpinColor"));
+  spinor_orders.push_back(std::make_pair(QUDA_SPACE_COLOR_SPIN_FIELD_ORDER, "SpaceColorSpin"));
+
+  std::vector<cpuColorSpinorField*> spinors;
+  for (auto &order : spinor_orders) {
+    ColorSpinorParam sParam(*spinor);
+    sParam.create = QUDA_NULL_FIELD_CREATE;
+    sParam.fieldOrder = order.first;
+    spinors.push_back(new cpuColorSpinorField(sParam));
+  }
+
+  for (unsigned int i=0; i<spinors.size(); i++)
+    for (unsigned int j=0; j<spinors.size(); j++)
+      if (i != j) reorderBench(*spinors[j], *spinors[i], spinor_orders[j].second, spinor_orders[i].second);
+
+  for (auto s : spinors) delete s;
+}
+
 extern void usage(char**);
 
 int main(int argc, char **argv) {
@@ -200,6 +274,22 @@ int main(int argc, char **argv) {
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     }  
+
+    if (strcmp(argv[i], "--bench-reorder") == 0) {
+      bench_reorder = true;
+      continue;
+    }
+
+    if (strcmp(argv[i], "--niter-reorder") == 0) {
+      if (i+1 >= argc) usage(argv);
+      niter_reorder = atoi(argv[i+1]);
+      if (niter_reorder <= 0) {
+	fprintf(stderr, "ERROR: invalid number of iterations %d\n", niter_reorder);
+	usage(argv);
+      }
+      i++;
+      continue;
+    }
     
     fprintf(stderr, "ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
@@ -209,6 +299,7 @@ int main(int argc, char **argv) {
 
   init();
   packTest();
+  if (bench_reorder) reorderTest();
   end();
 
   finalizeComms();
@@ -60,18 +60,24 @@ void dslashReference(sFloat *res, gFloat **fatlink, gFloat** longlink, sFloat *s
     longlinkOdd[dir] = longlink[dir] + Vh*gaugeSiteSize;    
   }
 
+  // look up the neighbor tables outside of the parallel region
+  const int *nbr1 = neighborTable(1);
+  const int *nbr3 = neighborTable(3);
+
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
   for (int xs=0; xs<nSrc; xs++) {
 
     for (int i = 0; i < Vh; i++) {
       int sid = i + xs*Vh;
       int offset = mySpinorSiteSize*sid;
+      sFloat *spinorSrc = spinorField + xs*Vh*mySpinorSiteSize;
 
       for (int dir = 0; dir < 8; dir++) {
-	gFloat* fatlnk = gaugeLink(i, dir, oddBit, fatlinkEven, fatlinkOdd, 1);
-	gFloat* longlnk = gaugeLink(i, dir, oddBit, longlinkEven, longlinkOdd, 3);
+	gFloat* fatlnk = gaugeLink(i, dir, oddBit, fatlinkEven, fatlinkOdd, nbr1);
+	gFloat* longlnk = gaugeLink(i, dir, oddBit, longlinkEven, longlinkOdd, nbr3);
 
-	sFloat *first_neighbor_spinor = spinorNeighbor_5d<QUDA_4D_PC>(sid, dir, oddBit, spinorField, 1, mySpinorSiteSize);
-	sFloat *third_neighbor_spinor = spinorNeighbor_5d<QUDA_4D_PC>(sid, dir, oddBit, spinorField, 3, mySpinorSiteSize);
+	sFloat *first_neighbor_spinor = spinorNeighbor(i, dir, oddBit, spinorSrc, nbr1);
+	sFloat *third_neighbor_spinor = spinorNeighbor(i, dir, oddBit, spinorSrc, nbr3);
 
 	sFloat gaugedSpinor[mySpinorSiteSize];
 
@@ -293,6 +299,7 @@ void dslashReference_mg4dir(sFloat *res, gFloat **fatlink, gFloat** longlink,
     ghostLonglinkOdd[dir] = ghostLonglink[dir] + 3*(faceVolume[dir]/2)*gaugeSiteSize;
   }
 
+#pragma omp parallel for collapse(2) schedule(static) num_threads(getOmpThreads())
   for (int xs=0; xs<nSrc; xs++) {
 
     for (int i = 0; i < Vh; i++) {
@@ -63,6 +63,7 @@ extern QudaPrecision prec;
 
 extern int device;
 extern bool verify_results;
+extern bool cpu_bench;
 extern int niter;
 
 extern bool kernel_pack_t;
@@ -391,12 +392,9 @@ DslashTime dslashCUDA(int niter) {
   return dslash_time;
 }
 
-void staggeredDslashRef()
+// apply the host reference operator selected by test_type
+void applyStaggeredRef()
 {
-
-  // compare to dslash reference implementation
-  printfQuda("Calculating reference implementation...");
-  fflush(stdout);
   switch (test_type) {
     case 0:
 #ifdef MULTI_GPU
@@ -421,11 +419,32 @@ void staggeredDslashRef()
     default:
       errorQuda("Test type not defined");
   }
+}
+
+void staggeredDslashRef()
+{
+
+  // compare to dslash reference implementation
+  printfQuda("Calculating reference implementation...");
+  fflush(stdout);
+
+  applyStaggeredRef();
 
   printfQuda("done.\n");
 
 }
 
+// time niter applications of the host reference operator
+double staggeredDslashRefTime(int niter) {
+  timeval tstart, tstop;
+
+  gettimeofday(&tstart, NULL);
+  for (int i = 0; i < niter; i++) applyStaggeredRef();
+  gettimeofday(&tstop, NULL);
+
+  return ((tstop.tv_sec - tstart.tv_sec) + 1e-6*(tstop.tv_usec - tstart.tv_usec));
+}
+
 TEST(dslash, verify) {
   double deviation = pow(10, -(double)(cpuColorSpinorField::Compare(*spinorRef, *spinorOut)));
   double tol = (inv_param.cuda_prec == QUDA_DOUBLE_PRECISION ? 1e-12 :
@@ -462,6 +481,14 @@ static int dslashTest()
     unsigned long long flops = dirac->Flops();
     printfQuda("GFLOPS = %f\n", 1.0e-9*flops/dslash_time.event_time);
 
+    if (cpu_bench) {
+      printfQuda("Executing %d host reference loops...\n", niter);
+      double ref_time = staggeredDslashRefTime(niter);
+      printfQuda("%fus per host reference call\n", 1e6*ref_time / niter);
+      // the host reference does the same work as the device operator
+      if (flops > 0) printfQuda("Host reference GFLOPS = %f\n", 1.0e-9*flops/ref_time);
+    }
+
     printfQuda("Effective halo bi-directional bandwidth (GB/s) GPU = %f ( CPU = %f, min = %f , max = %f ) for aggregate message size %lu bytes\n",
 	       1.0e-9*2*cudaSpinor->GhostBytes()*niter/dslash_time.event_time, 1.0e-9*2*cudaSpinor->GhostBytes()*niter/dslash_time.cpu_time,
 	       1.0e-9*2*cudaSpinor->GhostBytes()/dslash_time.cpu_max, 1.0e-9*2*cudaSpinor->GhostBytes()/dslash_time.cpu_min,
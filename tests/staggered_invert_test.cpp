@@ -67,6 +67,10 @@ extern QudaDslashType dslash_type;
 extern QudaInverterType inv_type;
 extern double mass; // the mass of the Dirac operator
 extern int pipeline; // length of pipeline for fused operations in GCR or BiCGstab-l
+extern int nsteps; // number of steps s in the s-step solvers
+extern QudaCABasis ca_basis; // polynomial basis for the s-step solvers
+extern double ca_lambda_min; // spectral interval for the s-step basis
+extern double ca_lambda_max;
 extern int solution_accumulator_pipeline; // length of pipeline for fused solution update from the direction vectors
 
 extern QudaSolveType solve_type;
@@ -146,7 +150,10 @@ set_params(QudaGaugeParam* gaugeParam, QudaInvertParam* inv_param,
 
   inv_param->tol_hq = tol_hq; // specify a tolerance for the residual for heavy quark residual
  
-  inv_param->Nsteps = 2; 
+  inv_param->Nsteps = nsteps;
+  inv_param->ca_basis = ca_basis;
+  inv_param->ca_lambda_min = ca_lambda_min;
+  inv_param->ca_lambda_max = ca_lambda_max;
 
 
   //inv_param->inv_type = QUDA_GCR_INVERTER;
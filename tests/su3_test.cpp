@@ -10,6 +10,8 @@
 #include "misc.h"
 
 #include <qio_field.h>
+#include <quda_internal.h>
+#include <lattice_field.h> // for reorder_location_set
 
 #if defined(QMP_COMMS)
 #include <qmp.h>
@@ -41,6 +43,10 @@ QudaPrecision &cpu_prec = prec;
 QudaPrecision &cuda_prec = prec;
 QudaPrecision &cuda_prec_sloppy = prec_sloppy;
 
+// benchmark the gauge field upload and download for each host order and reorder location
+bool bench_reorder = false;
+int niter_reorder = 10;
+
 void setGaugeParam(QudaGaugeParam &gauge_param) {
 
   gauge_param.X[0] = xdim;
@@ -78,6 +84,53 @@ void setGaugeParam(QudaGaugeParam &gauge_param) {
 }
 
 
+/**
+   Time loadGaugeQuda and saveGaugeQuda for the QDP and MILC host
+   orders, with the reordering done on the host and on the device, and
+   report the achieved bandwidth (host bytes plus device bytes).
+ */
+void reorderBench(void **qdp_gauge, QudaGaugeParam gauge_param) {
+
+  size_t gSize = (gauge_param.cpu_prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+
+  // MILC order copy of the field
+  void *milc_gauge = malloc(4*V*gaugeSiteSize*gSize);
+  for (int i=0; i<V; i++)
+    for (int dir=0; dir<4; dir++)
+      memcpy((char*)milc_gauge + (i*4+dir)*gaugeSiteSize*gSize, (char*)qdp_gauge[dir] + i*gaugeSiteSize*gSize, gaugeSiteSize*gSize);
+
+  int recon = gauge_param.reconstruct == QUDA_RECONSTRUCT_NO ? 18 : gauge_param.reconstruct;
+  double gbytes = 4.0*V*(gaugeSiteSize*gSize + recon*gauge_param.cuda_prec) / 1e9;
+
+  struct { QudaGaugeFieldOrder order; const char *name; void *gauge; } orders[] =
+    { {QUDA_QDP_GAUGE_ORDER, "QDP", qdp_gauge}, {QUDA_MILC_GAUGE_ORDER, "MILC", milc_gauge} };
+  struct { QudaFieldLocation location; const char *name; } locations[] =
+    { {QUDA_CPU_FIELD_LOCATION, "CPU"}, {QUDA_CUDA_FIELD_LOCATION, "GPU"} };
+
+  printfQuda("\nGauge reorder benchmark with %d host thread(s), %d iterations\n", getOmpThreads(), niter_reorder);
+
+  for (auto &loc : locations) {
+    quda::reorder_location_set(loc.location);
+    for (auto &order : orders) {
+      gauge_param.gauge_order = order.order;
+
+      loadGaugeQuda(order.gauge, &gauge_param); // warm up
+      stopwatchStart();
+      for (int i=0; i<niter_reorder; i++) loadGaugeQuda(order.gauge, &gauge_param);
+      double load_secs = stopwatchReadSeconds() / niter_reorder;
+
+      stopwatchStart();
+      for (int i=0; i<niter_reorder; i++) saveGaugeQuda(order.gauge, &gauge_param);
+      double save_secs = stopwatchReadSeconds() / niter_reorder;
+
+      printfQuda("%s reorder: %-4s -> native: %8.3f GB/s, native -> %-4s: %8.3f GB/s\n",
+		 loc.name, order.name, gbytes / load_secs, order.name, gbytes / save_secs);
+    }
+  }
+
+  free(milc_gauge);
+}
+
 extern void usage(char**);
 
 void SU3test(int argc, char **argv) {
@@ -86,6 +139,23 @@ void SU3test(int argc, char **argv) {
     if(process_command_line_option(argc, argv, &i) == 0){
       continue;
     }
+
+    if (strcmp(argv[i], "--bench-reorder") == 0) {
+      bench_reorder = true;
+      continue;
+    }
+
+    if (strcmp(argv[i], "--niter-reorder") == 0) {
+      if (i+1 >= argc) usage(argv);
+      niter_reorder = atoi(argv[i+1]);
+      if (niter_reorder <= 0) {
+	printf("ERROR: invalid number of iterations %d\n", niter_reorder);
+	usage(argv);
+      }
+      i++;
+      continue;
+    }
+
     printf("ERROR: Invalid option:%s\n", argv[i]);
     usage(argv);
   }
@@ -195,6 +265,9 @@ void SU3test(int argc, char **argv) {
 #endif
   
   check_gauge(gauge, new_gauge, 1e-3, gauge_param.cpu_prec);
+
+  if (bench_reorder) reorderBench(gauge, gauge_param);
+
   freeGaugeQuda();
   endQuda();
 
@@ -10,10 +10,12 @@
 #include <mpi.h>
 #endif
 
+#include <util_quda.h>
 #include <wilson_dslash_reference.h>
 #include <test_util.h>
 
 #include <dslash_quda.h>
+#include <stencil_index.h>
 #include "misc.h"
 
 using namespace std;
@@ -69,6 +71,11 @@ static int lex_rank_from_coords_x(const int *coords, void *fdata)
 
 static int rank_order = 0;
 
+extern int xdim;
+extern int ydim;
+extern int zdim;
+extern int tdim;
+
 void initComms(int argc, char **argv, const int *commDims)
 {
 #if defined(QMP_COMMS)
@@ -87,6 +94,15 @@ void initComms(int argc, char **argv, const int *commDims)
 #endif
 
 #endif
+  if (rank_order == 2) {
+    const int X[4] = { xdim*commDims[0], ydim*commDims[1], zdim*commDims[2], tdim*commDims[3] };
+    initCommsGridNodeQuda(4, commDims, X);
+    initRand();
+
+    printfQuda("Rank order is node aware\n");
+    return;
+  }
+
   QudaCommsMap func = rank_order == 0 ? lex_rank_from_coords_t : lex_rank_from_coords_x;
 
   initCommsGridQuda(4, commDims, func, NULL);
@@ -500,6 +516,21 @@ int neighborIndex(int i, int oddBit, int dx4, int dx3, int dx2, int dx1) {
 }
 
 
+// Neighbor tables for the single-GPU reference operators, see
+// StencilIndex.  The tables are laid out as [oddBit][dir][i] with dir
+// following the spinorNeighbor() convention (0=+x, 1=-x, ..., 7=-t,
+// 8=+s, 9=-s) and are rebuilt whenever the local dimensions change.
+const int *neighborTable(int nbr_distance) {
+  const int commDim[4] = {0, 0, 0, 0};
+  return quda::getStencilIndex(Z, 4, QUDA_4D_PC, nbr_distance, nbr_distance, commDim).Index();
+}
+
+const int *neighborTable_5d(QudaDWFPCType type, int nbr_distance) {
+  const int commDim[4] = {0, 0, 0, 0};
+  const int X[5] = {Z[0], Z[1], Z[2], Z[3], Ls};
+  return quda::getStencilIndex(X, 5, type, nbr_distance, nbr_distance, commDim).Index();
+}
+
 int neighborIndex(int dim[4], int index, int oddBit, int dx[4]){
 
   const int fullIndex = fullLatticeIndex(dim, index, oddBit);
@@ -1058,6 +1089,57 @@ void construct_gauge_field(void **gauge, int type, QudaPrecision precision, Quda
 
 }
 
+// multiply each link on the left by a random SU(3) matrix close to
+// the identity: since the boundary and anisotropy scalings are just
+// real factors they are preserved
+template <typename Float>
+static void perturbGaugeField(Float **res, double epsilon) {
+  for (int dir = 0; dir < 4; dir++) {
+    for (int i = 0; i < V; i++) {
+      Float r[3*3*2];
+      for (int m = 1; m < 3; m++) { // last 2 rows
+	for (int n = 0; n < 3; n++) { // 3 columns
+	  r[m*(3*2) + n*(2) + 0] = (m == n ? 1.0 : 0.0) + epsilon * (rand() / (Float)RAND_MAX - 0.5);
+	  r[m*(3*2) + n*(2) + 1] = epsilon * (rand() / (Float)RAND_MAX - 0.5);
+	}
+      }
+      normalize((complex<Float>*)(r + 1*3*2), 3);
+      orthogonalize((complex<Float>*)(r + 1*3*2), (complex<Float>*)(r + 2*3*2), 3);
+      normalize((complex<Float>*)(r + 2*3*2), 3);
+
+      {
+	Float *w = r+0*3*2;
+	Float *u = r+1*3*2;
+	Float *v = r+2*3*2;
+
+	for (int n = 0; n < 6; n++) w[n] = 0.0;
+	accumulateConjugateProduct(w+0*(2), u+1*(2), v+2*(2), +1);
+	accumulateConjugateProduct(w+0*(2), u+2*(2), v+1*(2), -1);
+	accumulateConjugateProduct(w+1*(2), u+2*(2), v+0*(2), +1);
+	accumulateConjugateProduct(w+1*(2), u+0*(2), v+2*(2), -1);
+	accumulateConjugateProduct(w+2*(2), u+0*(2), v+1*(2), +1);
+	accumulateConjugateProduct(w+2*(2), u+1*(2), v+0*(2), -1);
+      }
+
+      complex<Float> *R = (complex<Float>*)r;
+      complex<Float> *U = (complex<Float>*)(res[dir] + i*gaugeSiteSize);
+      complex<Float> RU[3*3];
+      for (int m = 0; m < 3; m++) {
+	for (int n = 0; n < 3; n++) {
+	  RU[m*3+n] = 0.0;
+	  for (int k = 0; k < 3; k++) RU[m*3+n] += R[m*3+k] * U[k*3+n];
+	}
+      }
+      for (int mn = 0; mn < 3*3; mn++) U[mn] = RU[mn];
+    }
+  }
+}
+
+void perturb_gauge_field(void **gauge, double epsilon, QudaPrecision precision) {
+  if (precision == QUDA_DOUBLE_PRECISION) perturbGaugeField((double**)gauge, epsilon);
+  else perturbGaugeField((float**)gauge, epsilon);
+}
+
 void
 construct_fat_long_gauge_field(void **fatlink, void** longlink, int type, 
 			       QudaPrecision precision, QudaGaugeParam* param,
@@ -1618,20 +1700,29 @@ int Lsdim = 16;
 QudaDagType dagger = QUDA_DAG_NO;
 QudaDslashType dslash_type = QUDA_WILSON_DSLASH;
 char latfile[256] = "";
+char gauge_outfile[256] = "";
 int Nsrc = 1;
 int Msrc = 1;
 int niter = 100;
 int gcrNkrylov = 10;
 int pipeline = 0;
 int solution_accumulator_pipeline = 0;
+int nsteps = 2;
+QudaCABasis ca_basis = QUDA_CHEBYSHEV_BASIS;
+double ca_lambda_min = 0.0;
+double ca_lambda_max = -1.0;
 int test_type = 0;
 int nvec[QUDA_MAX_MG_LEVEL] = { };
 char vec_infile[256] = "";
 char vec_outfile[256] = "";
+char mg_checkpoint_infile[256] = "";
+char mg_checkpoint_outfile[256] = "";
+bool mg_native_io = false;
 QudaInverterType inv_type;
 QudaInverterType precon_type = QUDA_INVALID_INVERTER;
 int multishift = 0;
 bool verify_results = true;
+bool cpu_bench = false;
 double mass = 0.1;
 double mu = 0.1;
 double anisotropy = 1.0;
@@ -1653,6 +1744,9 @@ double mu_factor[QUDA_MAX_MG_LEVEL] = { };
 QudaVerbosity mg_verbosity[QUDA_MAX_MG_LEVEL] = { };
 QudaInverterType setup_inv[QUDA_MAX_MG_LEVEL] = { };
 double setup_tol = 5e-6;
+int setup_block_rounds[QUDA_MAX_MG_LEVEL] = { };
+int setup_refresh_iter[QUDA_MAX_MG_LEVEL] = { };
+bool mg_refresh = false;
 double omega = 0.85;
 QudaInverterType smoother_type = QUDA_MR_INVERTER;
 bool generate_nullspace = true;
@@ -1668,6 +1762,7 @@ int eigcg_max_restarts = 3;
 int max_restart_num = 3;
 double inc_tol = 1e-2;
 double eigenval_tol = 1e-1;
+bool df_lanczos = false;
 
 QudaExtLibType solver_ext_lib     = QUDA_EIGEN_EXTLIB;
 QudaExtLibType deflation_ext_lib  = QUDA_EIGEN_EXTLIB;
@@ -1711,18 +1806,23 @@ void usage(char** argv )
   printf("    --zgridsize <n>                           # Set grid size in Z dimension (default 1)\n");
   printf("    --tgridsize <n>                           # Set grid size in T dimension (default 1)\n");
   printf("    --partition <mask>                        # Set the communication topology (X=1, Y=2, Z=4, T=8, and combinations of these)\n");
-  printf("    --rank-order <col/row>                    # Set the [t][z][y][x] rank order as either column major (t fastest, default) or row major (x fastest)\n");
+  printf("    --rank-order <col/row/node>               # Set the [t][z][y][x] rank order as either column major (t fastest, default), row major (x fastest) or node aware (ranks on a node in compact blocks)\n");
   printf("    --kernel-pack-t                           # Set T dimension kernel packing to be true (default false)\n");
   printf("    --dslash-type <type>                      # Set the dslash type, the following values are valid\n"
 	 "                                                  wilson/clover/twisted-mass/twisted-clover/staggered\n"
          "                                                  /asqtad/domain-wall/domain-wall-4d/mobius/laplace\n");
   printf("    --flavor <type>                           # Set the twisted mass flavor type (singlet (default), deg-doublet, nondeg-doublet)\n");
-  printf("    --load-gauge file                         # Load gauge field \"file\" for the test (requires QIO)\n");
+  printf("    --load-gauge file                         # Load gauge field \"file\" for the test (requires QIO unless \"file\" is in QUDA's native format)\n");
+  printf("    --save-gauge file                         # Save the loaded gauge field to \"file\" in QUDA's native format\n");
   printf("    --niter <n>                               # The number of iterations to perform (default 10)\n");
   printf("    --ngcrkrylov <n>                          # The number of inner iterations to use for GCR, BiCGstab-l (default 10)\n");
   printf("    --pipeline <n>                            # The pipeline length for fused operations in GCR, BiCGstab-l (default 0, no pipelining)\n");
   printf("    --solution-pipeline <n>                   # The pipeline length for fused solution accumulation (default 0, no pipelining)\n");
-  printf("    --inv-type <cg/bicgstab/gcr>              # The type of solver to use (default cg)\n");
+  printf("    --inv-type <cg/pipecg/bicgstab/gcr>       # The type of solver to use (default cg)\n");
+  printf("    --nsteps <n>                              # The number of steps s in the s-step solvers (ca-cg, ca-bicgstab) (default 2)\n");
+  printf("    --ca-basis <power/newton/chebyshev>       # The polynomial basis used by the s-step solvers (default chebyshev)\n");
+  printf("    --ca-lambda-min <x>                       # The lower bound of the spectrum for the s-step basis (default 0)\n");
+  printf("    --ca-lambda-max <x>                       # The upper bound of the spectrum for the s-step basis (default -1, estimate)\n");
   printf("    --precon-type <mr/ (unspecified)>         # The type of solver to use (default none (=unspecified)).\n"
 	 "                                                  For multigrid this sets the smoother type.\n");
   printf("    --multishift <true/false>                 # Whether to do a multi-shift solver test or not (default false)\n");     
@@ -1738,6 +1838,7 @@ void usage(char** argv )
   printf("    --tolhq  <resid_hq_tol>                   # Set heavy-quark residual tolerance\n");
   printf("    --test                                    # Test method (different for each test)\n");
   printf("    --verify <true/false>                     # Verify the GPU results using CPU results (default true)\n");
+  printf("    --cpu-bench                               # Time the host reference operator and report its GFLOPS (dslash tests only)\n");
   printf("    --mg-nvec <level nvec>                    # Number of null-space vectors to define the multigrid transfer operator on a given level\n");
   printf("    --mg-gpu-prolongate <true/false>          # Whether to do the multigrid transfer operators on the GPU (default false)\n");
   printf("    --mg-levels <2+>                          # The number of multigrid levels to do (default 2)\n");
@@ -1745,14 +1846,20 @@ void usage(char** argv )
   printf("    --mg-nu-post <1-20>                       # The number of post-smoother applications to do at each multigrid level (default 2)\n");
   printf("    --mg-setup-inv <level inv>                # The inverter to use for the setup of multigrid (default bicgstab)\n");
   printf("    --mg-setup-tol                            # The tolerance to use for the setup of multigrid (default 5e-6)\n");
+  printf("    --mg-setup-block-rounds <level n>         # Relax all null-space vectors together for n rounds (default 0 = one at a time)\n");
+  printf("    --mg-setup-refresh-iter <level n>         # Setup solver iterations applied to each null-space vector on refresh (default 0)\n");
+  printf("    --mg-refresh <true/false>                 # Perturb the gauge field after the first solve, refresh the multigrid hierarchy and compare against a full rebuild (default false)\n");
   printf("    --mg-omega                                # The over/under relaxation factor for the smoother of multigrid (default 0.85)\n");
   printf("    --mg-smoother                             # The smoother to use for multigrid (default mr)\n");
   printf("    --mg-block-size <level x y z t>           # Set the geometric block size for the each multigrid level's transfer operator (default 4 4 4 4)\n");
   printf("    --mg-mu-factor <level factor>             # Set the multiplicative factor for the twisted mass mu parameter on each level (default 1)\n");
   printf("    --mg-generate-nullspace <true/false>      # Generate the null-space vector dynamically (default true)\n");
   printf("    --mg-generate-all-levels <true/talse>     # true=generate nul space on all levels, false=generate on level 0 and create other levels from that (default true)\n");
-  printf("    --mg-load-vec file                        # Load the vectors \"file\" for the multigrid_test (requires QIO)\n");
-  printf("    --mg-save-vec file                        # Save the generated null-space vectors \"file\" from the multigrid_test (requires QIO)\n");
+  printf("    --mg-load-vec file                        # Load the vectors \"file\" for the multigrid_test (requires QIO unless \"file\" is in QUDA's native format)\n");
+  printf("    --mg-save-vec file                        # Save the generated null-space vectors \"file\" from the multigrid_test\n");
+  printf("    --mg-native-io <true/false>               # Save the null-space vectors in QUDA's native format rather than with QIO (default false, always true without QIO)\n");
+  printf("    --mg-load-checkpoint file                 # Restore the whole multigrid hierarchy from the checkpoint \"file\" instead of running the setup\n");
+  printf("    --mg-save-checkpoint file                 # Checkpoint the whole multigrid hierarchy to \"file\" once it is set up\n");
   printf("    --mg-vebosity <level verb>                # The verbosity to use on each level of the multigrid (default silent)\n");
   printf("    --df-nev <nev>                            # Set number of eigenvectors computed within a single solve cycle (default 8)\n");
   printf("    --df-max-search-dim <dim>                 # Set the size of eigenvector search space (default 64)\n");
@@ -1762,6 +1869,7 @@ void usage(char** argv )
   printf("    --df-tol-inc <tol>                        # Set tolerance for the subsequent restarts in the initCG solver  (default 1e-2)\n");
   printf("    --df-max-restart-num <n>                  # Set maximum number of the initCG restarts in the deflation stage (default 3)\n");
   printf("    --df-tol-eigenval <tol>                   # Set maximum eigenvalue residual norm (default 1e-1)\n");
+  printf("    --df-lanczos <true/false>                 # Compute the initial deflation space with the restarted Lanczos eigensolver (default false)\n");
 
 
   printf("    --solver-ext-lib-type <eigen/magma>       # Set external library for the solvers  (default Eigen library)\n");
@@ -1820,6 +1928,12 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
   
+  if( strcmp(argv[i], "--cpu-bench") == 0){
+    cpu_bench = true;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--device") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -2355,6 +2469,16 @@ int process_command_line_option(int argc, char** argv, int* idx)
     ret = 0;
     goto out;
   }
+
+  if( strcmp(argv[i], "--save-gauge") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    strcpy(gauge_outfile, argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
   
   if( strcmp(argv[i], "--nsrc") == 0){
     if (i+1 >= argc){
@@ -2485,6 +2609,67 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if( strcmp(argv[i], "--mg-setup-block-rounds") == 0){
+    if (i+2 >= argc){
+      usage(argv);
+    }
+    int level = atoi(argv[i+1]);
+    if (level < 0 || level >= QUDA_MAX_MG_LEVEL) {
+      printf("ERROR: invalid multigrid level %d", level);
+      usage(argv);
+    }
+    i++;
+
+    setup_block_rounds[level] = atoi(argv[i+1]);
+    if (setup_block_rounds[level] < 0) {
+      printf("ERROR: invalid number of setup rounds %d\n", setup_block_rounds[level]);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-setup-refresh-iter") == 0){
+    if (i+2 >= argc){
+      usage(argv);
+    }
+    int level = atoi(argv[i+1]);
+    if (level < 0 || level >= QUDA_MAX_MG_LEVEL) {
+      printf("ERROR: invalid multigrid level %d", level);
+      usage(argv);
+    }
+    i++;
+
+    setup_refresh_iter[level] = atoi(argv[i+1]);
+    if (setup_refresh_iter[level] < 0) {
+      printf("ERROR: invalid number of refresh iterations %d\n", setup_refresh_iter[level]);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-refresh") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+
+    if (strcmp(argv[i+1], "true") == 0){
+      mg_refresh = true;
+    }else if (strcmp(argv[i+1], "false") == 0){
+      mg_refresh = false;
+    }else{
+      fprintf(stderr, "ERROR: invalid value for mg_refresh type\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--mg-omega") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -2656,6 +2841,45 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if( strcmp(argv[i], "--mg-native-io") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+
+    if (strcmp(argv[i+1], "true") == 0){
+      mg_native_io = true;
+    }else if (strcmp(argv[i+1], "false") == 0){
+      mg_native_io = false;
+    }else{
+      fprintf(stderr, "ERROR: invalid value for mg_native_io type\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-load-checkpoint") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    strcpy(mg_checkpoint_infile, argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--mg-save-checkpoint") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    strcpy(mg_checkpoint_outfile, argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--df-nev") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -2736,6 +2960,25 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   } 
 
+  if( strcmp(argv[i], "--df-lanczos") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+
+    if (strcmp(argv[i+1], "true") == 0){
+      df_lanczos = true;
+    }else if (strcmp(argv[i+1], "false") == 0){
+      df_lanczos = false;
+    }else{
+      fprintf(stderr, "ERROR: invalid df-lanczos type\n");
+      exit(1);
+    }
+
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--df-tol-inc") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -2829,6 +3072,50 @@ int process_command_line_option(int argc, char** argv, int* idx)
     goto out;
   }
 
+  if( strcmp(argv[i], "--nsteps") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    nsteps = atoi(argv[i+1]);
+    if (nsteps < 1 || nsteps > 16){
+      printf("ERROR: invalid number of s-steps (%d)\n", nsteps);
+      usage(argv);
+    }
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--ca-basis") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    ca_basis = get_ca_basis_type(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--ca-lambda-min") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    ca_lambda_min = atof(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
+  if( strcmp(argv[i], "--ca-lambda-max") == 0){
+    if (i+1 >= argc){
+      usage(argv);
+    }
+    ca_lambda_max = atof(argv[i+1]);
+    i++;
+    ret = 0;
+    goto out;
+  }
+
   if( strcmp(argv[i], "--solution-pipeline") == 0){
     if (i+1 >= argc){
       usage(argv);
@@ -44,6 +44,10 @@
   int neighborIndex(int dim[], int index, int oddBit, int dx[]);
   int neighborIndexFullLattice(int dim[], int index, int dx[]);  
 
+  // cached [oddBit][dir][i] neighbor tables, built on first use for the current dims
+  const int *neighborTable(int nbr_distance);
+  const int *neighborTable_5d(QudaDWFPCType type, int nbr_distance);
+
   int neighborIndex_mg(int i, int oddBit, int dx4, int dx3, int dx2, int dx1);
   int neighborIndexFullLattice_mg(int i, int dx4, int dx3, int dx2, int dx1);
 
@@ -58,6 +62,7 @@
   void construct_fat_long_gauge_field(void **fatlink, void** longlink, int type, 
 				    QudaPrecision precision, QudaGaugeParam*, 
 				    QudaDslashType dslash_type);
+  void perturb_gauge_field(void **gauge, double epsilon, QudaPrecision precision);
   void construct_clover_field(void *clover, double norm, double diag, QudaPrecision precision);
   void construct_spinor_field(void *spinor, int type, int i0, int s0, int c0, QudaPrecision precision);
   void createSiteLinkCPU(void** link,  QudaPrecision precision, int phase) ;
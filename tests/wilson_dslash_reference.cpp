@@ -111,11 +111,14 @@ void dslashReference(sFloat *res, gFloat **gaugeFull, sFloat *spinorField, int o
     gaugeEven[dir] = gaugeFull[dir];
     gaugeOdd[dir]  = gaugeFull[dir]+Vh*gaugeSiteSize;
   }
-  
+
+  const int *nbr = neighborTable(1); // look up the neighbor table outside of the parallel region
+
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
   for (int i = 0; i < Vh; i++) {
     for (int dir = 0; dir < 8; dir++) {
-      gFloat *gauge = gaugeLink(i, dir, oddBit, gaugeEven, gaugeOdd, 1);
-      sFloat *spinor = spinorNeighbor(i, dir, oddBit, spinorField, 1);
+      gFloat *gauge = gaugeLink(i, dir, oddBit, gaugeEven, gaugeOdd, nbr);
+      sFloat *spinor = spinorNeighbor(i, dir, oddBit, spinorField, nbr);
       
       sFloat projectedSpinor[4*3*2], gaugedSpinor[4*3*2];
       int projIdx = 2*(dir/2)+(dir+daggerBit)%2;
@@ -148,6 +151,7 @@ void dslashReference(sFloat *res, gFloat **gaugeFull,  gFloat **ghostGauge, sFlo
     ghostGaugeOdd[dir] = ghostGauge[dir] + (faceVolume[dir]/2)*gaugeSiteSize;
   }
   
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
   for (int i = 0; i < Vh; i++) {
 
     for (int dir = 0; dir < 8; dir++) {
@@ -249,6 +253,7 @@ void twistGamma5(sFloat *out, sFloat *in, const int dagger, const sFloat kappa,
 
   if (dagger) a *= -1.0;
 
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
   for(int i = 0; i < V; i++) {
     sFloat tmp[24];
     for(int s = 0; s < 4; s++)
@@ -430,6 +435,7 @@ void ndegTwistGamma5(sFloat *out1, sFloat *out2, sFloat *in1, sFloat *in2, const
 
   if (dagger) a *= -1.0;
   
+#pragma omp parallel for schedule(static) num_threads(getOmpThreads())
   for(int i = 0; i < V; i++) {
     sFloat tmp1[24];
     sFloat tmp2[24];    